@@ -0,0 +1,120 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpabstractdevice.h"
+
+#include "upnpdevicedescription.h"
+#include "upnpservicedescription.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QIODevice>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+#include <QtTest/QtTest>
+
+#include <memory>
+
+class TestDevice : public UpnpAbstractDevice
+{
+public:
+    TestDevice()
+    {
+        auto newDescription = UpnpDeviceDescription{};
+        newDescription.setUDN(QStringLiteral("cached-device"));
+        newDescription.setFriendlyName(QStringLiteral("Kitchen"));
+        setDescription(newDescription);
+    }
+
+    using UpnpAbstractDevice::addService;
+};
+
+class AbstractDeviceTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void secondFetchIsCacheHit()
+    {
+        TestDevice device;
+
+        const auto firstDescription = device.xmlDescription();
+        QCOMPARE(device.xmlDescriptionBuilds(), quint64(1));
+        QCOMPARE(device.xmlDescriptionCacheHits(), quint64(0));
+        QVERIFY(firstDescription.contains("<friendlyName>Kitchen</friendlyName>"));
+
+        const auto secondDescription = device.xmlDescription();
+        QCOMPARE(device.xmlDescriptionBuilds(), quint64(1));
+        QCOMPARE(device.xmlDescriptionCacheHits(), quint64(1));
+
+        // the cached bytes are shared, not copied
+        QCOMPARE(secondDescription, firstDescription);
+        QVERIFY(secondDescription.constData() == firstDescription.constData());
+    }
+
+    void setDescriptionInvalidates()
+    {
+        TestDevice device;
+        QVERIFY(device.xmlDescription().contains("Kitchen"));
+
+        auto newDescription = device.description();
+        newDescription.setFriendlyName(QStringLiteral("Living Room"));
+        device.setDescription(newDescription);
+
+        const auto &updatedDescription = device.xmlDescription();
+        QCOMPARE(device.xmlDescriptionBuilds(), quint64(2));
+        QVERIFY(updatedDescription.contains("<friendlyName>Living Room</friendlyName>"));
+        QVERIFY(!updatedDescription.contains("Kitchen"));
+
+        // a change made through description() is only seen after invalidateXmlDescription
+        device.description().setFriendlyName(QStringLiteral("Bedroom"));
+        QVERIFY(device.xmlDescription().contains("Living Room"));
+
+        device.invalidateXmlDescription();
+        QVERIFY(device.xmlDescription().contains("Bedroom"));
+        QCOMPARE(device.xmlDescriptionBuilds(), quint64(3));
+    }
+
+    void addServiceInvalidates()
+    {
+        TestDevice device;
+        QVERIFY(!device.xmlDescription().contains("serviceList"));
+
+        auto newService = UpnpServiceDescription{};
+        newService.setServiceType(QStringLiteral("urn:schemas-upnp-org:service:SwitchPower:1"));
+        newService.setServiceId(QStringLiteral("urn:upnp-org:serviceId:SwitchPower"));
+        device.addService(newService);
+
+        const auto &updatedDescription = device.xmlDescription();
+        QCOMPARE(device.xmlDescriptionBuilds(), quint64(2));
+        QVERIFY(updatedDescription.contains("<serviceType>urn:schemas-upnp-org:service:SwitchPower:1</serviceType>"));
+    }
+
+    void independentBuffers()
+    {
+        TestDevice device;
+        const auto &expectedDescription = device.xmlDescription();
+
+        auto firstBuffer = device.buildAndGetXmlDescription();
+        auto secondBuffer = device.buildAndGetXmlDescription();
+        QCOMPARE(device.xmlDescriptionBuilds(), quint64(1));
+        QVERIFY(firstBuffer->isOpen());
+        QVERIFY(!firstBuffer->isWritable());
+
+        const auto &firstPart = firstBuffer->read(10);
+        QCOMPARE(firstPart, expectedDescription.left(10));
+        QCOMPARE(firstBuffer->pos(), qint64(10));
+        QCOMPARE(secondBuffer->pos(), qint64(0));
+
+        QCOMPARE(secondBuffer->readAll(), expectedDescription);
+        QCOMPARE(firstBuffer->readAll(), expectedDescription.mid(10));
+    }
+};
+
+QTEST_GUILESS_MAIN(AbstractDeviceTest)
+
+#include "abstractdevicetest.moc"
@@ -0,0 +1,177 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpactionbatch.h"
+#include "upnpactionresult.h"
+#include "upnpcontrolabstractservice.h"
+
+#include "upnpservicedescription.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QList>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QUrl>
+
+#include <QtTest/QtTest>
+
+#include <memory>
+#include <vector>
+
+class ActionBatchTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void batchErrors()
+    {
+        auto services = unreachableServices(3);
+
+        UpnpActionBatch batch;
+        batch.addCalls(rawServices(services), QStringLiteral("GetVolume"), {{QStringLiteral("InstanceID"), 0}});
+        QCOMPARE(batch.callsCount(), 3);
+
+        QSignalSpy finishedSpy(&batch, &UpnpActionBatch::finished);
+
+        auto results = batch.start();
+
+        QVERIFY(finishedSpy.wait());
+        QVERIFY(batch.isFinished());
+        QVERIFY(results.isFinished());
+
+        QCOMPARE(batch.finishedCalls(), 3);
+        QCOMPARE(batch.failedCalls(), 3);
+        QCOMPARE(batch.runningCalls(), 0);
+
+        const auto &allResults = results.result();
+        QCOMPARE(allResults.size(), qsizetype(3));
+        for (qsizetype i = 0; i < allResults.size(); ++i) {
+            QCOMPARE(allResults[i].mService.data(), services[i].get());
+            QCOMPARE(allResults[i].mActionName, QStringLiteral("GetVolume"));
+            QVERIFY(!allResults[i].mResult.mSuccess);
+            QVERIFY(!allResults[i].mResult.mError.isEmpty());
+            QVERIFY(allResults[i].mLatency >= 0);
+        }
+    }
+
+    void batchDeletedService()
+    {
+        auto services = unreachableServices(2);
+
+        UpnpActionBatch batch;
+        batch.addCalls(rawServices(services), QStringLiteral("GetMute"), {});
+
+        services[1].reset();
+
+        QSignalSpy finishedSpy(&batch, &UpnpActionBatch::finished);
+
+        batch.start();
+
+        QVERIFY(finishedSpy.count() == 1 || finishedSpy.wait());
+
+        QCOMPARE(batch.failedCalls(), 2);
+        QCOMPARE(batch.results()[1].mResult.mError, QStringLiteral("service deleted"));
+        QCOMPARE(batch.results()[1].mLatency, qint64(-1));
+    }
+
+    void batchCancel()
+    {
+        auto services = unreachableServices(3);
+
+        UpnpActionBatch batch;
+        batch.setMaximumConcurrentCalls(1);
+        batch.addCalls(rawServices(services), QStringLiteral("Stop"), {{QStringLiteral("InstanceID"), 0}});
+
+        QSignalSpy callFinishedSpy(&batch, &UpnpActionBatch::callFinished);
+        QSignalSpy finishedSpy(&batch, &UpnpActionBatch::finished);
+
+        batch.start();
+        QCOMPARE(batch.runningCalls(), 1);
+
+        batch.cancel();
+
+        // the calls not yet sent are finished at once, in the order they were added
+        QCOMPARE(callFinishedSpy.count(), 2);
+        QCOMPARE(callFinishedSpy[0][0].toInt(), 1);
+        QCOMPARE(callFinishedSpy[1][0].toInt(), 2);
+        QCOMPARE(batch.results()[1].mResult.mError, QStringLiteral("batch canceled"));
+        QCOMPARE(batch.results()[2].mResult.mError, QStringLiteral("batch canceled"));
+        QVERIFY(!batch.isFinished());
+
+        // the running call is not interrupted
+        QVERIFY(finishedSpy.wait());
+        QCOMPARE(callFinishedSpy.count(), 3);
+        QCOMPARE(callFinishedSpy[2][0].toInt(), 0);
+        QVERIFY(batch.results()[0].mResult.mError != QStringLiteral("batch canceled"));
+        QCOMPARE(batch.finishedCalls(), 3);
+    }
+
+    void batchAddAfterStart()
+    {
+        auto services = unreachableServices(2);
+
+        UpnpActionBatch batch;
+        batch.addCall(services[0].get(), QStringLiteral("Play"), {});
+
+        QSignalSpy finishedSpy(&batch, &UpnpActionBatch::finished);
+
+        batch.start();
+
+        batch.addCall(services[1].get(), QStringLiteral("Play"), {});
+        batch.addCalls(rawServices(services), QStringLiteral("Play"), {});
+        QCOMPARE(batch.callsCount(), 1);
+        QCOMPARE(batch.results().size(), qsizetype(1));
+
+        QVERIFY(finishedSpy.wait());
+        QCOMPARE(batch.finishedCalls(), 1);
+    }
+
+    void emptyBatch()
+    {
+        UpnpActionBatch batch;
+
+        QSignalSpy finishedSpy(&batch, &UpnpActionBatch::finished);
+
+        auto results = batch.start();
+
+        QCOMPARE(finishedSpy.count(), 1);
+        QVERIFY(results.isFinished());
+        QVERIFY(results.result().isEmpty());
+    }
+
+private:
+    /**
+     * @brief unreachableServices creates services whose description cannot be downloaded, their calls fail without network
+     */
+    static std::vector<std::unique_ptr<UpnpControlAbstractService>> unreachableServices(int count)
+    {
+        std::vector<std::unique_ptr<UpnpControlAbstractService>> result;
+
+        for (int i = 0; i < count; ++i) {
+            auto newService = std::make_unique<UpnpControlAbstractService>();
+            newService->description().setSCPDURL(QUrl::fromLocalFile(QDir::temp().filePath(QStringLiteral("missing-upnp-scpd-%1.xml").arg(i))));
+            result.push_back(std::move(newService));
+        }
+
+        return result;
+    }
+
+    static QList<UpnpControlAbstractService *> rawServices(const std::vector<std::unique_ptr<UpnpControlAbstractService>> &services)
+    {
+        QList<UpnpControlAbstractService *> result;
+
+        for (const auto &oneService : services) {
+            result.push_back(oneService.get());
+        }
+
+        return result;
+    }
+};
+
+QTEST_GUILESS_MAIN(ActionBatchTest)
+
+#include "actionbatchtest.moc"
@@ -0,0 +1,148 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpactiondescription.h"
+#include "upnpactiondispatcher.h"
+
+#include <QtCore/QList>
+#include <QtCore/QMap>
+#include <QtCore/QObject>
+#include <QtCore/QPair>
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+
+#include <QtTest/QtTest>
+
+class CalculatorService : public QObject
+{
+    Q_OBJECT
+
+public:
+    Q_INVOKABLE void Add(int first, int second, int &sum)
+    {
+        sum = first + second;
+    }
+
+    Q_INVOKABLE bool setLabel(const QString &label, bool enabled, QString &previousLabel)
+    {
+        if (label.isEmpty()) {
+            return false;
+        }
+
+        previousLabel = mLabel;
+        mLabel = enabled ? label : QString();
+
+        return true;
+    }
+
+    Q_INVOKABLE int addValues(int first, int second)
+    {
+        return first + second;
+    }
+
+    Q_INVOKABLE void Mismatch(int first)
+    {
+        Q_UNUSED(first)
+    }
+
+    QString mLabel;
+};
+
+static UpnpActionArgumentDescription newArgument(const QString &name, UpnpArgumentDirection direction)
+{
+    auto result = UpnpActionArgumentDescription{};
+    result.mIsValid = true;
+    result.mName = name;
+    result.mDirection = direction;
+
+    return result;
+}
+
+static UpnpActionDescription newAction(const QString &name, const QVector<UpnpActionArgumentDescription> &arguments)
+{
+    auto result = UpnpActionDescription{};
+    result.mIsValid = true;
+    result.mName = name;
+    result.mArguments = arguments;
+
+    return result;
+}
+
+class ActionDispatcherBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void initTestCase()
+    {
+        mActions[QStringLiteral("Add")] = newAction(QStringLiteral("Add"),
+                                                    {newArgument(QStringLiteral("First"), UpnpArgumentDirection::In),
+                                                     newArgument(QStringLiteral("Second"), UpnpArgumentDirection::In),
+                                                     newArgument(QStringLiteral("Sum"), UpnpArgumentDirection::Out)});
+        mActions[QStringLiteral("SetLabel")] = newAction(QStringLiteral("SetLabel"),
+                                                         {newArgument(QStringLiteral("Label"), UpnpArgumentDirection::In),
+                                                          newArgument(QStringLiteral("PreviousLabel"), UpnpArgumentDirection::Out),
+                                                          newArgument(QStringLiteral("Enabled"), UpnpArgumentDirection::In)});
+        mActions[QStringLiteral("Mismatch")] = newAction(QStringLiteral("Mismatch"),
+                                                         {newArgument(QStringLiteral("First"), UpnpArgumentDirection::Out)});
+        mActions[QStringLiteral("Unknown")] = newAction(QStringLiteral("Unknown"), {});
+    }
+
+    void benchmarkDispatchTable()
+    {
+        CalculatorService service;
+        UpnpActionDispatcher dispatcher;
+        QCOMPARE(dispatcher.registerActions(service.metaObject(), mActions), 2);
+
+        const auto actionName = QStringLiteral("Add");
+        const QList<QPair<QString, QString>> inputArguments = {{QStringLiteral("First"), QStringLiteral("40")}, {QStringLiteral("Second"), QStringLiteral("2")}};
+        QList<QPair<QString, QString>> outputArguments;
+
+        QBENCHMARK {
+            outputArguments.clear();
+            if (!dispatcher.dispatch(&service, actionName, inputArguments, outputArguments)) {
+                QFAIL("dispatch failed");
+            }
+        }
+
+        QCOMPARE(outputArguments.first().second, QStringLiteral("42"));
+    }
+
+    void benchmarkInvokeMethodByName()
+    {
+        // a dynamic call looking the method up by name and converting the arguments through QVariant
+        CalculatorService service;
+
+        const QList<QPair<QString, QString>> inputArguments = {{QStringLiteral("First"), QStringLiteral("40")}, {QStringLiteral("Second"), QStringLiteral("2")}};
+        QList<QPair<QString, QString>> outputArguments;
+
+        QBENCHMARK {
+            outputArguments.clear();
+
+            QVector<QVariant> arguments;
+            for (const auto &oneArgument : inputArguments) {
+                arguments.push_back(QVariant(oneArgument.second));
+            }
+
+            int sum = 0;
+            if (!QMetaObject::invokeMethod(&service, "addValues", Q_RETURN_ARG(int, sum), Q_ARG(int, arguments[0].toInt()), Q_ARG(int, arguments[1].toInt()))) {
+                QFAIL("invokeMethod failed");
+            }
+
+            outputArguments.push_back({QStringLiteral("Sum"), QVariant(sum).toString()});
+        }
+
+        QCOMPARE(outputArguments.first().second, QStringLiteral("42"));
+    }
+
+private:
+    QMap<QString, UpnpActionDescription> mActions;
+};
+
+QTEST_GUILESS_MAIN(ActionDispatcherBenchmark)
+
+#include "actiondispatcherbenchmark.moc"
@@ -0,0 +1,252 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpabstractservice.h"
+#include "upnpactiondescription.h"
+#include "upnpactiondispatcher.h"
+#include "upnpservicedescription.h"
+#include "upnpstatevariabledescription.h"
+
+#include <QtCore/QList>
+#include <QtCore/QMap>
+#include <QtCore/QObject>
+#include <QtCore/QPair>
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+
+#include <QtTest/QtTest>
+
+class CalculatorService : public QObject
+{
+    Q_OBJECT
+
+public:
+    Q_INVOKABLE void Add(int first, int second, int &sum)
+    {
+        sum = first + second;
+    }
+
+    Q_INVOKABLE bool setLabel(const QString &label, bool enabled, QString &previousLabel)
+    {
+        if (label.isEmpty()) {
+            return false;
+        }
+
+        previousLabel = mLabel;
+        mLabel = enabled ? label : QString();
+
+        return true;
+    }
+
+    Q_INVOKABLE void Mismatch(int first)
+    {
+        Q_UNUSED(first)
+    }
+
+    Q_INVOKABLE void Echo(double value, double &echoedValue)
+    {
+        echoedValue = value;
+    }
+
+    QString mLabel;
+};
+
+static UpnpActionArgumentDescription newArgument(const QString &name, UpnpArgumentDirection direction)
+{
+    auto result = UpnpActionArgumentDescription{};
+    result.mIsValid = true;
+    result.mName = name;
+    result.mDirection = direction;
+
+    return result;
+}
+
+static UpnpActionDescription newAction(const QString &name, const QVector<UpnpActionArgumentDescription> &arguments)
+{
+    auto result = UpnpActionDescription{};
+    result.mIsValid = true;
+    result.mName = name;
+    result.mArguments = arguments;
+
+    return result;
+}
+
+class ActionDispatcherTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void initTestCase()
+    {
+        mActions[QStringLiteral("Add")] = newAction(QStringLiteral("Add"),
+                                                    {newArgument(QStringLiteral("First"), UpnpArgumentDirection::In),
+                                                     newArgument(QStringLiteral("Second"), UpnpArgumentDirection::In),
+                                                     newArgument(QStringLiteral("Sum"), UpnpArgumentDirection::Out)});
+        mActions[QStringLiteral("SetLabel")] = newAction(QStringLiteral("SetLabel"),
+                                                         {newArgument(QStringLiteral("Label"), UpnpArgumentDirection::In),
+                                                          newArgument(QStringLiteral("PreviousLabel"), UpnpArgumentDirection::Out),
+                                                          newArgument(QStringLiteral("Enabled"), UpnpArgumentDirection::In)});
+        mActions[QStringLiteral("Mismatch")] = newAction(QStringLiteral("Mismatch"),
+                                                         {newArgument(QStringLiteral("First"), UpnpArgumentDirection::Out)});
+        mActions[QStringLiteral("Unknown")] = newAction(QStringLiteral("Unknown"), {});
+    }
+
+    void registerActions()
+    {
+        UpnpActionDispatcher dispatcher;
+
+        QCOMPARE(dispatcher.registerActions(&CalculatorService::staticMetaObject, mActions), 2);
+        QVERIFY(dispatcher.hasAction(QStringLiteral("Add")));
+        QVERIFY(dispatcher.hasAction(QStringLiteral("SetLabel")));
+        QVERIFY(!dispatcher.hasAction(QStringLiteral("Mismatch")));
+        QVERIFY(!dispatcher.hasAction(QStringLiteral("Unknown")));
+    }
+
+    void dispatchActions()
+    {
+        CalculatorService service;
+        UpnpActionDispatcher dispatcher;
+        QCOMPARE(dispatcher.registerActions(service.metaObject(), mActions), 2);
+
+        QList<QPair<QString, QString>> outputArguments;
+        QVERIFY(dispatcher.dispatch(&service, QStringLiteral("Add"), {{QStringLiteral("First"), QStringLiteral("40")}, {QStringLiteral("Second"), QStringLiteral("2")}}, outputArguments));
+        QCOMPARE(outputArguments, (QList<QPair<QString, QString>>{{QStringLiteral("Sum"), QStringLiteral("42")}}));
+
+        service.mLabel = QStringLiteral("kitchen");
+        outputArguments.clear();
+        QVERIFY(dispatcher.dispatch(&service, QStringLiteral("SetLabel"), {{QStringLiteral("Label"), QStringLiteral("living room")}, {QStringLiteral("Enabled"), QStringLiteral("1")}}, outputArguments));
+        QCOMPARE(outputArguments, (QList<QPair<QString, QString>>{{QStringLiteral("PreviousLabel"), QStringLiteral("kitchen")}}));
+        QCOMPARE(service.mLabel, QStringLiteral("living room"));
+    }
+
+    void dispatchInvalidCalls()
+    {
+        CalculatorService service;
+        UpnpActionDispatcher dispatcher;
+        QCOMPARE(dispatcher.registerActions(service.metaObject(), mActions), 2);
+
+        QList<QPair<QString, QString>> outputArguments;
+        QVERIFY(!dispatcher.dispatch(&service, QStringLiteral("Add"), {{QStringLiteral("First"), QStringLiteral("forty")}, {QStringLiteral("Second"), QStringLiteral("2")}}, outputArguments));
+        QVERIFY(!dispatcher.dispatch(&service, QStringLiteral("Add"), {{QStringLiteral("First"), QStringLiteral("40")}}, outputArguments));
+        QVERIFY(!dispatcher.dispatch(&service, QStringLiteral("SetLabel"), {{QStringLiteral("Label"), QString()}, {QStringLiteral("Enabled"), QStringLiteral("1")}}, outputArguments));
+        QVERIFY(!dispatcher.dispatch(&service, QStringLiteral("SetLabel"), {{QStringLiteral("Label"), QStringLiteral("hall")}, {QStringLiteral("Enabled"), QStringLiteral("maybe")}}, outputArguments));
+        QVERIFY(!dispatcher.dispatch(&service, QStringLiteral("Unknown"), {}, outputArguments));
+        QVERIFY(outputArguments.isEmpty());
+    }
+
+    void dispatchMismatchedNames()
+    {
+        CalculatorService service;
+        UpnpActionDispatcher dispatcher;
+        QCOMPARE(dispatcher.registerActions(service.metaObject(), mActions), 2);
+
+        QList<QPair<QString, QString>> outputArguments;
+        QVERIFY(!dispatcher.dispatch(&service, QStringLiteral("Add"), {{QStringLiteral("Second"), QStringLiteral("40")}, {QStringLiteral("First"), QStringLiteral("2")}}, outputArguments));
+        QVERIFY(!dispatcher.dispatch(&service, QStringLiteral("Add"), {{QStringLiteral("First"), QStringLiteral("40")}, {QStringLiteral("Other"), QStringLiteral("2")}}, outputArguments));
+        QVERIFY(!dispatcher.dispatch(&service, QStringLiteral("SetLabel"), {{QStringLiteral("label"), QStringLiteral("hall")}, {QStringLiteral("Enabled"), QStringLiteral("1")}}, outputArguments));
+        QVERIFY(outputArguments.isEmpty());
+        QVERIFY(service.mLabel.isEmpty());
+    }
+
+    void dispatchReals()
+    {
+        QMap<QString, UpnpActionDescription> actions;
+        actions[QStringLiteral("Echo")] = newAction(QStringLiteral("Echo"),
+                                                    {newArgument(QStringLiteral("Value"), UpnpArgumentDirection::In),
+                                                     newArgument(QStringLiteral("EchoedValue"), UpnpArgumentDirection::Out)});
+
+        CalculatorService service;
+        UpnpActionDispatcher dispatcher;
+        QCOMPARE(dispatcher.registerActions(service.metaObject(), actions), 1);
+
+        // the shortest representation that reads back the same value, without rounding
+        for (const auto &oneValue : {QStringLiteral("1.23456789"), QStringLiteral("0.1"), QStringLiteral("42")}) {
+            QList<QPair<QString, QString>> outputArguments;
+            QVERIFY(dispatcher.dispatch(&service, QStringLiteral("Echo"), {{QStringLiteral("Value"), oneValue}}, outputArguments));
+            QCOMPARE(outputArguments, (QList<QPair<QString, QString>>{{QStringLiteral("EchoedValue"), oneValue}}));
+        }
+    }
+
+    void unimplementedActionFails()
+    {
+        auto newDescription = UpnpServiceDescription{};
+        newDescription.addAction(mActions[QStringLiteral("Unknown")]);
+
+        UpnpAbstractService service;
+        service.setDescription(newDescription);
+
+        // no method and no invokeAction override: the action must not be answered as a success
+        QList<QPair<QString, QString>> outputArguments;
+        QVERIFY(!service.dispatchAction(QStringLiteral("Unknown"), {}, outputArguments));
+        QVERIFY(outputArguments.isEmpty());
+    }
+
+    void dispatchBooleans_data()
+    {
+        QTest::addColumn<QString>("value");
+        QTest::addColumn<bool>("isValid");
+        QTest::addColumn<bool>("enabled");
+
+        QTest::newRow("1") << QStringLiteral("1") << true << true;
+        QTest::newRow("true") << QStringLiteral("true") << true << true;
+        QTest::newRow("YES") << QStringLiteral("YES") << true << true;
+        QTest::newRow("0") << QStringLiteral("0") << true << false;
+        QTest::newRow("False") << QStringLiteral("False") << true << false;
+        QTest::newRow("no") << QStringLiteral("no") << true << false;
+        QTest::newRow("empty") << QString() << false << false;
+        QTest::newRow("2") << QStringLiteral("2") << false << false;
+        QTest::newRow("maybe") << QStringLiteral("maybe") << false << false;
+    }
+
+    void dispatchBooleans()
+    {
+        QFETCH(QString, value);
+        QFETCH(bool, isValid);
+        QFETCH(bool, enabled);
+
+        CalculatorService service;
+        UpnpActionDispatcher dispatcher;
+        QCOMPARE(dispatcher.registerActions(service.metaObject(), mActions), 2);
+
+        QList<QPair<QString, QString>> outputArguments;
+        QCOMPARE(dispatcher.dispatch(&service, QStringLiteral("SetLabel"), {{QStringLiteral("Label"), QStringLiteral("hall")}, {QStringLiteral("Enabled"), value}}, outputArguments),
+                 isValid);
+        if (isValid) {
+            QCOMPARE(service.mLabel, enabled ? QStringLiteral("hall") : QString());
+        }
+    }
+
+    void stateVariableBooleans_data()
+    {
+        dispatchBooleans_data();
+    }
+
+    void stateVariableBooleans()
+    {
+        QFETCH(QString, value);
+        QFETCH(bool, isValid);
+        QFETCH(bool, enabled);
+
+        auto stateVariable = UpnpStateVariableDescription{};
+        stateVariable.mDataType = QStringLiteral("boolean");
+        stateVariable.mType = UpnpStateVariableDescription::typeFromDataType(stateVariable.mDataType);
+
+        const auto &result = stateVariable.typedValue(value);
+        if (isValid) {
+            QCOMPARE(result, QVariant(enabled));
+        } else {
+            QCOMPARE(result, QVariant(value));
+        }
+    }
+
+private:
+    QMap<QString, UpnpActionDescription> mActions;
+};
+
+QTEST_GUILESS_MAIN(ActionDispatcherTest)
+
+#include "actiondispatchertest.moc"
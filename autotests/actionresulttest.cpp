@@ -0,0 +1,188 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpactionawaiter.h"
+#include "upnpactionresult.h"
+
+#include <QtCore/QFuture>
+#include <QtCore/QObject>
+#include <QtCore/QPromise>
+#include <QtCore/QString>
+
+#include <QtTest/QtTest>
+
+#include <exception>
+#include <memory>
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+/**
+ * @brief The DetachedCoroutine class is the smallest coroutine type needed to co_await action results in the tests
+ */
+class DetachedCoroutine
+{
+public:
+    class promise_type
+    {
+    public:
+        DetachedCoroutine get_return_object()
+        {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void()
+        {
+        }
+
+        void unhandled_exception()
+        {
+            std::terminate();
+        }
+    };
+};
+
+static DetachedCoroutine awaitResult(QFuture<UpnpActionResult> future, std::shared_ptr<UpnpActionResult> result)
+{
+    *result = co_await std::move(future);
+}
+
+#endif
+
+class ActionResultTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void initTestCase()
+    {
+        qRegisterMetaType<UpnpActionResult>();
+    }
+
+    void resultFromError()
+    {
+        const auto &result = UpnpActionResult::fromError(QStringLiteral("invalid action index"));
+
+        QVERIFY(!result.mSuccess);
+        QVERIFY(!result.mIsTransportError);
+        QCOMPARE(result.mError, QStringLiteral("invalid action index"));
+        QVERIFY(result.mValues.isEmpty());
+
+        const auto &transportResult = UpnpActionResult::fromTransportError(QStringLiteral("timeout"));
+
+        QVERIFY(!transportResult.mSuccess);
+        QVERIFY(transportResult.mIsTransportError);
+        QCOMPARE(transportResult.mError, QStringLiteral("timeout"));
+    }
+
+    void completion()
+    {
+        auto emptyCompletion = UpnpActionCompletion{};
+        QVERIFY(!emptyCompletion.isCanceled());
+        emptyCompletion.finish(UpnpActionResult::fromError(QStringLiteral("nobody is waiting")));
+
+        auto finishedCount = 0;
+        auto isCanceled = false;
+        auto receivedResult = UpnpActionResult{};
+
+        const auto completion = UpnpActionCompletion{[&](const UpnpActionResult &result) {
+                                                         ++finishedCount;
+                                                         receivedResult = result;
+                                                     },
+                                                     [&]() {
+                                                         return isCanceled;
+                                                     }};
+
+        QVERIFY(!completion.isCanceled());
+        isCanceled = true;
+        QVERIFY(completion.isCanceled());
+
+        auto answer = UpnpActionResult{};
+        answer.mSuccess = true;
+        answer.mValues[QStringLiteral("CurrentVolume")] = QStringLiteral("12");
+        completion.finish(answer);
+
+        QCOMPARE(finishedCount, 1);
+        QVERIFY(receivedResult.mSuccess);
+        QCOMPARE(receivedResult.mValues.value(QStringLiteral("CurrentVolume")).toString(), QStringLiteral("12"));
+    }
+
+    void awaiterFinished()
+    {
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+        QPromise<UpnpActionResult> promise;
+        promise.start();
+
+        auto result = std::make_shared<UpnpActionResult>(UpnpActionResult::fromError(QStringLiteral("not resumed")));
+        awaitResult(promise.future(), result);
+
+        QCOMPARE(result->mError, QStringLiteral("not resumed"));
+
+        auto answer = UpnpActionResult{};
+        answer.mSuccess = true;
+        promise.addResult(answer);
+        promise.finish();
+
+        QVERIFY(result->mSuccess);
+        QVERIFY(result->mError.isEmpty());
+#else
+        QSKIP("C++20 coroutines are not available");
+#endif
+    }
+
+    void awaiterReady()
+    {
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+        QPromise<UpnpActionResult> promise;
+        promise.start();
+        promise.addResult(UpnpActionResult::fromTransportError(QStringLiteral("timeout")));
+        promise.finish();
+
+        auto result = std::make_shared<UpnpActionResult>();
+        awaitResult(promise.future(), result);
+
+        QVERIFY(!result->mSuccess);
+        QVERIFY(result->mIsTransportError);
+        QCOMPARE(result->mError, QStringLiteral("timeout"));
+#else
+        QSKIP("C++20 coroutines are not available");
+#endif
+    }
+
+    void awaiterCanceled()
+    {
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+        QPromise<UpnpActionResult> promise;
+        promise.start();
+
+        auto result = std::make_shared<UpnpActionResult>();
+        result->mSuccess = true;
+        awaitResult(promise.future(), result);
+
+        promise.future().cancel();
+        promise.finish();
+
+        QVERIFY(!result->mSuccess);
+        QCOMPARE(result->mError, QStringLiteral("action call canceled"));
+#else
+        QSKIP("C++20 coroutines are not available");
+#endif
+    }
+};
+
+QTEST_GUILESS_MAIN(ActionResultTest)
+
+#include "actionresulttest.moc"
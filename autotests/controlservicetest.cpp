@@ -0,0 +1,282 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpcontrolabstractservice.h"
+
+#include "upnpservicedescription.h"
+#include "upnpstatevariabledescription.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDir>
+#include <QtCore/QList>
+#include <QtCore/QMap>
+#include <QtCore/QObject>
+#include <QtCore/QPair>
+#include <QtCore/QString>
+#include <QtCore/QUrl>
+
+#include <QtTest/QtTest>
+
+#include <optional>
+
+class RecordingControlService : public UpnpControlAbstractService
+{
+public:
+    QList<QPair<QString, QString>> mEvents;
+
+protected:
+    void parseEventNotification(const QString &eventName, const QString &eventValue) override
+    {
+        mEvents.push_back({eventName, eventValue});
+    }
+};
+
+class ControlServiceTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void stateVariableValuesBeforeDescription()
+    {
+        UpnpControlAbstractService service;
+        unloadedDescription(service);
+
+        QSignalSpy changedSpy(&service, &UpnpControlAbstractService::stateVariableChanged);
+
+        service.handleEventNotification(propertySet(QStringLiteral("Status"), QStringLiteral("1")), {});
+
+        QCOMPARE(changedSpy.count(), 1);
+        QCOMPARE(service.stateVariableValue(QStringLiteral("Status")).metaType().id(), int(QMetaType::QString));
+
+        auto newDescription = service.description();
+        newDescription.addStateVariable(stateVariable(QStringLiteral("Status"), QStringLiteral("boolean")));
+        service.setDescription(newDescription);
+
+        // the stored value gets the type of its state variable without being notified as a change
+        QCOMPARE(changedSpy.count(), 1);
+        QCOMPARE(service.stateVariableValue(QStringLiteral("Status")), QVariant(true));
+
+        service.handleEventNotification(propertySet(QStringLiteral("Status"), QStringLiteral("true")), {});
+
+        QCOMPARE(changedSpy.count(), 1);
+
+        service.handleEventNotification(propertySet(QStringLiteral("Status"), QStringLiteral("0")), {});
+
+        QCOMPARE(changedSpy.count(), 2);
+        QCOMPARE(service.stateVariableValue(QStringLiteral("Status")), QVariant(false));
+    }
+
+    void typedEventValues()
+    {
+        RecordingControlService service;
+
+        auto newDescription = service.description();
+        newDescription.addStateVariable(stateVariable(QStringLiteral("Volume"), QStringLiteral("ui2")));
+        newDescription.addStateVariable(stateVariable(QStringLiteral("Title"), QStringLiteral("string")));
+        service.setDescription(newDescription);
+
+        service.handleEventNotification(propertySet(QStringLiteral("Volume"), QStringLiteral("12")), {});
+        service.handleEventNotification(propertySet(QStringLiteral("Title"), QStringLiteral("Für Elise")), {});
+        service.handleEventNotification(propertySet(QStringLiteral("Unknown"), QStringLiteral("7")), {});
+
+        QCOMPARE(service.stateVariableValue(QStringLiteral("Volume")), QVariant(qulonglong(12)));
+        QCOMPARE(service.stateVariableValue(QStringLiteral("Title")), QVariant(QStringLiteral("Für Elise")));
+        QCOMPARE(service.stateVariableValue(QStringLiteral("Unknown")), QVariant(QStringLiteral("7")));
+
+        // the text of the values is still given to the subclasses
+        QCOMPARE(service.mEvents,
+                 (QList<QPair<QString, QString>>{{QStringLiteral("Volume"), QStringLiteral("12")},
+                                                 {QStringLiteral("Title"), QStringLiteral("Für Elise")},
+                                                 {QStringLiteral("Unknown"), QStringLiteral("7")}}));
+    }
+
+    void lastChangeEvents()
+    {
+        UpnpControlAbstractService service;
+
+        auto newDescription = service.description();
+        newDescription.addStateVariable(stateVariable(QStringLiteral("LastChange"), QStringLiteral("string")));
+        newDescription.addStateVariable(stateVariable(QStringLiteral("Volume"), QStringLiteral("ui2")));
+        service.setDescription(newDescription);
+
+        QSignalSpy instanceSpy(&service, &UpnpControlAbstractService::instanceStateVariableChanged);
+
+        const auto lastChange = QStringLiteral("<Event xmlns=\"urn:schemas-upnp-org:metadata-1-0/RCS/\">"
+                                               "<InstanceID val=\"0\"><Volume channel=\"Master\" val=\"24\"/></InstanceID>"
+                                               "<InstanceID val=\"1\"><Volume channel=\"Master\" val=\"5\"/></InstanceID>"
+                                               "</Event>");
+        service.handleEventNotification(propertySet(QStringLiteral("LastChange"), lastChange.toHtmlEscaped()), {});
+
+        QCOMPARE(instanceSpy.count(), 2);
+        QCOMPARE(instanceSpy.at(0).at(0).value<quint32>(), quint32(0));
+        QCOMPARE(instanceSpy.at(0).at(1).toString(), QStringLiteral("Volume"));
+        QCOMPARE(instanceSpy.at(0).at(2).toString(), QStringLiteral("Master"));
+        QCOMPARE(instanceSpy.at(0).at(3), QVariant(qulonglong(24)));
+
+        // only the master channel of the first instance is mirrored in the state variables
+        QCOMPARE(service.stateVariableValue(QStringLiteral("Volume")), QVariant(qulonglong(24)));
+        QCOMPARE(service.instanceStateVariableValue(1, QStringLiteral("Volume"), QStringLiteral("Master")), QVariant(qulonglong(5)));
+
+        service.handleEventNotification(propertySet(QStringLiteral("LastChange"), lastChange.toHtmlEscaped()), {});
+
+        QCOMPARE(instanceSpy.count(), 2);
+    }
+
+    void eventSequenceStart()
+    {
+        UpnpControlAbstractService service;
+
+        QVERIFY(acceptsEvent(service, QStringLiteral("1"), 0));
+        QVERIFY(acceptsEvent(service, QStringLiteral("2"), 1));
+        QVERIFY(acceptsEvent(service, QStringLiteral("3"), 2));
+
+        // without SEQ header, the event is always accepted
+        QVERIFY(acceptsEvent(service, QStringLiteral("4"), {}));
+
+        QCOMPARE(service.eventSequenceGaps(), quint64(0));
+        QCOMPARE(service.outOfOrderEvents(), quint64(0));
+    }
+
+    void eventSequenceWrap()
+    {
+        UpnpControlAbstractService service;
+        QSignalSpy gapSpy(&service, &UpnpControlAbstractService::eventSequenceGapDetected);
+
+        QVERIFY(acceptsEvent(service, QStringLiteral("1"), 4294967294u));
+        QVERIFY(acceptsEvent(service, QStringLiteral("2"), 4294967295u));
+
+        // the counter wraps to 1, 0 is only used by the initial event
+        QVERIFY(acceptsEvent(service, QStringLiteral("3"), 1));
+        QVERIFY(acceptsEvent(service, QStringLiteral("4"), 2));
+
+        QCOMPARE(gapSpy.count(), 0);
+        QCOMPARE(service.eventSequenceGaps(), quint64(0));
+    }
+
+    void eventSequenceDuplicate()
+    {
+        UpnpControlAbstractService service;
+
+        QVERIFY(acceptsEvent(service, QStringLiteral("1"), 0));
+        QVERIFY(acceptsEvent(service, QStringLiteral("2"), 1));
+        QVERIFY(acceptsEvent(service, QStringLiteral("3"), 2));
+
+        QVERIFY(!acceptsEvent(service, QStringLiteral("4"), 2));
+        QVERIFY(!acceptsEvent(service, QStringLiteral("5"), 1));
+        QCOMPARE(service.stateVariableValue(QStringLiteral("Status")), QVariant(QStringLiteral("3")));
+        QCOMPARE(service.outOfOrderEvents(), quint64(2));
+
+        QVERIFY(acceptsEvent(service, QStringLiteral("6"), 3));
+        QCOMPARE(service.eventSequenceGaps(), quint64(0));
+
+        service.resetEventStatistics();
+        QCOMPARE(service.outOfOrderEvents(), quint64(0));
+    }
+
+    void eventSequenceGap()
+    {
+        UpnpControlAbstractService service;
+        QSignalSpy gapSpy(&service, &UpnpControlAbstractService::eventSequenceGapDetected);
+
+        QVERIFY(acceptsEvent(service, QStringLiteral("1"), 0));
+        QVERIFY(acceptsEvent(service, QStringLiteral("2"), 1));
+
+        // the values of the event are still newer than the known ones
+        QVERIFY(acceptsEvent(service, QStringLiteral("3"), 5));
+
+        QCOMPARE(gapSpy.count(), 1);
+        QCOMPARE(gapSpy.at(0).at(0).value<quint32>(), quint32(2));
+        QCOMPARE(gapSpy.at(0).at(1).value<quint32>(), quint32(5));
+        QCOMPARE(service.eventSequenceGaps(), quint64(1));
+        QCOMPARE(service.missedEvents(), quint64(3));
+        QCOMPARE(service.eventResynchronizations(), quint64(1));
+
+        // the new subscription starts again from its initial event
+        QVERIFY(acceptsEvent(service, QStringLiteral("4"), 0));
+        QVERIFY(acceptsEvent(service, QStringLiteral("5"), 1));
+        QCOMPARE(gapSpy.count(), 1);
+    }
+
+    void stateVariableTypes()
+    {
+        QCOMPARE(UpnpStateVariableDescription::typeFromDataType(QStringLiteral("ui4")), UpnpStateVariableType::UnsignedInteger);
+        QCOMPARE(UpnpStateVariableDescription::typeFromDataType(QStringLiteral("i2")), UpnpStateVariableType::SignedInteger);
+        QCOMPARE(UpnpStateVariableDescription::typeFromDataType(QStringLiteral("r8")), UpnpStateVariableType::Real);
+        QCOMPARE(UpnpStateVariableDescription::typeFromDataType(QStringLiteral("boolean")), UpnpStateVariableType::Boolean);
+        QCOMPARE(UpnpStateVariableDescription::typeFromDataType(QStringLiteral("dateTime.tz")), UpnpStateVariableType::DateTime);
+        QCOMPARE(UpnpStateVariableDescription::typeFromDataType(QStringLiteral("bin.hex")), UpnpStateVariableType::Hex);
+        QCOMPARE(UpnpStateVariableDescription::typeFromDataType(QStringLiteral("string")), UpnpStateVariableType::String);
+
+        const auto volume = stateVariable(QStringLiteral("Volume"), QStringLiteral("ui2"));
+        QCOMPARE(volume.typedValue(QStringLiteral("42")), QVariant(qulonglong(42)));
+        QCOMPARE(volume.typedValue(QStringLiteral("loud")), QVariant(QStringLiteral("loud")));
+    }
+
+    void actionTimeoutIsOptIn()
+    {
+        RecordingControlService service;
+        QCOMPARE(service.actionTimeout(), 0);
+
+        QSignalSpy timeoutSpy(&service, &UpnpControlAbstractService::actionTimeoutChanged);
+        service.setActionTimeout(5000);
+        QCOMPARE(service.actionTimeout(), 5000);
+        QCOMPARE(timeoutSpy.count(), 1);
+    }
+
+private:
+    /**
+     * @brief unloadedDescription gives service a description that is not loaded, without downloading it
+     */
+    static void unloadedDescription(UpnpControlAbstractService &service)
+    {
+        UpnpServiceDescription newDescription;
+        newDescription.setSCPDURL(QUrl::fromLocalFile(QDir::temp().filePath(QStringLiteral("missing-upnp-scpd.xml"))));
+        service.setDescription(newDescription);
+    }
+
+    static UpnpStateVariableDescription stateVariable(const QString &name, const QString &dataType)
+    {
+        UpnpStateVariableDescription result;
+
+        result.mIsValid = true;
+        result.mUpnpName = name;
+        result.mEvented = true;
+        result.mDataType = dataType;
+        result.mType = UpnpStateVariableDescription::typeFromDataType(dataType);
+
+        return result;
+    }
+
+    /**
+     * @brief acceptsEvent sends an event giving value to Status with sequence as SEQ header and tells if it has been applied
+     */
+    static bool acceptsEvent(UpnpControlAbstractService &service, const QString &value, std::optional<quint32> sequence)
+    {
+        QMap<QByteArray, QByteArray> headers;
+        if (sequence) {
+            headers[QByteArrayLiteral("seq")] = QByteArray::number(*sequence);
+        }
+
+        service.handleEventNotification(propertySet(QStringLiteral("Status"), value), headers);
+
+        return service.stateVariableValue(QStringLiteral("Status")) == QVariant(value);
+    }
+
+    static QByteArray propertySet(const QString &name, const QString &value)
+    {
+        return QStringLiteral("<?xml version=\"1.0\"?>"
+                              "<e:propertyset xmlns:e=\"urn:schemas-upnp-org:event-1-0\">"
+                              "<e:property><%1>%2</%1></e:property>"
+                              "</e:propertyset>")
+            .arg(name, value)
+            .toUtf8();
+    }
+};
+
+QTEST_GUILESS_MAIN(ControlServiceTest)
+
+#include "controlservicetest.moc"
@@ -0,0 +1,265 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpdescriptionfetchscheduler.h"
+
+#include <QtCore/QList>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QUrl>
+
+#include <QtNetwork/QHostAddress>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkProxy>
+#include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+
+#include <QtTest/QtTest>
+
+#include <memory>
+
+/**
+ * @brief The DescriptionHttpServer class records the paths of the requests and answers them only if mAnswerRequests is true
+ */
+class DescriptionHttpServer : public QTcpServer
+{
+public:
+    DescriptionHttpServer()
+    {
+        connect(this, &QTcpServer::newConnection, this, &DescriptionHttpServer::acceptConnections);
+        listen(QHostAddress::LocalHost);
+    }
+
+    [[nodiscard]] QUrl url(const QString &path) const
+    {
+        return QUrl(QStringLiteral("http://127.0.0.1:%1%2").arg(serverPort()).arg(path));
+    }
+
+    bool mAnswerRequests = true;
+
+    QList<QString> mRequestedPaths;
+
+private:
+    void acceptConnections()
+    {
+        while (auto *newSocket = nextPendingConnection()) {
+            connect(newSocket, &QTcpSocket::readyRead, newSocket, [this, newSocket]() {
+                if (!newSocket->canReadLine()) {
+                    return;
+                }
+
+                const auto requestLine = QString::fromLatin1(newSocket->readLine()).split(QLatin1Char(' '));
+                newSocket->readAll();
+                if (requestLine.size() > 1) {
+                    mRequestedPaths.push_back(requestLine[1]);
+                }
+
+                if (mAnswerRequests) {
+                    newSocket->write("HTTP/1.1 200 OK\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+                    newSocket->disconnectFromHost();
+                }
+            });
+        }
+    }
+};
+
+class DescriptionFetchSchedulerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void init()
+    {
+        mNetworkAccess = std::make_unique<QNetworkAccessManager>();
+        mNetworkAccess->setProxy(QNetworkProxy::NoProxy);
+    }
+
+    void cleanup()
+    {
+        mNetworkAccess.reset();
+    }
+
+    void typePriorities()
+    {
+        UpnpDescriptionFetchScheduler scheduler(mNetworkAccess.get());
+
+        scheduler.setTypePriority(QStringLiteral("urn:schemas-upnp-org:device:MediaRenderer"), 5);
+        scheduler.setTypePriority(QStringLiteral("urn:schemas-upnp-org:device:MediaRenderer:2"), 7);
+
+        QCOMPARE(scheduler.typePriority(QStringLiteral("urn:schemas-upnp-org:device:MediaRenderer:1")), 5);
+        QCOMPARE(scheduler.typePriority(QStringLiteral("urn:schemas-upnp-org:device:MediaRenderer:2")), 7);
+        QCOMPARE(scheduler.typePriority(QStringLiteral("urn:schemas-upnp-org:device:MediaServer:1")), 0);
+        QCOMPARE(scheduler.typePriority(QString()), 0);
+    }
+
+    void perHostLimit()
+    {
+        DescriptionHttpServer server;
+        server.mAnswerRequests = false;
+
+        UpnpDescriptionFetchScheduler scheduler(mNetworkAccess.get());
+        QObject receiver;
+
+        for (int i = 0; i < 5; ++i) {
+            scheduler.fetch(server.url(QStringLiteral("/description%1.xml").arg(i)), QString(), &receiver, [](QNetworkReply *) {});
+        }
+
+        QCOMPARE(scheduler.runningFetches(), 2);
+        QCOMPARE(scheduler.pendingFetches(), 3);
+
+        scheduler.setMaximumConnectionsPerHost(3);
+        QCOMPARE(scheduler.runningFetches(), 3);
+        QCOMPARE(scheduler.pendingFetches(), 2);
+    }
+
+    void globalLimit()
+    {
+        DescriptionHttpServer firstServer;
+        DescriptionHttpServer secondServer;
+        firstServer.mAnswerRequests = false;
+        secondServer.mAnswerRequests = false;
+
+        UpnpDescriptionFetchScheduler scheduler(mNetworkAccess.get());
+        scheduler.setMaximumConnections(3);
+        QObject receiver;
+
+        for (int i = 0; i < 3; ++i) {
+            scheduler.fetch(firstServer.url(QStringLiteral("/description%1.xml").arg(i)), QString(), &receiver, [](QNetworkReply *) {});
+            scheduler.fetch(secondServer.url(QStringLiteral("/description%1.xml").arg(i)), QString(), &receiver, [](QNetworkReply *) {});
+        }
+
+        QCOMPARE(scheduler.runningFetches(), 3);
+        QCOMPARE(scheduler.pendingFetches(), 3);
+    }
+
+    void priorityOrder()
+    {
+        DescriptionHttpServer server;
+
+        UpnpDescriptionFetchScheduler scheduler(mNetworkAccess.get());
+        scheduler.setMaximumConnections(1);
+        scheduler.setTypePriority(QStringLiteral("urn:schemas-upnp-org:device:MediaServer"), -1);
+        scheduler.setTypePriority(QStringLiteral("urn:schemas-upnp-org:device:MediaRenderer"), 1);
+
+        QObject receiver;
+        QList<QString> finishedPaths;
+        const auto recordPath = [&finishedPaths](QNetworkReply *reply) {
+            finishedPaths.push_back(reply->url().path());
+        };
+
+        scheduler.fetch(server.url(QStringLiteral("/first.xml")), QString(), &receiver, recordPath);
+        scheduler.fetch(server.url(QStringLiteral("/low.xml")), QStringLiteral("urn:schemas-upnp-org:device:MediaServer:1"), &receiver, recordPath);
+        scheduler.fetch(server.url(QStringLiteral("/default.xml")), QString(), &receiver, recordPath);
+        scheduler.fetch(server.url(QStringLiteral("/high.xml")), QStringLiteral("urn:schemas-upnp-org:device:MediaRenderer:1"), &receiver, recordPath);
+        QCOMPARE(scheduler.runningFetches(), 1);
+        QCOMPARE(scheduler.pendingFetches(), 3);
+
+        QTRY_COMPARE(finishedPaths.size(), qsizetype(4));
+        QCOMPARE(finishedPaths,
+                 QList<QString>({QStringLiteral("/first.xml"), QStringLiteral("/high.xml"), QStringLiteral("/default.xml"), QStringLiteral("/low.xml")}));
+        QCOMPARE(server.mRequestedPaths, finishedPaths);
+    }
+
+    void cancelPendingFetch()
+    {
+        DescriptionHttpServer server;
+
+        UpnpDescriptionFetchScheduler scheduler(mNetworkAccess.get());
+        scheduler.setMaximumConnections(1);
+
+        QObject receiver;
+        QList<QString> finishedPaths;
+        const auto recordPath = [&finishedPaths](QNetworkReply *reply) {
+            finishedPaths.push_back(reply->url().path());
+        };
+
+        scheduler.fetch(server.url(QStringLiteral("/first.xml")), QString(), &receiver, recordPath);
+        const auto cancelledFetch = scheduler.fetch(server.url(QStringLiteral("/cancelled.xml")), QString(), &receiver, recordPath);
+        scheduler.fetch(server.url(QStringLiteral("/last.xml")), QString(), &receiver, recordPath);
+
+        scheduler.cancel(cancelledFetch);
+        QCOMPARE(scheduler.pendingFetches(), 1);
+
+        QTRY_COMPARE(finishedPaths, QList<QString>({QStringLiteral("/first.xml"), QStringLiteral("/last.xml")}));
+        QVERIFY(!server.mRequestedPaths.contains(QStringLiteral("/cancelled.xml")));
+    }
+
+    void cancelRunningFetch()
+    {
+        DescriptionHttpServer server;
+        server.mAnswerRequests = false;
+
+        UpnpDescriptionFetchScheduler scheduler(mNetworkAccess.get());
+        scheduler.setMaximumConnections(1);
+
+        QObject receiver;
+        int callbackCalls = 0;
+
+        const auto runningFetch = scheduler.fetch(server.url(QStringLiteral("/running.xml")), QString(), &receiver, [&callbackCalls](QNetworkReply *) {
+            ++callbackCalls;
+        });
+        scheduler.fetch(server.url(QStringLiteral("/next.xml")), QString(), &receiver, [](QNetworkReply *) {});
+        QCOMPARE(scheduler.runningFetches(), 1);
+        QCOMPARE(scheduler.pendingFetches(), 1);
+
+        scheduler.cancel(runningFetch);
+
+        // the next fetch takes the place of the cancelled one
+        QCOMPARE(scheduler.runningFetches(), 1);
+        QCOMPARE(scheduler.pendingFetches(), 0);
+        QTRY_VERIFY(server.mRequestedPaths.contains(QStringLiteral("/next.xml")));
+        QCOMPARE(callbackCalls, 0);
+    }
+
+    void transferTimeout()
+    {
+        DescriptionHttpServer server;
+        server.mAnswerRequests = false;
+
+        UpnpDescriptionFetchScheduler scheduler(mNetworkAccess.get());
+        scheduler.setTimeout(200);
+
+        QObject receiver;
+        bool isFinished = false;
+        auto error = QNetworkReply::NoError;
+
+        scheduler.fetch(server.url(QStringLiteral("/slow.xml")), QString(), &receiver, [&isFinished, &error](QNetworkReply *reply) {
+            isFinished = true;
+            error = reply->error();
+        });
+
+        QTRY_VERIFY_WITH_TIMEOUT(isFinished, 2000);
+        QVERIFY(error != QNetworkReply::NoError);
+        QCOMPARE(scheduler.runningFetches(), 0);
+    }
+
+    void destroyedReceiver()
+    {
+        DescriptionHttpServer server;
+
+        UpnpDescriptionFetchScheduler scheduler(mNetworkAccess.get());
+
+        auto receiver = std::make_unique<QObject>();
+        int callbackCalls = 0;
+
+        scheduler.fetch(server.url(QStringLiteral("/description.xml")), QString(), receiver.get(), [&callbackCalls](QNetworkReply *) {
+            ++callbackCalls;
+        });
+        receiver.reset();
+
+        QTRY_COMPARE(scheduler.runningFetches(), 0);
+        QCOMPARE(callbackCalls, 0);
+    }
+
+private:
+    std::unique_ptr<QNetworkAccessManager> mNetworkAccess;
+};
+
+QTEST_GUILESS_MAIN(DescriptionFetchSchedulerTest)
+
+#include "descriptionfetchschedulertest.moc"
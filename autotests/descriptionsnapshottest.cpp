@@ -0,0 +1,288 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpactiondescription.h"
+#include "upnpdescriptionsnapshot.h"
+#include "upnpdevicedescription.h"
+#include "upnpservicedescription.h"
+#include "upnpstatevariabledescription.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QUrl>
+
+#include <QtTest/QtTest>
+
+static UpnpServiceDescription switchPowerService()
+{
+    auto result = UpnpServiceDescription{};
+    result.setServiceType(QStringLiteral("urn:schemas-upnp-org:service:SwitchPower:1"));
+    result.setServiceId(QStringLiteral("urn:upnp-org:serviceId:SwitchPower"));
+    result.setSCPDURL(QUrl(QStringLiteral("http://192.168.1.2:49152/SwitchPower.xml")));
+    result.setControlURL(QUrl(QStringLiteral("http://192.168.1.2:49152/SwitchPower/control")));
+    result.setEventURL(QUrl(QStringLiteral("http://192.168.1.2:49152/SwitchPower/event")));
+    result.setSCPDLoaded(true);
+
+    auto targetArgument = UpnpActionArgumentDescription{};
+    targetArgument.mIsValid = true;
+    targetArgument.mName = QStringLiteral("newTargetValue");
+    targetArgument.mDirection = UpnpArgumentDirection::In;
+    targetArgument.mRelatedStateVariable = QStringLiteral("Target");
+
+    auto setTarget = UpnpActionDescription{};
+    setTarget.mIsValid = true;
+    setTarget.mName = QStringLiteral("SetTarget");
+    setTarget.mArguments = {targetArgument};
+    setTarget.mNumberInArgument = 1;
+    result.actions()[setTarget.mName] = setTarget;
+
+    auto target = UpnpStateVariableDescription{};
+    target.mIsValid = true;
+    target.mUpnpName = QStringLiteral("Target");
+    target.mDataType = QStringLiteral("boolean");
+    target.mType = UpnpStateVariableDescription::typeFromDataType(target.mDataType);
+    target.mDefaultValue = QStringLiteral("0");
+    result.stateVariables()[target.mUpnpName] = target;
+
+    return result;
+}
+
+static UpnpDeviceDescription lightDevice(const QString &udn, const QUrl &location)
+{
+    auto result = UpnpDeviceDescription{};
+    result.setUDN(udn);
+    result.setDeviceType(QStringLiteral("urn:schemas-upnp-org:device:BinaryLight:1"));
+    result.setFriendlyName(QStringLiteral("Kitchen light"));
+    result.setLocationUrl(location);
+    result.services().push_back(switchPowerService());
+
+    return result;
+}
+
+class DescriptionSnapshotTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void init()
+    {
+        QVERIFY(mTemporaryDirectory.isValid());
+        mFileName = mTemporaryDirectory.filePath(QStringLiteral("devices.snapshot"));
+        QFile::remove(mFileName);
+    }
+
+    void roundTrip()
+    {
+        UpnpDescriptionSnapshot savedSnapshot;
+        savedSnapshot.insert(lightDevice(QStringLiteral("uuid:kitchen"), mKitchenLocation), 3);
+        savedSnapshot.insert(lightDevice(QStringLiteral("uuid:hall"), mHallLocation));
+        QCOMPARE(savedSnapshot.size(), 2);
+        QVERIFY(savedSnapshot.save(mFileName));
+
+        UpnpDescriptionSnapshot loadedSnapshot;
+        QVERIFY(loadedSnapshot.load(mFileName));
+        QCOMPARE(loadedSnapshot.size(), 2);
+        QVERIFY(loadedSnapshot.contains(mKitchenLocation, 3));
+        QVERIFY(loadedSnapshot.contains(mHallLocation));
+
+        const auto &kitchen = loadedSnapshot.find(mKitchenLocation, 3);
+        QVERIFY(kitchen);
+        QCOMPARE(kitchen->UDN(), QStringLiteral("uuid:kitchen"));
+        QCOMPARE(kitchen->friendlyName(), QStringLiteral("Kitchen light"));
+        QCOMPARE(kitchen->deviceType(), QStringLiteral("urn:schemas-upnp-org:device:BinaryLight:1"));
+        QCOMPARE(kitchen->locationUrl(), mKitchenLocation);
+        QCOMPARE(kitchen->services().size(), qsizetype(1));
+
+        const auto &service = kitchen->services().first();
+        QCOMPARE(service.serviceId(), QStringLiteral("urn:upnp-org:serviceId:SwitchPower"));
+        QCOMPARE(service.controlURL(), QUrl(QStringLiteral("http://192.168.1.2:49152/SwitchPower/control")));
+        QVERIFY(service.isSCPDLoaded());
+
+        QCOMPARE(service.actions().size(), qsizetype(1));
+        const auto &setTarget = service.actions().value(QStringLiteral("SetTarget"));
+        QVERIFY(setTarget.mIsValid);
+        QCOMPARE(setTarget.mArguments.size(), qsizetype(1));
+        QCOMPARE(setTarget.mArguments.first().mName, QStringLiteral("newTargetValue"));
+        QCOMPARE(setTarget.mArguments.first().mDirection, UpnpArgumentDirection::In);
+        QCOMPARE(setTarget.mArguments.first().mRelatedStateVariable, QStringLiteral("Target"));
+
+        QCOMPARE(service.stateVariables().size(), qsizetype(1));
+        const auto &target = service.stateVariables().value(QStringLiteral("Target"));
+        QCOMPARE(target.mDataType, QStringLiteral("boolean"));
+        QCOMPARE(target.mType, UpnpStateVariableType::Boolean);
+        QCOMPARE(target.mDefaultValue, QStringLiteral("0"));
+
+        QCOMPARE(loadedSnapshot.descriptions().size(), qsizetype(2));
+
+        // entries read from the mapped file are written again without being decoded
+        const auto otherFileName = mTemporaryDirectory.filePath(QStringLiteral("other.snapshot"));
+        QVERIFY(loadedSnapshot.save(otherFileName));
+
+        UpnpDescriptionSnapshot reloadedSnapshot;
+        QVERIFY(reloadedSnapshot.load(otherFileName));
+        QCOMPARE(reloadedSnapshot.size(), 2);
+        QCOMPARE(reloadedSnapshot.find(mHallLocation)->UDN(), QStringLiteral("uuid:hall"));
+    }
+
+    void configurationChanged()
+    {
+        UpnpDescriptionSnapshot savedSnapshot;
+        savedSnapshot.insert(lightDevice(QStringLiteral("uuid:kitchen"), mKitchenLocation), 3);
+        QVERIFY(savedSnapshot.save(mFileName));
+
+        UpnpDescriptionSnapshot loadedSnapshot;
+        QVERIFY(loadedSnapshot.load(mFileName));
+
+        QVERIFY(loadedSnapshot.find(mKitchenLocation, 3));
+        QVERIFY(!loadedSnapshot.find(mKitchenLocation, 4));
+        QVERIFY(!loadedSnapshot.find(mKitchenLocation));
+        QVERIFY(!loadedSnapshot.contains(mKitchenLocation, 4));
+        QVERIFY(!loadedSnapshot.find(mHallLocation, 3));
+    }
+
+    void invalidHeader_data()
+    {
+        QTest::addColumn<int>("offset");
+
+        // the magic number and the format version are big endian integers at the start of the file
+        QTest::newRow("magic") << 0;
+        QTest::newRow("format version") << 7;
+    }
+
+    void invalidHeader()
+    {
+        QFETCH(int, offset);
+
+        UpnpDescriptionSnapshot savedSnapshot;
+        savedSnapshot.insert(lightDevice(QStringLiteral("uuid:kitchen"), mKitchenLocation));
+        QVERIFY(savedSnapshot.save(mFileName));
+
+        auto content = readFile();
+        QCOMPARE(content.at(7), char(UpnpDescriptionSnapshot::FormatVersion));
+        content[offset] = char(content.at(offset) + 1);
+        writeFile(content);
+
+        UpnpDescriptionSnapshot loadedSnapshot;
+        loadedSnapshot.insert(lightDevice(QStringLiteral("uuid:hall"), mHallLocation));
+        QVERIFY(!loadedSnapshot.load(mFileName));
+        QCOMPARE(loadedSnapshot.size(), 0);
+    }
+
+    void truncatedIndex_data()
+    {
+        QTest::addColumn<int>("keptBytes");
+
+        QTest::newRow("empty") << 0;
+        QTest::newRow("header") << 10;
+        QTest::newRow("index") << 20;
+    }
+
+    void truncatedIndex()
+    {
+        QFETCH(int, keptBytes);
+
+        saveTwoDevices();
+        writeFile(readFile().left(keptBytes));
+
+        UpnpDescriptionSnapshot loadedSnapshot;
+        QVERIFY(!loadedSnapshot.load(mFileName));
+        QCOMPARE(loadedSnapshot.size(), 0);
+        QVERIFY(!loadedSnapshot.find(mKitchenLocation));
+    }
+
+    void truncatedPayload_data()
+    {
+        QTest::addColumn<int>("removedBytes");
+
+        QTest::newRow("last byte") << 1;
+        QTest::newRow("end of the last device") << 10;
+    }
+
+    void truncatedPayload()
+    {
+        QFETCH(int, removedBytes);
+
+        saveTwoDevices();
+        writeFile(readFile().chopped(removedBytes));
+
+        UpnpDescriptionSnapshot loadedSnapshot;
+        QVERIFY(!loadedSnapshot.load(mFileName));
+        QCOMPARE(loadedSnapshot.size(), 0);
+        QVERIFY(!loadedSnapshot.find(mKitchenLocation));
+        QVERIFY(loadedSnapshot.descriptions().isEmpty());
+    }
+
+    void atomicOverwrite()
+    {
+        UpnpDescriptionSnapshot firstSnapshot;
+        firstSnapshot.insert(lightDevice(QStringLiteral("uuid:kitchen"), mKitchenLocation));
+        QVERIFY(firstSnapshot.save(mFileName));
+
+        UpnpDescriptionSnapshot loadedSnapshot;
+        QVERIFY(loadedSnapshot.load(mFileName));
+
+        UpnpDescriptionSnapshot secondSnapshot;
+        secondSnapshot.insert(lightDevice(QStringLiteral("uuid:hall"), mHallLocation));
+        QVERIFY(secondSnapshot.save(mFileName));
+
+        // the file is replaced, the mapping of the previous file stays valid
+        QCOMPARE(loadedSnapshot.find(mKitchenLocation)->UDN(), QStringLiteral("uuid:kitchen"));
+
+        // a snapshot can be saved to the file it is mapped from
+        QVERIFY(loadedSnapshot.save(mFileName));
+        QCOMPARE(loadedSnapshot.find(mKitchenLocation)->UDN(), QStringLiteral("uuid:kitchen"));
+
+        UpnpDescriptionSnapshot reloadedSnapshot;
+        QVERIFY(reloadedSnapshot.load(mFileName));
+        QCOMPARE(reloadedSnapshot.locations(), QList<QUrl>({mKitchenLocation}));
+
+        // no temporary file is left next to the snapshot
+        QCOMPARE(QDir(mTemporaryDirectory.path()).entryList({QStringLiteral("devices.snapshot*")}, QDir::Files), QStringList({QStringLiteral("devices.snapshot")}));
+    }
+
+private:
+    void saveTwoDevices() const
+    {
+        UpnpDescriptionSnapshot savedSnapshot;
+        savedSnapshot.insert(lightDevice(QStringLiteral("uuid:kitchen"), mKitchenLocation));
+        savedSnapshot.insert(lightDevice(QStringLiteral("uuid:hall"), mHallLocation));
+        QVERIFY(savedSnapshot.save(mFileName));
+    }
+
+    [[nodiscard]] QByteArray readFile() const
+    {
+        QFile snapshotFile(mFileName);
+        if (!snapshotFile.open(QIODevice::ReadOnly)) {
+            return {};
+        }
+
+        return snapshotFile.readAll();
+    }
+
+    void writeFile(const QByteArray &content) const
+    {
+        QFile snapshotFile(mFileName);
+        QVERIFY(snapshotFile.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        QCOMPARE(snapshotFile.write(content), qint64(content.size()));
+    }
+
+    QTemporaryDir mTemporaryDirectory;
+
+    QString mFileName;
+
+    const QUrl mKitchenLocation = QUrl(QStringLiteral("http://192.168.1.2:49152/description.xml"));
+
+    const QUrl mHallLocation = QUrl(QStringLiteral("http://192.168.1.3:49152/description.xml"));
+};
+
+QTEST_GUILESS_MAIN(DescriptionSnapshotTest)
+
+#include "descriptionsnapshottest.moc"
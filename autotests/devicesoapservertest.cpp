@@ -0,0 +1,283 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpabstractdevice.h"
+#include "upnpabstractservice.h"
+#include "upnpdevicesoapserver.h"
+
+#include "upnpactiondescription.h"
+#include "upnpdevicedescription.h"
+#include "upnpservicedescription.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QUrl>
+
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkProxy>
+#include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QNetworkRequest>
+
+#include <QtTest/QtTest>
+
+#include <memory>
+
+class TestDevice : public UpnpAbstractDevice
+{
+public:
+    explicit TestDevice(const QString &udn)
+    {
+        auto newDescription = UpnpDeviceDescription{};
+        newDescription.setUDN(udn);
+        setDescription(newDescription);
+    }
+
+    using UpnpAbstractDevice::addService;
+};
+
+class DeviceSoapServerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void initTestCase()
+    {
+        mNetwork.setProxy(QNetworkProxy::NoProxy);
+    }
+
+    void threadPoolCount()
+    {
+        UpnpDeviceSoapServer server;
+        QSignalSpy countSpy(&server, &UpnpDeviceSoapServer::maximumThreadCountChanged);
+
+        QCOMPARE(server.maximumThreadCount(), 0);
+        QVERIFY(!server.threadPool());
+
+        server.setMaximumThreadCount(2);
+        QVERIFY(server.threadPool());
+        auto *threadPool = server.threadPool();
+
+        server.setMaximumThreadCount(0);
+        QVERIFY(!server.threadPool());
+
+        // the pool is used again when threads are enabled again
+        server.setMaximumThreadCount(3);
+        QCOMPARE(server.threadPool(), threadPool);
+        QCOMPARE(server.maximumThreadCount(), 3);
+
+        server.setMaximumThreadCount(-1);
+        QCOMPARE(server.maximumThreadCount(), 3);
+        QCOMPARE(countSpy.count(), 3);
+    }
+
+    void descriptions_data()
+    {
+        QTest::addColumn<int>("threadCount");
+
+        QTest::newRow("server thread") << 0;
+        QTest::newRow("thread pool") << 2;
+    }
+
+    void descriptions()
+    {
+        QFETCH(int, threadCount);
+
+        UpnpDeviceSoapServer server;
+        server.setMaximumThreadCount(threadCount);
+
+        TestDevice device(QStringLiteral("test-device"));
+        UpnpAbstractService service;
+        service.setDescription(switchPowerDescription());
+        device.addService(&service);
+
+        const auto deviceId = server.addDevice(&device);
+
+        const auto deviceReply = download(server, QStringLiteral("/%1/device.xml").arg(deviceId));
+        QCOMPARE(deviceReply->error(), QNetworkReply::NoError);
+        QVERIFY(deviceReply->readAll().contains("<UDN>uuid:test-device</UDN>"));
+
+        const auto serviceReply = download(server, QStringLiteral("/%1/0/service.xml").arg(deviceId));
+        QCOMPARE(serviceReply->error(), QNetworkReply::NoError);
+        QVERIFY(serviceReply->readAll().contains("<name>GetStatus</name>"));
+
+        QVERIFY(download(server, QStringLiteral("/%1/1/service.xml").arg(deviceId))->error() != QNetworkReply::NoError);
+    }
+
+    void destroyedDevice()
+    {
+        UpnpDeviceSoapServer server;
+        server.setMaximumThreadCount(2);
+
+        auto device = std::make_unique<TestDevice>(QStringLiteral("test-device"));
+        const auto deviceId = server.addDevice(device.get());
+
+        QCOMPARE(download(server, QStringLiteral("/%1/device.xml").arg(deviceId))->error(), QNetworkReply::NoError);
+
+        device.reset();
+
+        QVERIFY(!server.device(deviceId));
+        QVERIFY(download(server, QStringLiteral("/%1/device.xml").arg(deviceId))->error() != QNetworkReply::NoError);
+    }
+
+    void deviceHandles()
+    {
+        UpnpDeviceSoapServer server;
+
+        TestDevice firstDevice(QStringLiteral("first-device"));
+        TestDevice secondDevice(QStringLiteral("second-device"));
+        TestDevice thirdDevice(QStringLiteral("third-device"));
+
+        const auto firstId = server.addDevice(&firstDevice);
+        const auto secondId = server.addDevice(&secondDevice);
+        const auto thirdId = server.addDevice(&thirdDevice);
+
+        QVERIFY(firstId != secondId && secondId != thirdId && firstId != thirdId);
+        QVERIFY(server.device(firstId) == &firstDevice);
+        QVERIFY(server.device(secondId) == &secondDevice);
+        QVERIFY(server.device(thirdId) == &thirdDevice);
+        QVERIFY(!server.device(thirdId + 1));
+        QVERIFY(!server.device(-1));
+
+        server.removeDevice(secondId);
+
+        QVERIFY(!server.device(secondId));
+        QVERIFY(server.device(firstId) == &firstDevice);
+        QVERIFY(server.device(thirdId) == &thirdDevice);
+
+        // handles are never reused
+        TestDevice fourthDevice(QStringLiteral("fourth-device"));
+        const auto fourthId = server.addDevice(&fourthDevice);
+        QVERIFY(fourthId != firstId && fourthId != secondId && fourthId != thirdId);
+
+        server.removeDevice(secondId);
+        server.removeDevice(42);
+        QVERIFY(server.device(thirdId) == &thirdDevice);
+    }
+
+    void removeDevice()
+    {
+        UpnpDeviceSoapServer server;
+
+        TestDevice firstDevice(QStringLiteral("first-device"));
+        TestDevice secondDevice(QStringLiteral("second-device"));
+
+        const auto firstId = server.addDevice(&firstDevice);
+        const auto secondId = server.addDevice(&secondDevice);
+
+        server.removeDevice(firstId);
+
+        QVERIFY(download(server, QStringLiteral("/%1/device.xml").arg(firstId))->error() != QNetworkReply::NoError);
+
+        // the URLs of the other devices do not change
+        const auto secondReply = download(server, QStringLiteral("/%1/device.xml").arg(secondId));
+        QCOMPARE(secondReply->error(), QNetworkReply::NoError);
+        QVERIFY(secondReply->readAll().contains("<UDN>uuid:second-device</UDN>"));
+
+        // a removed device is not routed again when its description changes
+        UpnpAbstractService service;
+        service.setDescription(switchPowerDescription());
+        firstDevice.addService(&service);
+
+        QVERIFY(download(server, QStringLiteral("/%1/device.xml").arg(firstId))->error() != QNetworkReply::NoError);
+        QVERIFY(download(server, QStringLiteral("/%1/0/service.xml").arg(firstId))->error() != QNetworkReply::NoError);
+    }
+
+    void servicesAddedLater()
+    {
+        UpnpDeviceSoapServer server;
+
+        TestDevice device(QStringLiteral("test-device"));
+        const auto deviceId = server.addDevice(&device);
+
+        QVERIFY(download(server, QStringLiteral("/%1/0/service.xml").arg(deviceId))->error() != QNetworkReply::NoError);
+
+        UpnpAbstractService service;
+        service.setDescription(switchPowerDescription());
+        device.addService(&service);
+
+        QCOMPARE(download(server, QStringLiteral("/%1/0/service.xml").arg(deviceId))->error(), QNetworkReply::NoError);
+    }
+
+    void publishedDocuments()
+    {
+        UpnpDeviceSoapServer server;
+        server.setMaximumThreadCount(2);
+
+        TestDevice device(QStringLiteral("test-device"));
+        UpnpAbstractService service;
+        service.setDescription(switchPowerDescription());
+        device.addService(&service);
+
+        const auto deviceId = server.addDevice(&device);
+        const auto deviceBuilds = device.xmlDescriptionBuilds();
+        const auto serviceBuilds = service.xmlDescriptionBuilds();
+
+        // the workers serve the documents of the route table without asking the devices again
+        for (int i = 0; i < 3; ++i) {
+            QCOMPARE(download(server, QStringLiteral("/%1/device.xml").arg(deviceId))->error(), QNetworkReply::NoError);
+            QCOMPARE(download(server, QStringLiteral("/%1/0/service.xml").arg(deviceId))->error(), QNetworkReply::NoError);
+        }
+        QCOMPARE(device.xmlDescriptionBuilds(), deviceBuilds);
+        QCOMPARE(service.xmlDescriptionBuilds(), serviceBuilds);
+
+        device.description().setFriendlyName(QStringLiteral("Renamed"));
+        device.invalidateXmlDescription();
+
+        const auto deviceReply = download(server, QStringLiteral("/%1/device.xml").arg(deviceId));
+        QCOMPARE(deviceReply->error(), QNetworkReply::NoError);
+        QVERIFY(deviceReply->readAll().contains("<friendlyName>Renamed</friendlyName>"));
+
+        auto getTarget = UpnpActionDescription{};
+        getTarget.mName = QStringLiteral("GetTarget");
+        getTarget.mIsValid = true;
+        service.addAction(getTarget);
+
+        const auto serviceReply = download(server, QStringLiteral("/%1/0/service.xml").arg(deviceId));
+        QCOMPARE(serviceReply->error(), QNetworkReply::NoError);
+        QVERIFY(serviceReply->readAll().contains("<name>GetTarget</name>"));
+    }
+
+private:
+    static UpnpServiceDescription switchPowerDescription()
+    {
+        auto result = UpnpServiceDescription{};
+        result.setServiceType(QStringLiteral("urn:schemas-upnp-org:service:SwitchPower:1"));
+        result.setServiceId(QStringLiteral("urn:upnp-org:serviceId:SwitchPower"));
+
+        auto getStatus = UpnpActionDescription{};
+        getStatus.mName = QStringLiteral("GetStatus");
+        getStatus.mIsValid = true;
+        result.addAction(getStatus);
+
+        return result;
+    }
+
+    std::unique_ptr<QNetworkReply> download(const UpnpDeviceSoapServer &server, const QString &path)
+    {
+        QUrl requestUrl;
+        requestUrl.setScheme(QStringLiteral("http"));
+        requestUrl.setHost(QStringLiteral("127.0.0.1"));
+        requestUrl.setPort(server.serverPort());
+        requestUrl.setPath(path);
+
+        std::unique_ptr<QNetworkReply> reply(mNetwork.get(QNetworkRequest(requestUrl)));
+
+        QSignalSpy finishedSpy(reply.get(), &QNetworkReply::finished);
+        if (!reply->isFinished()) {
+            finishedSpy.wait(5000);
+        }
+
+        return reply;
+    }
+
+    QNetworkAccessManager mNetwork;
+};
+
+QTEST_GUILESS_MAIN(DeviceSoapServerTest)
+
+#include "devicesoapservertest.moc"
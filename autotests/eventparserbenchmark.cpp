@@ -0,0 +1,108 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpeventpropertysetparser.h"
+
+#include <QtCore/QByteArray>
+
+#include <QtXml/QDomDocument>
+
+#include <QtTest/QtTest>
+
+// payloads recorded from a media renderer and a media server
+static const char renderingControlEvent[] =
+    "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+    "<e:propertyset xmlns:e=\"urn:schemas-upnp-org:event-1-0\">"
+    "<e:property><LastChange>&lt;Event xmlns=&quot;urn:schemas-upnp-org:metadata-1-0/RCS/&quot;&gt;"
+    "&lt;InstanceID val=&quot;0&quot;&gt;&lt;Volume channel=&quot;Master&quot; val=&quot;24&quot;/&gt;"
+    "&lt;Mute channel=&quot;Master&quot; val=&quot;0&quot;/&gt;&lt;/InstanceID&gt;&lt;/Event&gt;</LastChange></e:property>"
+    "</e:propertyset>";
+
+static const char avTransportEvent[] =
+    "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+    "<e:propertyset xmlns:e=\"urn:schemas-upnp-org:event-1-0\">"
+    "<e:property><LastChange>&lt;Event xmlns=&quot;urn:schemas-upnp-org:metadata-1-0/AVT/&quot;&gt;"
+    "&lt;InstanceID val=&quot;0&quot;&gt;&lt;TransportState val=&quot;PLAYING&quot;/&gt;"
+    "&lt;CurrentTrackDuration val=&quot;0:04:12&quot;/&gt;"
+    "&lt;CurrentTrackMetaData val=&quot;&amp;lt;DIDL-Lite xmlns=&amp;quot;urn:schemas-upnp-org:metadata-1-0/DIDL-Lite/&amp;quot;&amp;gt;"
+    "&amp;lt;item id=&amp;quot;42&amp;quot;&amp;gt;&amp;lt;dc:title&amp;gt;Für Elise – Ünïcödé&amp;lt;/dc:title&amp;gt;"
+    "&amp;lt;/item&amp;gt;&amp;lt;/DIDL-Lite&amp;gt;&quot;/&gt;"
+    "&lt;/InstanceID&gt;&lt;/Event&gt;</LastChange></e:property>"
+    "</e:propertyset>";
+
+static const char contentDirectoryEvent[] =
+    "<?xml version=\"1.0\"?>"
+    "<e:propertyset xmlns:e=\"urn:schemas-upnp-org:event-1-0\">"
+    "<e:property><SystemUpdateID>1337</SystemUpdateID></e:property>"
+    "<e:property><ContainerUpdateIDs>0,12,64$3,7</ContainerUpdateIDs></e:property>"
+    "<e:property><TransferIDs></TransferIDs></e:property>"
+    "</e:propertyset>";
+
+class EventParserBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void benchmarkStreamParser_data()
+    {
+        QTest::addColumn<QByteArray>("payload");
+
+        QTest::newRow("RenderingControl") << QByteArray(renderingControlEvent);
+        QTest::newRow("AVTransport") << QByteArray(avTransportEvent);
+        QTest::newRow("ContentDirectory") << QByteArray(contentDirectoryEvent);
+    }
+
+    void benchmarkStreamParser()
+    {
+        QFETCH(QByteArray, payload);
+
+        UpnpEventPropertySetParser parser;
+        qsizetype totalSize = 0;
+
+        QBENCHMARK {
+            const auto parsed = parser.parse(payload, [&totalSize](QStringView name, QStringView value) {
+                totalSize += name.size() + value.size();
+            });
+            QVERIFY(parsed);
+        }
+
+        QVERIFY(totalSize > 0);
+    }
+
+    void benchmarkDomParser_data()
+    {
+        benchmarkStreamParser_data();
+    }
+
+    void benchmarkDomParser()
+    {
+        QFETCH(QByteArray, payload);
+
+        qsizetype totalSize = 0;
+
+        QBENCHMARK {
+            QDomDocument document;
+            QVERIFY(document.setContent(payload));
+
+            QDomElement propertyNode = document.documentElement().firstChildElement();
+            while (!propertyNode.isNull()) {
+                QDomElement variableNode = propertyNode.firstChildElement();
+                while (!variableNode.isNull()) {
+                    totalSize += variableNode.tagName().size() + variableNode.text().size();
+                    variableNode = variableNode.nextSiblingElement();
+                }
+                propertyNode = propertyNode.nextSiblingElement();
+            }
+        }
+
+        QVERIFY(totalSize > 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(EventParserBenchmark)
+
+#include "eventparserbenchmark.moc"
@@ -0,0 +1,111 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpeventpropertysetparser.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QPair>
+#include <QtCore/QString>
+
+#include <QtTest/QtTest>
+
+class EventParserTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void parseAllProperties()
+    {
+        QList<QPair<QString, QString>> properties;
+
+        UpnpEventPropertySetParser parser;
+        QVERIFY(parser.parse(QByteArrayLiteral("<?xml version=\"1.0\"?>"
+                                               "<e:propertyset xmlns:e=\"urn:schemas-upnp-org:event-1-0\">"
+                                               "<e:property><SystemUpdateID>1337</SystemUpdateID></e:property>"
+                                               "<e:property><ContainerUpdateIDs>0,12,64$3,7</ContainerUpdateIDs></e:property>"
+                                               "<e:property><TransferIDs></TransferIDs></e:property>"
+                                               "</e:propertyset>"),
+                             [&properties](QStringView name, QStringView value) {
+                                 properties.push_back({name.toString(), value.toString()});
+                             }));
+
+        QCOMPARE(properties.size(), qsizetype(3));
+        QCOMPARE(properties[0], qMakePair(QStringLiteral("SystemUpdateID"), QStringLiteral("1337")));
+        QCOMPARE(properties[1], qMakePair(QStringLiteral("ContainerUpdateIDs"), QStringLiteral("0,12,64$3,7")));
+        QCOMPARE(properties[2], qMakePair(QStringLiteral("TransferIDs"), QString()));
+    }
+
+    void parseSeveralVariablesInOneProperty()
+    {
+        QList<QString> names;
+
+        UpnpEventPropertySetParser parser;
+        QVERIFY(parser.parse(QByteArrayLiteral("<e:propertyset xmlns:e=\"urn:schemas-upnp-org:event-1-0\">"
+                                               "<e:property><Volume>12</Volume><Mute>0</Mute></e:property>"
+                                               "</e:propertyset>"),
+                             [&names](QStringView name, QStringView) {
+                                 names.push_back(name.toString());
+                             }));
+
+        QCOMPARE(names, QList<QString>({QStringLiteral("Volume"), QStringLiteral("Mute")}));
+    }
+
+    void parseUtf8Value()
+    {
+        QString title;
+
+        UpnpEventPropertySetParser parser;
+        QVERIFY(parser.parse(QStringLiteral("<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+                                            "<e:propertyset xmlns:e=\"urn:schemas-upnp-org:event-1-0\">"
+                                            "<e:property><CurrentTitle>Für Elise – Ünïcödé</CurrentTitle></e:property>"
+                                            "</e:propertyset>")
+                                 .toUtf8(),
+                             [&title](QStringView name, QStringView value) {
+                                 QCOMPARE(name.toString(), QStringLiteral("CurrentTitle"));
+                                 title = value.toString();
+                             }));
+
+        QCOMPARE(title, QStringLiteral("Für Elise – Ünïcödé"));
+    }
+
+    void parseEscapedValue()
+    {
+        QString lastChange;
+
+        UpnpEventPropertySetParser parser;
+        QVERIFY(parser.parse(QByteArrayLiteral("<e:propertyset xmlns:e=\"urn:schemas-upnp-org:event-1-0\">"
+                                               "<e:property><LastChange>&lt;Event&gt;&lt;InstanceID val=&quot;0&quot;/&gt;&lt;/Event&gt;</LastChange></e:property>"
+                                               "</e:propertyset>"),
+                             [&lastChange](QStringView, QStringView value) {
+                                 lastChange = value.toString();
+                             }));
+
+        QCOMPARE(lastChange, QStringLiteral("<Event><InstanceID val=\"0\"/></Event>"));
+    }
+
+    void parseInvalidDocument()
+    {
+        UpnpEventPropertySetParser parser;
+        QVERIFY(!parser.parse(QByteArrayLiteral("<e:propertyset xmlns:e=\"urn:schemas-upnp-org:event-1-0\"><e:property><Volume>"),
+                              [](QStringView, QStringView) {}));
+        QVERIFY(!parser.errorString().isEmpty());
+
+        // the buffers of the failed document are not reused for the next one
+        auto count = 0;
+        QVERIFY(parser.parse(QByteArrayLiteral("<e:propertyset xmlns:e=\"urn:schemas-upnp-org:event-1-0\"><e:property><Volume>3</Volume></e:property></e:propertyset>"),
+                             [&count](QStringView, QStringView value) {
+                                 QCOMPARE(value.toString(), QStringLiteral("3"));
+                                 ++count;
+                             }));
+        QCOMPARE(count, 1);
+    }
+};
+
+QTEST_GUILESS_MAIN(EventParserTest)
+
+#include "eventparsertest.moc"
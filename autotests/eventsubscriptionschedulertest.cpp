@@ -0,0 +1,186 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpeventsubscriptionscheduler.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QList>
+#include <QtCore/QObject>
+
+#include <QtTest/QtTest>
+
+#include <memory>
+
+class EventSubscriptionSchedulerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void renewalDelay()
+    {
+        UpnpEventSubscriptionScheduler scheduler;
+        scheduler.setJitter(0);
+
+        QCOMPARE(scheduler.renewalDelay(1800), qint64(1740000));
+
+        // short subscriptions are renewed at half of their duration
+        QCOMPARE(scheduler.renewalDelay(60), qint64(30000));
+        QCOMPARE(scheduler.renewalDelay(1), qint64(1000));
+
+        scheduler.setJitter(10);
+        for (int i = 0; i < 100; ++i) {
+            const auto delay = scheduler.renewalDelay(1800);
+            QVERIFY(delay >= 1566000);
+            QVERIFY(delay <= 1740000);
+        }
+    }
+
+    void invalidParameters()
+    {
+        UpnpEventSubscriptionScheduler scheduler;
+
+        scheduler.setRenewalMargin(-1);
+        QCOMPARE(scheduler.renewalMargin(), 60);
+
+        scheduler.setJitter(101);
+        QCOMPARE(scheduler.jitter(), 10);
+    }
+
+    void callbacksInOrder()
+    {
+        UpnpEventSubscriptionScheduler scheduler;
+        QObject receiver;
+        QList<int> calls;
+
+        QElapsedTimer clock;
+        clock.start();
+
+        scheduler.schedule(1500, &receiver, [&calls]() {
+            calls.push_back(2);
+        });
+        scheduler.schedule(10, &receiver, [&calls]() {
+            calls.push_back(1);
+        });
+        QCOMPARE(scheduler.scheduledRenewals(), 2);
+
+        QTRY_COMPARE(calls, QList<int>({1}));
+        QTRY_COMPARE(calls, QList<int>({1, 2}));
+        QCOMPARE(scheduler.scheduledRenewals(), 0);
+
+        // the renewals are due on the ticks of one second of the scheduler
+        QVERIFY(clock.elapsed() >= 1000);
+    }
+
+    void cancelledRenewal()
+    {
+        UpnpEventSubscriptionScheduler scheduler;
+        QObject receiver;
+        auto cancelledCalls = 0;
+        auto calls = 0;
+
+        const auto renewalId = scheduler.schedule(10, &receiver, [&cancelledCalls]() {
+            ++cancelledCalls;
+        });
+        scheduler.schedule(20, &receiver, [&calls]() {
+            ++calls;
+        });
+
+        scheduler.cancel(renewalId);
+        QCOMPARE(scheduler.scheduledRenewals(), 1);
+
+        QTRY_COMPARE(calls, 1);
+        QCOMPARE(cancelledCalls, 0);
+    }
+
+    void destroyedReceiver()
+    {
+        UpnpEventSubscriptionScheduler scheduler;
+        auto receiver = std::make_unique<QObject>();
+        QObject otherReceiver;
+        auto destroyedCalls = 0;
+        auto calls = 0;
+
+        scheduler.schedule(10, receiver.get(), [&destroyedCalls]() {
+            ++destroyedCalls;
+        });
+        scheduler.schedule(10, &otherReceiver, [&calls]() {
+            ++calls;
+        });
+
+        receiver.reset();
+
+        QTRY_COMPARE(calls, 1);
+        QCOMPARE(destroyedCalls, 0);
+        QCOMPARE(scheduler.scheduledRenewals(), 0);
+    }
+
+    void scheduleFromCallback()
+    {
+        UpnpEventSubscriptionScheduler scheduler;
+        QObject receiver;
+        auto calls = 0;
+
+        scheduler.schedule(10, &receiver, [&scheduler, &receiver, &calls]() {
+            ++calls;
+            scheduler.schedule(10, &receiver, [&calls]() {
+                ++calls;
+            });
+        });
+
+        QTRY_COMPARE(calls, 2);
+        QCOMPARE(scheduler.scheduledRenewals(), 0);
+    }
+
+    void earlierRenewalAfterLaterOne()
+    {
+        UpnpEventSubscriptionScheduler scheduler;
+        QObject receiver;
+        auto laterCalls = 0;
+        auto calls = 0;
+
+        // the timer armed for the later renewal is armed again for the earlier one
+        scheduler.schedule(600000, &receiver, [&laterCalls]() {
+            ++laterCalls;
+        });
+        scheduler.schedule(10, &receiver, [&calls]() {
+            ++calls;
+        });
+
+        QTRY_COMPARE(calls, 1);
+        QCOMPARE(laterCalls, 0);
+        QCOMPARE(scheduler.scheduledRenewals(), 1);
+    }
+
+    void nextRenewalAfterCancelledOne()
+    {
+        UpnpEventSubscriptionScheduler scheduler;
+        QObject receiver;
+        auto cancelledCalls = 0;
+        auto calls = 0;
+
+        const auto renewalId = scheduler.schedule(10, &receiver, [&cancelledCalls]() {
+            ++cancelledCalls;
+        });
+        scheduler.schedule(1500, &receiver, [&calls]() {
+            ++calls;
+        });
+        scheduler.schedule(1500, &receiver, [&calls]() {
+            ++calls;
+        });
+
+        scheduler.cancel(renewalId);
+
+        // the wake up for the cancelled renewal arms the timer again for the ones found in a later slot of the wheel
+        QTRY_COMPARE(calls, 2);
+        QCOMPARE(cancelledCalls, 0);
+        QCOMPARE(scheduler.scheduledRenewals(), 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(EventSubscriptionSchedulerTest)
+
+#include "eventsubscriptionschedulertest.moc"
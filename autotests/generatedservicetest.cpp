@@ -0,0 +1,232 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "switchpowerproxy.h"
+#include "switchpowerskeleton.h"
+
+#include "upnpactionresult.h"
+#include "upnpcontrolabstractservicereply.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QObject>
+#include <QtCore/QPair>
+#include <QtCore/QString>
+#include <QtCore/QUrl>
+
+#include <QtNetwork/QHostAddress>
+#include <QtNetwork/QNetworkProxy>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+
+#include <QtTest/QtTest>
+
+#include <memory>
+
+/**
+ * @brief The RecordingControlServer class records the body of the SOAP requests it receives and never answers them
+ */
+class RecordingControlServer : public QTcpServer
+{
+public:
+    RecordingControlServer()
+    {
+        connect(this, &QTcpServer::newConnection, this, &RecordingControlServer::acceptConnections);
+        listen(QHostAddress::LocalHost);
+    }
+
+    [[nodiscard]] QUrl controlUrl() const
+    {
+        return QUrl(QStringLiteral("http://127.0.0.1:%1/SwitchPower/control").arg(serverPort()));
+    }
+
+    QList<QByteArray> mRequestBodies;
+
+private:
+    void acceptConnections()
+    {
+        while (auto *newSocket = nextPendingConnection()) {
+            auto buffer = std::make_shared<QByteArray>();
+
+            connect(newSocket, &QTcpSocket::readyRead, newSocket, [this, newSocket, buffer]() {
+                *buffer += newSocket->readAll();
+
+                const auto headersEnd = buffer->indexOf("\r\n\r\n");
+                if (headersEnd < 0) {
+                    return;
+                }
+
+                qsizetype bodySize = 0;
+                const auto lengthStart = buffer->toLower().indexOf("content-length:");
+                if (lengthStart >= 0 && lengthStart < headersEnd) {
+                    const auto lengthEnd = buffer->indexOf("\r\n", lengthStart);
+                    bodySize = buffer->mid(lengthStart + 15, lengthEnd - lengthStart - 15).trimmed().toLongLong();
+                }
+
+                if (buffer->size() < headersEnd + 4 + bodySize) {
+                    return;
+                }
+
+                mRequestBodies.push_back(buffer->mid(headersEnd + 4, bodySize));
+                buffer->remove(0, headersEnd + 4 + bodySize);
+            });
+        }
+    }
+};
+
+class SwitchPowerService : public SwitchPowerSkeleton
+{
+public:
+    bool mTarget = false;
+
+    QString mName;
+
+    quint32 mLevel = 0;
+
+protected:
+    bool setTarget(bool newTargetValue) override
+    {
+        mTarget = newTargetValue;
+
+        return true;
+    }
+
+    bool getTarget(bool &retTargetValue) override
+    {
+        retTargetValue = mTarget;
+
+        return true;
+    }
+
+    bool getStatus(bool &resultStatus) override
+    {
+        resultStatus = mTarget;
+
+        return true;
+    }
+
+    bool setName(const QString &newName, quint32 newLevel, QString &previousName) override
+    {
+        if (newName.isEmpty()) {
+            return false;
+        }
+
+        previousName = mName;
+        mName = newName;
+        mLevel = newLevel;
+
+        return true;
+    }
+};
+
+class GeneratedServiceTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void initTestCase()
+    {
+        QNetworkProxy::setApplicationProxy(QNetworkProxy::NoProxy);
+    }
+
+    void skeletonDescription()
+    {
+        SwitchPowerService service;
+
+        QCOMPARE(service.description().serviceType(), QStringLiteral("urn:schemas-upnp-org:service:SwitchPower:1"));
+        QCOMPARE(service.description().actions().size(), qsizetype(4));
+        QCOMPARE(service.description().stateVariables().size(), qsizetype(4));
+    }
+
+    void skeletonDispatch()
+    {
+        SwitchPowerService service;
+        QList<QPair<QString, QString>> outputArguments;
+
+        QVERIFY(service.dispatchAction(QStringLiteral("SetTarget"), {{QStringLiteral("newTargetValue"), QStringLiteral("true")}}, outputArguments));
+        QVERIFY(service.mTarget);
+        QVERIFY(outputArguments.isEmpty());
+
+        QVERIFY(service.dispatchAction(QStringLiteral("GetTarget"), {}, outputArguments));
+        QCOMPARE(outputArguments, (QList<QPair<QString, QString>>{{QStringLiteral("RetTargetValue"), QStringLiteral("1")}}));
+
+        outputArguments.clear();
+        QVERIFY(service.dispatchAction(QStringLiteral("SetName"),
+                                       {{QStringLiteral("NewName"), QStringLiteral("kitchen")}, {QStringLiteral("NewLevel"), QStringLiteral("42")}},
+                                       outputArguments));
+        QCOMPARE(service.mName, QStringLiteral("kitchen"));
+        QCOMPARE(service.mLevel, quint32(42));
+        QCOMPARE(outputArguments, (QList<QPair<QString, QString>>{{QStringLiteral("PreviousName"), QString()}}));
+    }
+
+    void skeletonInvalidCalls()
+    {
+        SwitchPowerService service;
+        QList<QPair<QString, QString>> outputArguments;
+
+        QVERIFY(!service.dispatchAction(QStringLiteral("Unknown"), {}, outputArguments));
+        QVERIFY(!service.dispatchAction(QStringLiteral("SetTarget"), {}, outputArguments));
+        QVERIFY(!service.dispatchAction(QStringLiteral("SetTarget"), {{QStringLiteral("Target"), QStringLiteral("1")}}, outputArguments));
+        QVERIFY(!service.dispatchAction(QStringLiteral("SetName"),
+                                        {{QStringLiteral("NewName"), QString()}, {QStringLiteral("NewLevel"), QStringLiteral("1")}},
+                                        outputArguments));
+        QVERIFY(outputArguments.isEmpty());
+    }
+
+    void proxyResult()
+    {
+        UpnpControlAbstractServiceReply reply;
+
+        auto answer = UpnpActionResult{};
+        answer.mSuccess = true;
+        answer.mValues[QStringLiteral("RetTargetValue")] = QStringLiteral("1");
+        reply.finish(answer);
+
+        const auto result = SwitchPowerProxy::getTargetResult(&reply);
+        QVERIFY(result.mSuccess);
+        QVERIFY(result.mRetTargetValue);
+    }
+
+    void proxyError()
+    {
+        UpnpControlAbstractServiceReply reply;
+
+        reply.finishWithError(QStringLiteral("Invalid Action"));
+
+        const auto result = SwitchPowerProxy::setNameResult(&reply);
+        QVERIFY(!result.mSuccess);
+        QCOMPARE(result.mError, QStringLiteral("Invalid Action"));
+        QVERIFY(result.mPreviousName.isEmpty());
+    }
+
+    void proxyEmptyArguments()
+    {
+        RecordingControlServer server;
+
+        SwitchPowerProxy proxy;
+        proxy.description().setSCPDURL(QUrl::fromLocalFile(QFINDTESTDATA("data/switchpower.xml")));
+        proxy.description().setControlURL(server.controlUrl());
+        QVERIFY(!proxy.isServiceDescriptionLoaded());
+
+        // the first call waits for the service description, the second one uses the resolved action index
+        std::unique_ptr<UpnpControlAbstractServiceReply> firstReply(proxy.setName(QString(), 1));
+        QTRY_VERIFY(proxy.isServiceDescriptionLoaded());
+        std::unique_ptr<UpnpControlAbstractServiceReply> secondReply(proxy.setName(QString(), 2));
+
+        QTRY_COMPARE(server.mRequestBodies.size(), qsizetype(2));
+
+        for (const auto &oneBody : std::as_const(server.mRequestBodies)) {
+            QVERIFY(oneBody.contains("NewName"));
+            QVERIFY(oneBody.contains("NewLevel"));
+            QVERIFY(oneBody.indexOf("NewName") < oneBody.indexOf("NewLevel"));
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(GeneratedServiceTest)
+
+#include "generatedservicetest.moc"
@@ -0,0 +1,166 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpcontrolabstractservice.h"
+#include "upnphttpserver.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QUrl>
+#include <QtCore/QVariant>
+
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkProxy>
+#include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QNetworkRequest>
+
+#include <QtTest/QtTest>
+
+#include <memory>
+
+class HttpServerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void initTestCase()
+    {
+        mNetwork.setProxy(QNetworkProxy::NoProxy);
+    }
+
+    void routeByPath()
+    {
+        UpnpHttpServer server;
+        UpnpControlAbstractService firstService;
+        UpnpControlAbstractService secondService;
+
+        const auto &firstPath = server.registerService(&firstService);
+        const auto &secondPath = server.registerService(&secondService);
+        QVERIFY(firstPath != secondPath);
+        QVERIFY(server.isListening());
+        QCOMPARE(server.registeredServicesCount(), 2);
+
+        QCOMPARE(server.service(QString(), firstPath), &firstService);
+        QCOMPARE(server.service(QStringLiteral("uuid:unknown"), secondPath), &secondService);
+        QVERIFY(!server.service(QString(), QStringLiteral("/event/unknown")));
+        const QString portAndPath = QLatin1Char(':') + QString::number(server.serverPort()) + firstPath;
+        QVERIFY(server.callbackUrl(firstPath).endsWith(portAndPath));
+
+        server.unregisterService(firstPath);
+        QVERIFY(!server.service(QString(), firstPath));
+        QCOMPARE(server.registeredServicesCount(), 1);
+    }
+
+    void routeBySubscriptionId()
+    {
+        UpnpHttpServer server;
+        UpnpControlAbstractService firstService;
+        UpnpControlAbstractService secondService;
+
+        const auto &firstPath = server.registerService(&firstService);
+        const auto &secondPath = server.registerService(&secondService);
+
+        server.setSubscriptionId(firstPath, QStringLiteral("uuid:first"));
+
+        // the SID wins over the path of the request
+        QCOMPARE(server.service(QStringLiteral("uuid:first"), secondPath), &firstService);
+        QCOMPARE(server.service(QStringLiteral("uuid:first"), QStringLiteral("/event/unknown")), &firstService);
+
+        // a renewed subscription replaces the previous SID
+        server.setSubscriptionId(firstPath, QStringLiteral("uuid:renewed"));
+        QCOMPARE(server.service(QStringLiteral("uuid:renewed"), QString()), &firstService);
+        QVERIFY(!server.service(QStringLiteral("uuid:first"), QString()));
+
+        // unknown paths cannot take a SID
+        server.setSubscriptionId(QStringLiteral("/event/unknown"), QStringLiteral("uuid:other"));
+        QVERIFY(!server.service(QStringLiteral("uuid:other"), QString()));
+
+        server.unregisterService(firstPath);
+        QVERIFY(!server.service(QStringLiteral("uuid:renewed"), QString()));
+    }
+
+    void destroyedService()
+    {
+        UpnpHttpServer server;
+        auto service = std::make_unique<UpnpControlAbstractService>();
+
+        const auto &callbackPath = server.registerService(service.get());
+        server.setSubscriptionId(callbackPath, QStringLiteral("uuid:destroyed"));
+
+        service.reset();
+        QVERIFY(!server.service(QStringLiteral("uuid:destroyed"), callbackPath));
+    }
+
+    void notifications()
+    {
+        UpnpHttpServer server;
+        UpnpControlAbstractService firstService;
+        UpnpControlAbstractService secondService;
+
+        const auto &firstPath = server.registerService(&firstService);
+        const auto &secondPath = server.registerService(&secondService);
+        server.setSubscriptionId(secondPath, QStringLiteral("uuid:second"));
+
+        QSignalSpy firstSpy(&firstService, &UpnpControlAbstractService::eventNotificationProcessed);
+        QSignalSpy secondSpy(&secondService, &UpnpControlAbstractService::eventNotificationProcessed);
+
+        QCOMPARE(notify(server, firstPath, QByteArray(), QStringLiteral("1")), 200);
+        QCOMPARE(firstSpy.count(), 1);
+        QCOMPARE(firstService.stateVariableValue(QStringLiteral("Status")), QVariant(QStringLiteral("1")));
+
+        // routed by SID even if the path is the one of another service
+        QCOMPARE(notify(server, firstPath, "uuid:second", QStringLiteral("0")), 200);
+        QCOMPARE(firstSpy.count(), 1);
+        QCOMPARE(secondSpy.count(), 1);
+        QCOMPARE(secondService.stateVariableValue(QStringLiteral("Status")), QVariant(QStringLiteral("0")));
+
+        QCOMPARE(notify(server, QStringLiteral("/event/unknown"), "uuid:unknown", QStringLiteral("1")), 412);
+        QCOMPARE(firstSpy.count(), 1);
+        QCOMPARE(secondSpy.count(), 1);
+
+        server.unregisterService(firstPath);
+        QCOMPARE(notify(server, firstPath, QByteArray(), QStringLiteral("1")), 412);
+    }
+
+private:
+    /**
+     * @brief notify will send a GENA NOTIFY request changing the Status state variable and return the HTTP status
+     */
+    int notify(const UpnpHttpServer &server, const QString &callbackPath, const QByteArray &subscriptionId, const QString &status)
+    {
+        QNetworkRequest notifyRequest(QUrl(QStringLiteral("http://127.0.0.1:%1%2").arg(server.serverPort()).arg(callbackPath)));
+        notifyRequest.setHeader(QNetworkRequest::ContentTypeHeader, QByteArrayLiteral("text/xml; charset=\"utf-8\""));
+        notifyRequest.setRawHeader("NT", "upnp:event");
+        notifyRequest.setRawHeader("NTS", "upnp:propchange");
+        if (!subscriptionId.isEmpty()) {
+            notifyRequest.setRawHeader("SID", subscriptionId);
+        }
+
+        const auto content = QStringLiteral("<?xml version=\"1.0\"?>"
+                                            "<e:propertyset xmlns:e=\"urn:schemas-upnp-org:event-1-0\">"
+                                            "<e:property><Status>%1</Status></e:property>"
+                                            "</e:propertyset>")
+                                 .arg(status)
+                                 .toUtf8();
+
+        std::unique_ptr<QNetworkReply> reply(mNetwork.sendCustomRequest(notifyRequest, "NOTIFY", content));
+
+        QSignalSpy finishedSpy(reply.get(), &QNetworkReply::finished);
+        if (!finishedSpy.wait(5000)) {
+            return -1;
+        }
+
+        return reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    }
+
+    QNetworkAccessManager mNetwork;
+};
+
+QTEST_GUILESS_MAIN(HttpServerTest)
+
+#include "httpservertest.moc"
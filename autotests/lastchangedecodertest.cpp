@@ -0,0 +1,120 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnplastchangedecoder.h"
+
+#include <QtCore/QList>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+#include <QtTest/QtTest>
+
+#include <algorithm>
+
+class LastChangeDecoderTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void decodeChanges()
+    {
+        auto lastChange = QStringLiteral("<Event xmlns=\"urn:schemas-upnp-org:metadata-1-0/RCS/\">"
+                                         "<InstanceID val=\"0\"><Volume channel=\"Master\" val=\"24\"/><Mute channel=\"Master\" val=\"0\"/></InstanceID>"
+                                         "</Event>");
+
+        UpnpLastChangeDecoder decoder;
+        QVERIFY(decoder.decode(lastChange, recorder()));
+        QCOMPARE(mChanges, QList<QString>({QStringLiteral("0 Volume Master 24"), QStringLiteral("0 Mute Master 0")}));
+
+        // the same document does not report anything
+        mChanges.clear();
+        QVERIFY(decoder.decode(lastChange, recorder()));
+        QVERIFY(mChanges.isEmpty());
+
+        lastChange.replace(QStringLiteral("val=\"24\""), QStringLiteral("val=\"25\""));
+        QVERIFY(decoder.decode(lastChange, recorder()));
+        QCOMPARE(mChanges, QList<QString>({QStringLiteral("0 Volume Master 25")}));
+        QCOMPARE(decoder.value(0, QStringLiteral("Volume"), QStringLiteral("Master")), QStringLiteral("25"));
+        QCOMPARE(decoder.value(0, QStringLiteral("Mute"), QStringLiteral("Master")), QStringLiteral("0"));
+    }
+
+    void decodeChannelsAndInstances()
+    {
+        UpnpLastChangeDecoder decoder;
+        QVERIFY(decoder.decode(QStringLiteral("<Event>"
+                                              "<InstanceID val=\"0\"><TransportState val=\"PLAYING\"/>"
+                                              "<Volume channel=\"LF\" val=\"10\"/><Volume channel=\"RF\" val=\"12\"/></InstanceID>"
+                                              "<InstanceID val=\"3\"><TransportState val=\"STOPPED\"/></InstanceID>"
+                                              "<InstanceID val=\"invalid\"><TransportState val=\"PAUSED_PLAYBACK\"/></InstanceID>"
+                                              "</Event>"),
+                               recorder()));
+
+        QCOMPARE(mChanges,
+                 QList<QString>({QStringLiteral("0 TransportState  PLAYING"),
+                                 QStringLiteral("0 Volume LF 10"),
+                                 QStringLiteral("0 Volume RF 12"),
+                                 QStringLiteral("3 TransportState  STOPPED")}));
+
+        auto instanceIds = decoder.instanceIds();
+        std::sort(instanceIds.begin(), instanceIds.end());
+        QCOMPARE(instanceIds, QList<quint32>({0, 3}));
+
+        QCOMPARE(decoder.value(0, QStringLiteral("TransportState")), QStringLiteral("PLAYING"));
+        QCOMPARE(decoder.value(3, QStringLiteral("TransportState")), QStringLiteral("STOPPED"));
+        QCOMPARE(decoder.value(0, QStringLiteral("Volume"), QStringLiteral("RF")), QStringLiteral("12"));
+        QVERIFY(decoder.value(0, QStringLiteral("Volume")).isNull());
+        QVERIFY(decoder.value(5, QStringLiteral("TransportState")).isNull());
+    }
+
+    void decodeAfterClear()
+    {
+        const auto lastChange = QStringLiteral("<Event><InstanceID val=\"0\"><TransportState val=\"PLAYING\"/></InstanceID></Event>");
+
+        UpnpLastChangeDecoder decoder;
+        QVERIFY(decoder.decode(lastChange, recorder()));
+
+        decoder.clear();
+        QVERIFY(decoder.instanceIds().isEmpty());
+
+        mChanges.clear();
+        QVERIFY(decoder.decode(lastChange, recorder()));
+        QCOMPARE(mChanges, QList<QString>({QStringLiteral("0 TransportState  PLAYING")}));
+    }
+
+    void decodeInvalidDocument()
+    {
+        UpnpLastChangeDecoder decoder;
+
+        QVERIFY(!decoder.decode(QStringLiteral("<Other/>"), recorder()));
+        QVERIFY(!decoder.errorString().isEmpty());
+
+        // the changes read before the error are reported and kept
+        QVERIFY(!decoder.decode(QStringLiteral("<Event><InstanceID val=\"0\"><Mute val=\"1\"/>"), recorder()));
+        QVERIFY(!decoder.errorString().isEmpty());
+        QCOMPARE(mChanges, QList<QString>({QStringLiteral("0 Mute  1")}));
+        QCOMPARE(decoder.value(0, QStringLiteral("Mute")), QStringLiteral("1"));
+    }
+
+    void init()
+    {
+        mChanges.clear();
+    }
+
+private:
+    UpnpLastChangeDecoder::ChangeHandler recorder()
+    {
+        return [this](quint32 instanceId, QStringView name, QStringView channel, QStringView value) {
+            mChanges.push_back(QStringLiteral("%1 %2 %3 %4").arg(instanceId).arg(name.toString(), channel.toString(), value.toString()));
+        };
+    }
+
+    QList<QString> mChanges;
+};
+
+QTEST_GUILESS_MAIN(LastChangeDecoderTest)
+
+#include "lastchangedecodertest.moc"
@@ -0,0 +1,131 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpabstractdevice.h"
+#include "upnpdevicedescription.h"
+#include "upnpdeviceroutetable.h"
+#include "upnpservicedescription.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+#include <QtTest/QtTest>
+
+#include <memory>
+#include <vector>
+
+class RouteTableBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void initTestCase()
+    {
+        for (int deviceIndex = 0; deviceIndex < DevicesCount; ++deviceIndex) {
+            auto newDescription = UpnpDeviceDescription{};
+            newDescription.setUDN(QStringLiteral("device-") + QString::number(deviceIndex));
+            for (int serviceIndex = 0; serviceIndex < ServicesCount; ++serviceIndex) {
+                newDescription.services().push_back(UpnpServiceDescription{});
+            }
+
+            auto newDevice = std::make_unique<UpnpAbstractDevice>();
+            newDevice->setDescription(newDescription);
+
+            mRoutes.addDevice(deviceIndex, newDevice.get());
+            mDevices.push_back(std::move(newDevice));
+
+            const QString devicePrefix = QLatin1Char('/') + QString::number(deviceIndex) + QLatin1Char('/');
+            mPaths.push_back(devicePrefix + QStringLiteral("device.xml"));
+            for (int serviceIndex = 0; serviceIndex < ServicesCount; ++serviceIndex) {
+                mPaths.push_back(devicePrefix + QString::number(serviceIndex) + QStringLiteral("/control"));
+                mPaths.push_back(devicePrefix + QString::number(serviceIndex) + QStringLiteral("/event"));
+            }
+        }
+
+        for (const auto &onePath : std::as_const(mPaths)) {
+            mRawPaths.push_back(onePath.toLatin1());
+        }
+    }
+
+    void benchmarkRouteTable()
+    {
+        int validRoutes = 0;
+
+        QBENCHMARK {
+            validRoutes = 0;
+            for (const auto &onePath : std::as_const(mPaths)) {
+                if (mRoutes.route(onePath).isValid()) {
+                    ++validRoutes;
+                }
+            }
+        }
+
+        QCOMPARE(validRoutes, static_cast<int>(mPaths.size()));
+    }
+
+    void benchmarkRouteTableRawPaths()
+    {
+        int validRoutes = 0;
+
+        QBENCHMARK {
+            validRoutes = 0;
+            for (const auto &onePath : std::as_const(mRawPaths)) {
+                if (mRoutes.route(onePath).isValid()) {
+                    ++validRoutes;
+                }
+            }
+        }
+
+        QCOMPARE(validRoutes, static_cast<int>(mRawPaths.size()));
+    }
+
+    void benchmarkSplitPaths()
+    {
+        // the routing used before the route table
+        int validRoutes = 0;
+
+        QBENCHMARK {
+            validRoutes = 0;
+            for (const auto &onePath : std::as_const(mPaths)) {
+                const QList<QString> &pathParts = onePath.split(QStringLiteral("/"));
+                const int deviceIndex = pathParts[1].toInt();
+                if (deviceIndex < 0 || deviceIndex >= static_cast<int>(mDevices.size())) {
+                    continue;
+                }
+
+                if (pathParts.count() == 3 && pathParts.last() == QStringLiteral("device.xml")) {
+                    ++validRoutes;
+                } else if (pathParts.count() == 4 && (pathParts.last() == QStringLiteral("control") || pathParts.last() == QStringLiteral("event"))) {
+                    const int serviceIndex = pathParts[2].toInt();
+                    if (serviceIndex >= 0 && serviceIndex < mDevices[deviceIndex]->services().count()) {
+                        ++validRoutes;
+                    }
+                }
+            }
+        }
+
+        QCOMPARE(validRoutes, static_cast<int>(mPaths.size()));
+    }
+
+private:
+    static constexpr int DevicesCount = 1000;
+
+    static constexpr int ServicesCount = 3;
+
+    std::vector<std::unique_ptr<UpnpAbstractDevice>> mDevices;
+
+    UpnpDeviceRouteTable mRoutes;
+
+    QList<QString> mPaths;
+
+    QList<QByteArray> mRawPaths;
+};
+
+QTEST_GUILESS_MAIN(RouteTableBenchmark)
+
+#include "routetablebenchmark.moc"
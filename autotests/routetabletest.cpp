@@ -0,0 +1,171 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpabstractdevice.h"
+#include "upnpdevicedescription.h"
+#include "upnpdeviceroutetable.h"
+#include "upnpservicedescription.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+#include <QtTest/QtTest>
+
+#include <memory>
+
+class RouteTableTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void routeKinds()
+    {
+        const auto device = newDevice(2);
+
+        UpnpDeviceRouteTable routes;
+        routes.addDevice(7, device.get());
+
+        QCOMPARE(routes.size(), 1 + 3 * 2);
+
+        const auto &deviceRoute = routes.route(QStringLiteral("/7/device.xml"));
+        QCOMPARE(deviceRoute.mKind, UpnpRouteKind::DeviceDescription);
+        QCOMPARE(deviceRoute.mDeviceId, 7);
+        QCOMPARE(deviceRoute.mServiceIndex, -1);
+        QCOMPARE(deviceRoute.mDocument, device->xmlDescription());
+
+        // the services of the test device have no object and no document
+        const auto &serviceRoute = routes.route(QStringLiteral("/7/1/service.xml"));
+        QCOMPARE(serviceRoute.mKind, UpnpRouteKind::ServiceDescription);
+        QCOMPARE(serviceRoute.mServiceIndex, 1);
+        QVERIFY(serviceRoute.mDocument.isNull());
+
+        const auto &controlRoute = routes.route(QStringLiteral("/7/0/control"));
+        QCOMPARE(controlRoute.mKind, UpnpRouteKind::Control);
+        QCOMPARE(controlRoute.mServiceIndex, 0);
+        QVERIFY(controlRoute.mDocument.isNull());
+
+        const auto &eventRoute = routes.route(QStringLiteral("/7/1/event"));
+        QCOMPARE(eventRoute.mKind, UpnpRouteKind::Event);
+        QCOMPARE(eventRoute.mServiceIndex, 1);
+    }
+
+    void rawPaths()
+    {
+        const auto device = newDevice(1);
+
+        UpnpDeviceRouteTable routes;
+        routes.addDevice(3, device.get());
+
+        for (const auto &onePath : {QStringLiteral("/3/device.xml"), QStringLiteral("/3/0/service.xml"), QStringLiteral("/3/0/control"), QStringLiteral("/3/0/event")}) {
+            const auto &route = routes.route(onePath);
+            const auto &rawRoute = routes.route(onePath.toLatin1());
+
+            QVERIFY(rawRoute.isValid());
+            QCOMPARE(rawRoute.mKind, route.mKind);
+            QCOMPARE(rawRoute.mDeviceId, route.mDeviceId);
+            QCOMPARE(rawRoute.mServiceIndex, route.mServiceIndex);
+        }
+    }
+
+    void invalidPaths()
+    {
+        const auto device = newDevice(1);
+
+        UpnpDeviceRouteTable routes;
+        routes.addDevice(0, device.get());
+
+        QVERIFY(!routes.route(QStringLiteral("/1/device.xml")).isValid());
+        QVERIFY(!routes.route(QStringLiteral("/0/1/control")).isValid());
+        QVERIFY(!routes.route(QStringLiteral("/0/0/unknown")).isValid());
+        QVERIFY(!routes.route(QStringLiteral("/0/device.xml/")).isValid());
+        QVERIFY(!routes.route(QStringLiteral("0/device.xml")).isValid());
+        QVERIFY(!routes.route(QString()).isValid());
+        QVERIFY(!routes.route(QByteArrayLiteral("/00/device.xml")).isValid());
+        QCOMPARE(routes.route(QStringLiteral("/1/device.xml")).mKind, UpnpRouteKind::Invalid);
+    }
+
+    void removeDeviceKeepsOtherRoutes()
+    {
+        const auto firstDevice = newDevice(3);
+        const auto secondDevice = newDevice(3);
+        const auto thirdDevice = newDevice(3);
+
+        UpnpDeviceRouteTable routes;
+        routes.addDevice(0, firstDevice.get());
+        routes.addDevice(1, secondDevice.get());
+        routes.addDevice(2, thirdDevice.get());
+
+        routes.removeDevice(1);
+
+        QCOMPARE(routes.size(), 2 * (1 + 3 * 3));
+        QVERIFY(!routes.route(QStringLiteral("/1/device.xml")).isValid());
+        QVERIFY(!routes.route(QByteArrayLiteral("/1/0/control")).isValid());
+
+        // the handles of the other devices, and so their paths, do not change
+        const auto &nextDeviceRoute = routes.route(QStringLiteral("/2/device.xml"));
+        QCOMPARE(nextDeviceRoute.mKind, UpnpRouteKind::DeviceDescription);
+        QCOMPARE(nextDeviceRoute.mDeviceId, 2);
+
+        const auto &lastServiceRoute = routes.route(QByteArrayLiteral("/2/2/event"));
+        QCOMPARE(lastServiceRoute.mDeviceId, 2);
+        QCOMPARE(lastServiceRoute.mServiceIndex, 2);
+
+        routes.removeDevice(42);
+        QCOMPARE(routes.size(), 2 * (1 + 3 * 3));
+    }
+
+    void addDeviceAgain()
+    {
+        const auto device = newDevice(3);
+
+        UpnpDeviceRouteTable routes;
+        routes.addDevice(5, device.get());
+
+        // the routes are computed again when the description of the device changes
+        auto newDescription = device->description();
+        newDescription.services().removeLast();
+        device->setDescription(newDescription);
+        routes.addDevice(5, device.get());
+
+        QCOMPARE(routes.size(), 1 + 3 * 2);
+        QVERIFY(routes.route(QStringLiteral("/5/1/control")).isValid());
+        QVERIFY(!routes.route(QStringLiteral("/5/2/control")).isValid());
+        QVERIFY(!routes.route(QByteArrayLiteral("/5/2/event")).isValid());
+    }
+
+    void clearRoutes()
+    {
+        const auto device = newDevice(1);
+
+        UpnpDeviceRouteTable routes;
+        routes.addDevice(0, device.get());
+        routes.clear();
+
+        QCOMPARE(routes.size(), 0);
+        QVERIFY(!routes.route(QStringLiteral("/0/device.xml")).isValid());
+        QVERIFY(!routes.route(QByteArrayLiteral("/0/device.xml")).isValid());
+    }
+
+private:
+    static std::unique_ptr<UpnpAbstractDevice> newDevice(int servicesCount)
+    {
+        auto newDescription = UpnpDeviceDescription{};
+        for (int serviceIndex = 0; serviceIndex < servicesCount; ++serviceIndex) {
+            newDescription.services().push_back(UpnpServiceDescription{});
+        }
+
+        auto result = std::make_unique<UpnpAbstractDevice>();
+        result->setDescription(newDescription);
+
+        return result;
+    }
+};
+
+QTEST_GUILESS_MAIN(RouteTableTest)
+
+#include "routetabletest.moc"
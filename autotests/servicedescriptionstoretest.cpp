@@ -0,0 +1,151 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpactiondescription.h"
+#include "upnpservicedescription.h"
+#include "upnpservicedescriptionstore.h"
+#include "upnpstatevariabledescription.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+#include <QtTest/QtTest>
+
+static UpnpServiceDescription parsedDescription(const QString &actionName)
+{
+    auto result = UpnpServiceDescription{};
+
+    auto newAction = UpnpActionDescription{};
+    newAction.mIsValid = true;
+    newAction.mName = actionName;
+    result.actions()[actionName] = newAction;
+
+    auto newStateVariable = UpnpStateVariableDescription{};
+    newStateVariable.mIsValid = true;
+    newStateVariable.mUpnpName = QStringLiteral("Status");
+    newStateVariable.mDataType = QStringLiteral("boolean");
+    newStateVariable.mType = UpnpStateVariableDescription::typeFromDataType(newStateVariable.mDataType);
+    result.stateVariables()[newStateVariable.mUpnpName] = newStateVariable;
+
+    return result;
+}
+
+class ServiceDescriptionStoreTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void init()
+    {
+        UpnpServiceDescriptionStore::clear();
+        UpnpServiceDescriptionStore::setMaximumSize(256);
+    }
+
+    void identicalDocumentsShareTables()
+    {
+        const auto &firstHash = UpnpServiceDescriptionStore::contentHash(QByteArrayLiteral("<scpd>GetStatus</scpd>"));
+        const auto &secondHash = UpnpServiceDescriptionStore::contentHash(QByteArrayLiteral("<scpd>GetStatus</scpd>"));
+        QCOMPARE(firstHash, secondHash);
+
+        auto firstDescription = parsedDescription(QStringLiteral("GetStatus"));
+        UpnpServiceDescriptionStore::insert(firstHash, firstDescription);
+        QCOMPARE(firstDescription.SCPDHash(), firstHash);
+        QCOMPARE(UpnpServiceDescriptionStore::size(), 1);
+
+        auto secondDescription = UpnpServiceDescription{};
+        QVERIFY(UpnpServiceDescriptionStore::find(secondHash, secondDescription));
+        QCOMPARE(secondDescription.SCPDHash(), firstHash);
+        QVERIFY(secondDescription.actions().isSharedWith(firstDescription.actions()));
+        QVERIFY(secondDescription.stateVariables().isSharedWith(firstDescription.stateVariables()));
+
+        // a description parsed again by another thread is replaced by the stored one
+        auto thirdDescription = parsedDescription(QStringLiteral("GetStatus"));
+        QVERIFY(!thirdDescription.actions().isSharedWith(firstDescription.actions()));
+        UpnpServiceDescriptionStore::insert(secondHash, thirdDescription);
+        QVERIFY(thirdDescription.actions().isSharedWith(firstDescription.actions()));
+        QCOMPARE(UpnpServiceDescriptionStore::size(), 1);
+    }
+
+    void differentDocumentsDoNotShare()
+    {
+        const auto &firstHash = UpnpServiceDescriptionStore::contentHash(QByteArrayLiteral("<scpd>GetStatus</scpd>"));
+        const auto &secondHash = UpnpServiceDescriptionStore::contentHash(QByteArrayLiteral("<scpd>GetTarget</scpd>"));
+        QVERIFY(firstHash != secondHash);
+
+        auto firstDescription = parsedDescription(QStringLiteral("GetStatus"));
+        UpnpServiceDescriptionStore::insert(firstHash, firstDescription);
+
+        auto secondDescription = parsedDescription(QStringLiteral("GetTarget"));
+        UpnpServiceDescriptionStore::insert(secondHash, secondDescription);
+        QCOMPARE(UpnpServiceDescriptionStore::size(), 2);
+
+        auto foundDescription = UpnpServiceDescription{};
+        QVERIFY(UpnpServiceDescriptionStore::find(secondHash, foundDescription));
+        QVERIFY(foundDescription.actions().isSharedWith(secondDescription.actions()));
+        QVERIFY(!foundDescription.actions().isSharedWith(firstDescription.actions()));
+        QVERIFY(foundDescription.actions().contains(QStringLiteral("GetTarget")));
+    }
+
+    void hitAndMissCounters()
+    {
+        const auto hitCount = UpnpServiceDescriptionStore::hitCount();
+        const auto missCount = UpnpServiceDescriptionStore::missCount();
+
+        const auto &hash = UpnpServiceDescriptionStore::contentHash(QByteArrayLiteral("<scpd>GetStatus</scpd>"));
+        auto foundDescription = UpnpServiceDescription{};
+        QVERIFY(!UpnpServiceDescriptionStore::find(hash, foundDescription));
+        QCOMPARE(UpnpServiceDescriptionStore::hitCount(), hitCount);
+        QCOMPARE(UpnpServiceDescriptionStore::missCount(), missCount + 1);
+
+        auto newDescription = parsedDescription(QStringLiteral("GetStatus"));
+        UpnpServiceDescriptionStore::insert(hash, newDescription);
+
+        QVERIFY(UpnpServiceDescriptionStore::find(hash, foundDescription));
+        QVERIFY(UpnpServiceDescriptionStore::find(hash, foundDescription));
+        QCOMPARE(UpnpServiceDescriptionStore::hitCount(), hitCount + 2);
+        QCOMPARE(UpnpServiceDescriptionStore::missCount(), missCount + 1);
+    }
+
+    void leastRecentlyUsedEviction()
+    {
+        UpnpServiceDescriptionStore::setMaximumSize(2);
+        QCOMPARE(UpnpServiceDescriptionStore::maximumSize(), 2);
+
+        const auto &firstHash = UpnpServiceDescriptionStore::contentHash(QByteArrayLiteral("first"));
+        const auto &secondHash = UpnpServiceDescriptionStore::contentHash(QByteArrayLiteral("second"));
+        const auto &thirdHash = UpnpServiceDescriptionStore::contentHash(QByteArrayLiteral("third"));
+
+        auto firstDescription = parsedDescription(QStringLiteral("First"));
+        UpnpServiceDescriptionStore::insert(firstHash, firstDescription);
+        auto secondDescription = parsedDescription(QStringLiteral("Second"));
+        UpnpServiceDescriptionStore::insert(secondHash, secondDescription);
+
+        // the first document becomes the most recently used
+        auto foundDescription = UpnpServiceDescription{};
+        QVERIFY(UpnpServiceDescriptionStore::find(firstHash, foundDescription));
+
+        auto thirdDescription = parsedDescription(QStringLiteral("Third"));
+        UpnpServiceDescriptionStore::insert(thirdHash, thirdDescription);
+        QCOMPARE(UpnpServiceDescriptionStore::size(), 2);
+
+        QVERIFY(UpnpServiceDescriptionStore::find(firstHash, foundDescription));
+        QVERIFY(!UpnpServiceDescriptionStore::find(secondHash, foundDescription));
+        QVERIFY(UpnpServiceDescriptionStore::find(thirdHash, foundDescription));
+
+        // descriptions built from an evicted document keep their data
+        QVERIFY(secondDescription.actions().contains(QStringLiteral("Second")));
+
+        UpnpServiceDescriptionStore::setMaximumSize(1);
+        QCOMPARE(UpnpServiceDescriptionStore::size(), 1);
+        QVERIFY(UpnpServiceDescriptionStore::find(thirdHash, foundDescription));
+    }
+};
+
+QTEST_GUILESS_MAIN(ServiceDescriptionStoreTest)
+
+#include "servicedescriptionstoretest.moc"
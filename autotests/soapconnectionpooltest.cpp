@@ -0,0 +1,306 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpactionresult.h"
+#include "upnpsoapconnectionpool.h"
+
+#include <KDSoapClient/KDSoapMessage.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QString>
+#include <QtCore/QUrl>
+
+#include <QtNetwork/QHostAddress>
+#include <QtNetwork/QNetworkProxy>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+
+#include <QtTest/QtTest>
+
+/**
+ * @brief The HeldSoapServer class keeps the received SOAP requests until answerRequests is called
+ */
+class HeldSoapServer : public QTcpServer
+{
+public:
+    HeldSoapServer()
+    {
+        connect(this, &QTcpServer::newConnection, this, &HeldSoapServer::acceptConnections);
+        listen(QHostAddress::LocalHost);
+    }
+
+    [[nodiscard]] QUrl controlUrl() const
+    {
+        return QUrl(QStringLiteral("http://127.0.0.1:%1/SwitchPower/control").arg(serverPort()));
+    }
+
+    /**
+     * @brief answerRequests will answer the oldest count requests waiting for an answer
+     */
+    void answerRequests(int count)
+    {
+        const QByteArray answerBody =
+            "<?xml version=\"1.0\"?>"
+            "<s:Envelope xmlns:s=\"http://schemas.xmlsoap.org/soap/envelope/\" s:encodingStyle=\"http://schemas.xmlsoap.org/soap/encoding/\">"
+            "<s:Body><u:GetStatusResponse xmlns:u=\"urn:schemas-upnp-org:service:SwitchPower:1\"><ResultStatus>1</ResultStatus></u:GetStatusResponse></s:Body>"
+            "</s:Envelope>";
+
+        for (int i = 0; i < count && !mWaitingSockets.isEmpty(); ++i) {
+            auto oneSocket = mWaitingSockets.takeFirst();
+            if (!oneSocket) {
+                continue;
+            }
+
+            QByteArray answer("HTTP/1.1 200 OK\r\nContent-Type: text/xml; charset=\"utf-8\"\r\nContent-Length: ");
+            answer += QByteArray::number(answerBody.size());
+            answer += "\r\n\r\n";
+            answer += answerBody;
+
+            oneSocket->write(answer);
+        }
+    }
+
+    [[nodiscard]] int waitingRequests() const
+    {
+        return static_cast<int>(mWaitingSockets.size());
+    }
+
+    int mReceivedRequests = 0;
+
+    int mOpenedConnections = 0;
+
+    int mClosedConnections = 0;
+
+private:
+    void acceptConnections()
+    {
+        while (auto *newSocket = nextPendingConnection()) {
+            ++mOpenedConnections;
+
+            connect(newSocket, &QTcpSocket::disconnected, this, [this, newSocket]() {
+                ++mClosedConnections;
+                mBuffers.remove(newSocket);
+                newSocket->deleteLater();
+            });
+
+            connect(newSocket, &QTcpSocket::readyRead, this, [this, newSocket]() {
+                auto &buffer = mBuffers[newSocket];
+                buffer += newSocket->readAll();
+
+                // one request is the headers and a body of Content-Length bytes
+                while (true) {
+                    const auto headersEnd = buffer.indexOf("\r\n\r\n");
+                    if (headersEnd < 0) {
+                        return;
+                    }
+
+                    qsizetype bodySize = 0;
+                    const auto lengthStart = buffer.toLower().indexOf("content-length:");
+                    if (lengthStart >= 0 && lengthStart < headersEnd) {
+                        const auto lengthEnd = buffer.indexOf("\r\n", lengthStart);
+                        bodySize = buffer.mid(lengthStart + 15, lengthEnd - lengthStart - 15).trimmed().toLongLong();
+                    }
+
+                    if (buffer.size() < headersEnd + 4 + bodySize) {
+                        return;
+                    }
+
+                    buffer.remove(0, headersEnd + 4 + bodySize);
+
+                    ++mReceivedRequests;
+                    mWaitingSockets.push_back(newSocket);
+                }
+            });
+        }
+    }
+
+    QHash<QTcpSocket *, QByteArray> mBuffers;
+
+    QList<QPointer<QTcpSocket>> mWaitingSockets;
+};
+
+class SoapConnectionPoolTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void initTestCase()
+    {
+        QNetworkProxy::setApplicationProxy(QNetworkProxy::NoProxy);
+    }
+
+    void init()
+    {
+        mResults.clear();
+    }
+
+    void perHostLimit()
+    {
+        HeldSoapServer server;
+        UpnpSoapConnectionPool pool;
+        QCOMPARE(pool.maximumConnectionsPerHost(), 2);
+
+        for (int i = 0; i < 5; ++i) {
+            sendGetStatus(pool, server);
+        }
+
+        QCOMPARE(pool.runningCalls(), 2);
+        QCOMPARE(pool.pendingCalls(), 3);
+        QCOMPARE(pool.openedHostsCount(), 1);
+        QTRY_COMPARE(server.waitingRequests(), 2);
+
+        // each answer lets one queued call start
+        server.answerRequests(1);
+        QTRY_COMPARE(mResults.size(), qsizetype(1));
+        QCOMPARE(pool.runningCalls(), 2);
+        QCOMPARE(pool.pendingCalls(), 2);
+        QTRY_COMPARE(server.waitingRequests(), 2);
+
+        server.answerRequests(2);
+        QTRY_COMPARE(mResults.size(), qsizetype(3));
+        QCOMPARE(pool.pendingCalls(), 0);
+
+        server.answerRequests(2);
+        QTRY_COMPARE(mResults.size(), qsizetype(5));
+        QCOMPARE(pool.runningCalls(), 0);
+        QCOMPARE(server.mReceivedRequests, 5);
+
+        for (const auto &oneResult : std::as_const(mResults)) {
+            QVERIFY(oneResult.mSuccess);
+            QCOMPARE(oneResult.mValues.value(QStringLiteral("ResultStatus")).toString(), QStringLiteral("1"));
+        }
+
+        // one client is created for the host and reused by the next calls
+        QCOMPARE(pool.totalCalls(), quint64(5));
+        QCOMPARE(pool.createdInterfaces(), quint64(1));
+        QCOMPARE(pool.reusedCalls(), quint64(4));
+        QCOMPARE(pool.reuseRate(), 0.8);
+    }
+
+    void abortPendingCall()
+    {
+        HeldSoapServer server;
+        UpnpSoapConnectionPool pool;
+
+        sendGetStatus(pool, server);
+        sendGetStatus(pool, server);
+        const auto abortedCall = sendGetStatus(pool, server);
+        QCOMPARE(pool.pendingCalls(), 1);
+
+        pool.abort(abortedCall);
+        QCOMPARE(pool.pendingCalls(), 0);
+        QCOMPARE(pool.runningCalls(), 2);
+        QCOMPARE(pool.abortedCalls(), quint64(1));
+
+        QTRY_COMPARE(server.waitingRequests(), 2);
+        server.answerRequests(2);
+        QTRY_COMPARE(mResults.size(), qsizetype(2));
+
+        // the aborted call is never sent and the client is kept
+        QTest::qWait(100);
+        QCOMPARE(server.mReceivedRequests, 2);
+        QCOMPARE(mResults.size(), qsizetype(2));
+        QCOMPARE(pool.openedHostsCount(), 1);
+    }
+
+    void abortRunningCall()
+    {
+        HeldSoapServer server;
+        UpnpSoapConnectionPool pool;
+
+        const auto abortedCall = sendGetStatus(pool, server);
+        sendGetStatus(pool, server);
+        sendGetStatus(pool, server);
+        QTRY_COMPARE(server.waitingRequests(), 2);
+
+        pool.abort(abortedCall);
+        QCOMPARE(pool.runningCalls(), 1);
+
+        // the aborted request keeps its connection busy until the other running call is finished
+        QCOMPARE(pool.pendingCalls(), 1);
+
+        server.answerRequests(2);
+        QTRY_COMPARE(mResults.size(), qsizetype(1));
+
+        // the third call is sent once the aborted request is answered or its client destroyed
+        QTRY_COMPARE(server.mReceivedRequests, 3);
+        QTRY_COMPARE(server.waitingRequests(), 1);
+        server.answerRequests(1);
+        QTRY_COMPARE(mResults.size(), qsizetype(2));
+
+        QTest::qWait(100);
+        QCOMPARE(mResults.size(), qsizetype(2));
+        QCOMPARE(pool.runningCalls(), 0);
+        QCOMPARE(pool.pendingCalls(), 0);
+    }
+
+    void idleConnectionsClosed()
+    {
+        HeldSoapServer server;
+        UpnpSoapConnectionPool pool;
+        pool.setIdleTimeout(200);
+
+        sendGetStatus(pool, server);
+        QTRY_COMPARE(server.waitingRequests(), 1);
+        server.answerRequests(1);
+        QTRY_COMPARE(mResults.size(), qsizetype(1));
+        QCOMPARE(pool.openedHostsCount(), 1);
+
+        QTRY_COMPARE_WITH_TIMEOUT(pool.openedHostsCount(), 0, 2000);
+        QTRY_COMPARE(server.mClosedConnections, server.mOpenedConnections);
+
+        // the next call creates a new client
+        sendGetStatus(pool, server);
+        QTRY_COMPARE(server.waitingRequests(), 1);
+        server.answerRequests(1);
+        QTRY_COMPARE(mResults.size(), qsizetype(2));
+        QCOMPARE(pool.createdInterfaces(), quint64(2));
+    }
+
+    void idleTimeoutDisabled()
+    {
+        HeldSoapServer server;
+        UpnpSoapConnectionPool pool;
+        pool.setIdleTimeout(0);
+        QCOMPARE(pool.idleTimeout(), 0);
+
+        sendGetStatus(pool, server);
+        QTRY_COMPARE(server.waitingRequests(), 1);
+        server.answerRequests(1);
+        QTRY_COMPARE(mResults.size(), qsizetype(1));
+
+        QTest::qWait(300);
+        QCOMPARE(pool.openedHostsCount(), 1);
+        QCOMPARE(server.mClosedConnections, 0);
+    }
+
+private:
+    quint64 sendGetStatus(UpnpSoapConnectionPool &pool, const HeldSoapServer &server)
+    {
+        auto completion = UpnpActionCompletion{};
+        completion.mFinished = [this](const UpnpActionResult &result) {
+            mResults.push_back(result);
+        };
+
+        return pool.call(completion,
+                         server.controlUrl(),
+                         QStringLiteral("urn:schemas-upnp-org:service:SwitchPower:1"),
+                         QStringLiteral("GetStatus"),
+                         KDSoapMessage{},
+                         QStringLiteral("urn:schemas-upnp-org:service:SwitchPower:1#GetStatus"));
+    }
+
+    QList<UpnpActionResult> mResults;
+};
+
+QTEST_GUILESS_MAIN(SoapConnectionPoolTest)
+
+#include "soapconnectionpooltest.moc"
@@ -0,0 +1,75 @@
+# SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+# SPDX-License-Identifier: BSD-2-Clause
+
+# upnplibqt_generate_proxy(<sources_var>
+#                          SCPD <scpd_file>
+#                          CLASS_NAME <class_name>
+#                          [SERVICE_TYPE <service_type>]
+#                          [OUTPUT_NAME <base_name>])
+#
+# Generates a typed client proxy deriving from UpnpControlAbstractService from
+# an UPnP service description (SCPD). The generated source file is appended to
+# <sources_var>. The files are written in the current binary directory and are
+# named after OUTPUT_NAME or, by default, the class name in lower case.
+#
+# upnplibqt_generate_skeleton(<sources_var>
+#                             SCPD <scpd_file>
+#                             CLASS_NAME <class_name>
+#                             [SERVICE_TYPE <service_type>]
+#                             [OUTPUT_NAME <base_name>])
+#
+# Generates an abstract server side service deriving from UpnpAbstractService
+# with one pure virtual method per action. It takes the same arguments as
+# upnplibqt_generate_proxy.
+
+function(_upnplibqt_generate _mode _sources)
+    set(options)
+    set(oneValueArgs SCPD CLASS_NAME SERVICE_TYPE OUTPUT_NAME)
+    set(multiValueArgs)
+    cmake_parse_arguments(ARG "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
+
+    if(NOT ARG_SCPD OR NOT ARG_CLASS_NAME)
+        message(FATAL_ERROR "upnplibqt_generate_${_mode} needs SCPD and CLASS_NAME")
+    endif()
+
+    if(NOT ARG_OUTPUT_NAME)
+        string(TOLOWER "${ARG_CLASS_NAME}" ARG_OUTPUT_NAME)
+    endif()
+
+    if(TARGET UPNP::upnpscpd2cpp)
+        set(_generator UPNP::upnpscpd2cpp)
+    else()
+        set(_generator upnpscpd2cpp)
+    endif()
+
+    get_filename_component(_scpd "${ARG_SCPD}" ABSOLUTE)
+    set(_output "${CMAKE_CURRENT_BINARY_DIR}/${ARG_OUTPUT_NAME}")
+
+    set(_serviceTypeArgs)
+    if(ARG_SERVICE_TYPE)
+        set(_serviceTypeArgs --service-type "${ARG_SERVICE_TYPE}")
+    endif()
+
+    add_custom_command(
+        OUTPUT "${_output}.h" "${_output}.cpp"
+        COMMAND ${_generator} --${_mode} --class "${ARG_CLASS_NAME}" ${_serviceTypeArgs} -o "${_output}" "${_scpd}"
+        DEPENDS "${_scpd}" ${_generator}
+        COMMENT "Generating UPnP ${_mode} ${ARG_CLASS_NAME} from ${ARG_SCPD}"
+        VERBATIM
+    )
+
+    set_source_files_properties("${_output}.h" "${_output}.cpp" PROPERTIES SKIP_AUTOMOC ON)
+
+    set(${_sources} ${${_sources}} "${_output}.h" "${_output}.cpp" PARENT_SCOPE)
+endfunction()
+
+function(upnplibqt_generate_proxy _sources)
+    _upnplibqt_generate(proxy _generatedSources ${ARGN})
+    set(${_sources} ${${_sources}} ${_generatedSources} PARENT_SCOPE)
+endfunction()
+
+function(upnplibqt_generate_skeleton _sources)
+    _upnplibqt_generate(skeleton _generatedSources ${ARGN})
+    set(${_sources} ${${_sources}} ${_generatedSources} PARENT_SCOPE)
+endfunction()
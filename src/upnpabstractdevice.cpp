@@ -22,18 +22,29 @@
 
 #include <QLoggingCategory>
 
+
 class UpnpAbstractDevicePrivate
 {
 public:
     UpnpDeviceDescription mDevice;
 
-    std::unique_ptr<QIODevice> mXmlDescription;
+    QList<QPointer<UpnpAbstractService>> mServiceObjects;
+
+    /**
+     * @brief mXmlDescription is the serialized device description shared by all requests, null when it must be built
+     */
+    QByteArray mXmlDescription;
+
+    quint64 mXmlDescriptionBuilds = 0;
+
+    quint64 mXmlDescriptionCacheHits = 0;
 };
 
 UpnpAbstractDevice::UpnpAbstractDevice(QObject *parent)
     : QObject(parent)
     , d(std::make_unique<UpnpAbstractDevicePrivate>())
 {
+    connect(this, &UpnpAbstractDevice::descriptionChanged, this, &UpnpAbstractDevice::invalidateXmlDescription);
 }
 
 UpnpAbstractDevice::~UpnpAbstractDevice() = default;
@@ -66,6 +77,15 @@ const QList<UpnpServiceDescription> &UpnpAbstractDevice::services() const
     return d->mDevice.services();
 }
 
+UpnpAbstractService *UpnpAbstractDevice::serviceByIndex(int serviceIndex) const
+{
+    if (serviceIndex < 0 || serviceIndex >= d->mServiceObjects.size()) {
+        return nullptr;
+    }
+
+    return d->mServiceObjects[serviceIndex];
+}
+
 QVector<QString> UpnpAbstractDevice::servicesName() const
 {
     QVector<QString> result;
@@ -94,14 +114,19 @@ const UpnpDeviceDescription &UpnpAbstractDevice::description() const
     return d->mDevice;
 }
 
-std::unique_ptr<QIODevice> UpnpAbstractDevice::buildAndGetXmlDescription()
+QByteArray UpnpAbstractDevice::xmlDescription()
 {
-    if (!d->mXmlDescription) {
-        QPointer<QBuffer> newDescription(new QBuffer);
+    if (!d->mXmlDescription.isNull()) {
+        ++d->mXmlDescriptionCacheHits;
+        return d->mXmlDescription;
+    }
+
+    ++d->mXmlDescriptionBuilds;
 
-        newDescription->open(QIODevice::ReadWrite);
+    QByteArray newDescription;
 
-        QXmlStreamWriter insertStream(newDescription.data());
+    {
+        QXmlStreamWriter insertStream(&newDescription);
         insertStream.setAutoFormatting(true);
 
         insertStream.writeStartDocument();
@@ -144,13 +169,38 @@ std::unique_ptr<QIODevice> UpnpAbstractDevice::buildAndGetXmlDescription()
         insertStream.writeEndElement();
         insertStream.writeEndElement();
         insertStream.writeEndDocument();
-
-        d->mXmlDescription .reset( newDescription);
     }
 
-    d->mXmlDescription->seek(0);
+    d->mXmlDescription = newDescription;
+
+    return d->mXmlDescription;
+}
+
+std::unique_ptr<QIODevice> UpnpAbstractDevice::buildAndGetXmlDescription()
+{
+    // the buffer shares the cached bytes, nothing is copied
+    auto newDescription = std::make_unique<QBuffer>();
+    newDescription->setData(xmlDescription());
+    newDescription->open(QIODevice::ReadOnly);
 
-    return std::move(d->mXmlDescription);
+    return newDescription;
+}
+
+void UpnpAbstractDevice::invalidateXmlDescription()
+{
+    d->mXmlDescription = QByteArray{};
+
+    Q_EMIT xmlDescriptionInvalidated();
+}
+
+quint64 UpnpAbstractDevice::xmlDescriptionBuilds() const
+{
+    return d->mXmlDescriptionBuilds;
+}
+
+quint64 UpnpAbstractDevice::xmlDescriptionCacheHits() const
+{
+    return d->mXmlDescriptionCacheHits;
 }
 
 void UpnpAbstractDevice::newSearchQuery(UpnpSsdpEngine *engine, const UpnpSearchQuery &searchQuery)
@@ -174,7 +224,27 @@ void UpnpAbstractDevice::newSearchQuery(UpnpSsdpEngine *engine, const UpnpSearch
 int UpnpAbstractDevice::addService(const UpnpServiceDescription &newService)
 {
     d->mDevice.services().push_back(newService);
+    d->mServiceObjects.resize(d->mDevice.services().count());
+
+    Q_EMIT descriptionChanged();
+
     return d->mDevice.services().count() - 1;
 }
 
+int UpnpAbstractDevice::addService(UpnpAbstractService *service)
+{
+    d->mDevice.services().push_back(service->description());
+    d->mServiceObjects.resize(d->mDevice.services().count());
+
+    const auto newIndex = d->mDevice.services().count() - 1;
+    d->mServiceObjects[newIndex] = service;
+
+    connect(service, &UpnpAbstractService::xmlDescriptionInvalidated, this, &UpnpAbstractDevice::xmlDescriptionInvalidated);
+
+    // the service object is known when descriptionChanged is received
+    Q_EMIT descriptionChanged();
+
+    return newIndex;
+}
+
 #include "moc_upnpabstractdevice.cpp"
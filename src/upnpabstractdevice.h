@@ -48,6 +48,11 @@ public:
 
     [[nodiscard]] const QList<UpnpServiceDescription> &services() const;
 
+    /**
+     * @brief serviceByIndex returns the object implementing a service or nullptr if the service was added only with its description
+     */
+    [[nodiscard]] UpnpAbstractService *serviceByIndex(int serviceIndex) const;
+
     [[nodiscard]] QVector<QString> servicesName() const;
 
     void setDescription(UpnpDeviceDescription value);
@@ -58,19 +63,60 @@ public:
 
     [[nodiscard]] int cacheControl() const;
 
+    /**
+     * @brief xmlDescription returns the device description document (device.xml)
+     *
+     * The document is built on first use and then shared by all callers until the description changes (see
+     * invalidateXmlDescription). It must be called from the thread of the device, the returned bytes are implicitly
+     * shared and can be read from any thread.
+     */
+    [[nodiscard]] QByteArray xmlDescription();
+
+    /**
+     * @brief buildAndGetXmlDescription returns a read-only device over the cached xmlDescription
+     */
     [[nodiscard]] std::unique_ptr<QIODevice> buildAndGetXmlDescription();
 
+    /**
+     * @brief xmlDescriptionBuilds is the number of times the device description document has been built
+     */
+    [[nodiscard]] quint64 xmlDescriptionBuilds() const;
+
+    /**
+     * @brief xmlDescriptionCacheHits is the number of times the device description document has been served from the cache
+     */
+    [[nodiscard]] quint64 xmlDescriptionCacheHits() const;
+
 Q_SIGNALS:
 
     void descriptionChanged();
 
+    /**
+     * @brief xmlDescriptionInvalidated is emitted when the document of the device or of one of the services added
+     * with their object must be built again
+     */
+    void xmlDescriptionInvalidated();
+
 public Q_SLOTS:
 
+    /**
+     * @brief invalidateXmlDescription will rebuild the device description document on next use
+     *
+     * It is called when descriptionChanged is emitted, including when a service is added. It must be called after
+     * modifying the description returned by description().
+     */
+    void invalidateXmlDescription();
+
     void newSearchQuery(UpnpSsdpEngine *engine, const UpnpSearchQuery &searchQuery);
 
 protected:
     int addService(const UpnpServiceDescription &newService);
 
+    /**
+     * @brief addService will publish service and dispatch the actions received for it to UpnpAbstractService::dispatchAction
+     */
+    int addService(UpnpAbstractService *service);
+
 private:
     std::unique_ptr<UpnpAbstractDevicePrivate> d;
 };
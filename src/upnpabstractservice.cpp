@@ -12,6 +12,7 @@
 #include "upnpeventsubscriber.h"
 
 #include "upnpactiondescription.h"
+#include "upnpactiondispatcher.h"
 #include "upnpservicedescription.h"
 #include "upnpstatevariabledescription.h"
 
@@ -25,6 +26,7 @@
 
 #include <QLoggingCategory>
 
+
 class UpnpAbstractServicePrivate
 {
 public:
@@ -37,27 +39,51 @@ public:
 
     UpnpServiceDescription mService;
 
-    QPointer<QIODevice> mXmlDescription;
+    /**
+     * @brief mXmlDescription is the serialized service description shared by all requests, null when it must be built
+     */
+    QByteArray mXmlDescription;
+
+    quint64 mXmlDescriptionBuilds = 0;
+
+    quint64 mXmlDescriptionCacheHits = 0;
 
     QVector<QPointer<UpnpEventSubscriber>> mSubscribers;
+
+    UpnpActionDispatcher mActionDispatcher;
+
+    bool mActionHandlersRegistered = false;
 };
 
 UpnpAbstractService::UpnpAbstractService(QObject *parent)
     : QObject(parent)
     , d(std::make_unique<UpnpAbstractServicePrivate>())
 {
+    connect(this, &UpnpAbstractService::descriptionChanged, this, &UpnpAbstractService::invalidateXmlDescription);
 }
 
 UpnpAbstractService::~UpnpAbstractService() = default;
 
-QIODevice *UpnpAbstractService::buildAndGetXmlDescription()
+QByteArray UpnpAbstractService::xmlDescription()
+{
+    if (!d->mXmlDescription.isNull()) {
+        ++d->mXmlDescriptionCacheHits;
+        return d->mXmlDescription;
+    }
+
+    buildXmlDescription();
+
+    return d->mXmlDescription;
+}
+
+void UpnpAbstractService::buildXmlDescription()
 {
-    if (!d->mXmlDescription) {
-        QPointer<QBuffer> newDescription(new QBuffer);
+    ++d->mXmlDescriptionBuilds;
 
-        newDescription->open(QIODevice::ReadWrite);
+    QByteArray newDescription;
 
-        QXmlStreamWriter insertStream(newDescription.data());
+    {
+        QXmlStreamWriter insertStream(&newDescription);
         insertStream.setAutoFormatting(true);
 
         insertStream.writeStartDocument();
@@ -130,13 +156,36 @@ QIODevice *UpnpAbstractService::buildAndGetXmlDescription()
         insertStream.writeEndElement();
         insertStream.writeEndElement();
         insertStream.writeEndDocument();
-
-        d->mXmlDescription = newDescription;
     }
 
-    d->mXmlDescription->seek(0);
+    d->mXmlDescription = newDescription;
+}
+
+std::unique_ptr<QIODevice> UpnpAbstractService::buildAndGetXmlDescription()
+{
+    // each request gets its own read position, the bytes are shared with the cache
+    auto newDescription = std::make_unique<QBuffer>();
+    newDescription->setData(xmlDescription());
+    newDescription->open(QIODevice::ReadOnly);
 
-    return d->mXmlDescription;
+    return newDescription;
+}
+
+void UpnpAbstractService::invalidateXmlDescription()
+{
+    d->mXmlDescription = QByteArray{};
+
+    Q_EMIT xmlDescriptionInvalidated();
+}
+
+quint64 UpnpAbstractService::xmlDescriptionBuilds() const
+{
+    return d->mXmlDescriptionBuilds;
+}
+
+quint64 UpnpAbstractService::xmlDescriptionCacheHits() const
+{
+    return d->mXmlDescriptionCacheHits;
 }
 
 QPointer<UpnpEventSubscriber> UpnpAbstractService::subscribeToEvents(const QByteArray &requestData, const QMap<QByteArray, QByteArray> &headers)
@@ -190,6 +239,8 @@ void UpnpAbstractService::unsubscribeToEvents(const QByteArray &requestData, con
 void UpnpAbstractService::addAction(const UpnpActionDescription &newAction)
 {
     description().actions()[newAction.mName] = newAction;
+    d->mActionHandlersRegistered = false;
+    invalidateXmlDescription();
 }
 
 const UpnpActionDescription &UpnpAbstractService::action(const QString &name) const
@@ -205,6 +256,7 @@ QList<QString> UpnpAbstractService::actions() const
 void UpnpAbstractService::addStateVariable(const UpnpStateVariableDescription &newVariable)
 {
     description().stateVariables()[newVariable.mUpnpName] = newVariable;
+    invalidateXmlDescription();
 }
 
 const UpnpStateVariableDescription &UpnpAbstractService::stateVariable(const QString &name) const
@@ -219,16 +271,58 @@ QList<QString> UpnpAbstractService::stateVariables() const
 
 QVector<QPair<QString, QVariant>> UpnpAbstractService::invokeAction(const QString &actionName, const QVector<QVariant> &arguments, bool &isInError)
 {
-    Q_UNUSED(actionName)
     Q_UNUSED(arguments)
-    Q_UNUSED(isInError)
+
+    qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpAbstractService::invokeAction" << actionName << "is not implemented";
+
+    isInError = true;
 
     return {};
 }
 
+int UpnpAbstractService::registerActionHandlers()
+{
+    d->mActionHandlersRegistered = true;
+
+    return d->mActionDispatcher.registerActions(metaObject(), description().actions());
+}
+
+bool UpnpAbstractService::dispatchAction(const QString &actionName,
+                                         const QList<QPair<QString, QString>> &inputArguments,
+                                         QList<QPair<QString, QString>> &outputArguments)
+{
+    if (!d->mActionHandlersRegistered) {
+        registerActionHandlers();
+    }
+
+    if (d->mActionDispatcher.hasAction(actionName)) {
+        return d->mActionDispatcher.dispatch(this, actionName, inputArguments, outputArguments);
+    }
+
+    QVector<QVariant> arguments;
+    arguments.reserve(inputArguments.size());
+    for (const auto &oneArgument : inputArguments) {
+        arguments.push_back(oneArgument.second);
+    }
+
+    bool isInError = false;
+    const auto &returnedValues = invokeAction(actionName, arguments, isInError);
+    if (isInError) {
+        return false;
+    }
+
+    outputArguments.reserve(returnedValues.size());
+    for (const auto &oneValue : returnedValues) {
+        outputArguments.push_back({oneValue.first, oneValue.second.toString()});
+    }
+
+    return true;
+}
+
 void UpnpAbstractService::setDescription(const UpnpServiceDescription &value)
 {
     d->mService = value;
+    d->mActionHandlersRegistered = false;
     Q_EMIT descriptionChanged();
 }
 
@@ -9,6 +9,7 @@
 
 #include "upnplibqt_export.h"
 
+#include <QByteArray>
 #include <QList>
 #include <QObject>
 #include <QPair>
@@ -44,7 +45,29 @@ public:
 
     ~UpnpAbstractService() override;
 
-    [[nodiscard]] QIODevice *buildAndGetXmlDescription();
+    /**
+     * @brief xmlDescription returns the service description document (SCPD)
+     *
+     * The document is built on first use and then shared by all callers until the description changes (see
+     * invalidateXmlDescription). It must be called from the thread of the service: the document is built from
+     * description(), which is not protected. The returned bytes are implicitly shared and can be read from any thread.
+     */
+    [[nodiscard]] QByteArray xmlDescription();
+
+    /**
+     * @brief buildAndGetXmlDescription returns a read-only device over the cached xmlDescription
+     */
+    [[nodiscard]] std::unique_ptr<QIODevice> buildAndGetXmlDescription();
+
+    /**
+     * @brief xmlDescriptionBuilds is the number of times the service description document has been built
+     */
+    [[nodiscard]] quint64 xmlDescriptionBuilds() const;
+
+    /**
+     * @brief xmlDescriptionCacheHits is the number of times the service description document has been served from the cache
+     */
+    [[nodiscard]] quint64 xmlDescriptionCacheHits() const;
 
     [[nodiscard]] QPointer<UpnpEventSubscriber> subscribeToEvents(const QByteArray &requestData, const QMap<QByteArray, QByteArray> &headers);
 
@@ -62,8 +85,39 @@ public:
 
     [[nodiscard]] QList<QString> stateVariables() const;
 
+    /**
+     * @brief invokeAction is called by dispatchAction for actions without a method registered by registerActionHandlers
+     *
+     * The default implementation sets isInError: an action implemented neither way is answered with a fault.
+     */
     [[nodiscard]] virtual QVector<QPair<QString, QVariant>> invokeAction(const QString &actionName, const QVector<QVariant> &arguments, bool &isInError);
 
+    /**
+     * @brief registerActionHandlers will resolve the Q_INVOKABLE methods implementing the actions of the description
+     *
+     * See \class UpnpActionDispatcher for the expected signatures. It is called on first dispatch and again after
+     * addAction or setDescription. It must be called after modifying the actions returned by description().
+     *
+     * @return the number of actions implemented by a method
+     */
+    int registerActionHandlers();
+
+    /**
+     * @brief dispatchAction is called by the device SOAP server when an action of this service is received
+     *
+     * The default implementation calls the method registered for the action by registerActionHandlers or invokeAction
+     * for actions without such a method. Skeletons generated by upnpscpd2cpp override it with a static
+     * dispatch table calling one typed method per action.
+     *
+     * @param actionName is the name of the action
+     * @param inputArguments are the names and values of the arguments in the order of the request
+     * @param outputArguments receives the names and values of the output arguments
+     * @return false if the action call is in error
+     */
+    [[nodiscard]] virtual bool dispatchAction(const QString &actionName,
+                                              const QList<QPair<QString, QString>> &inputArguments,
+                                              QList<QPair<QString, QString>> &outputArguments);
+
     void setDescription(const UpnpServiceDescription &value);
 
     [[nodiscard]] UpnpServiceDescription &description();
@@ -74,9 +128,28 @@ Q_SIGNALS:
 
     void descriptionChanged();
 
+    /**
+     * @brief xmlDescriptionInvalidated is emitted by invalidateXmlDescription, when the service description document
+     * must be built again
+     */
+    void xmlDescriptionInvalidated();
+
 public Q_SLOTS:
 
+    /**
+     * @brief invalidateXmlDescription will rebuild the service description document on next use
+     *
+     * It is called when descriptionChanged is emitted and when an action or a state variable is added. It must be
+     * called after modifying the description returned by description().
+     */
+    void invalidateXmlDescription();
+
 private:
+    /**
+     * @brief buildXmlDescription will serialize the description into the cache
+     */
+    void buildXmlDescription();
+
     void sendEventNotification(const QPointer<UpnpEventSubscriber> &currentSubscriber);
 
     std::unique_ptr<UpnpAbstractServicePrivate> d;
@@ -0,0 +1,72 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef UPNPACTIONAWAITER_H
+#define UPNPACTIONAWAITER_H
+
+#include "upnpactionresult.h"
+
+#include <QFuture>
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <coroutine>
+
+/**
+ * @brief The UpnpActionAwaiter class allows C++20 coroutines to co_await the result of UpnpControlAbstractService::callActionAsync
+ *
+ * The coroutine is resumed in the thread that receives the answer, which is the thread of the service.
+ *
+ * @code
+ * const UpnpActionResult position = co_await service->callActionAsync(QStringLiteral("GetPositionInfo"), arguments);
+ * @endcode
+ */
+class UpnpActionAwaiter
+{
+public:
+    explicit UpnpActionAwaiter(QFuture<UpnpActionResult> future)
+        : mFuture(std::move(future))
+    {
+    }
+
+    [[nodiscard]] bool await_ready() const
+    {
+        return mFuture.isFinished();
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        mFuture
+            .then(QtFuture::Launch::Sync,
+                  [handle](const UpnpActionResult &) {
+                      handle.resume();
+                  })
+            .onCanceled([handle]() {
+                handle.resume();
+            });
+    }
+
+    [[nodiscard]] UpnpActionResult await_resume() const
+    {
+        if (mFuture.isCanceled() || mFuture.resultCount() == 0) {
+            return UpnpActionResult::fromError(QStringLiteral("action call canceled"));
+        }
+
+        return mFuture.result();
+    }
+
+private:
+    QFuture<UpnpActionResult> mFuture;
+};
+
+[[nodiscard]] inline UpnpActionAwaiter operator co_await(QFuture<UpnpActionResult> future)
+{
+    return UpnpActionAwaiter(std::move(future));
+}
+
+#endif
+
+#endif // UPNPACTIONAWAITER_H
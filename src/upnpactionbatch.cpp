@@ -0,0 +1,271 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpactionbatch.h"
+
+#include "upnplogging.h"
+
+#include "upnpcontrolabstractservice.h"
+
+#include <QElapsedTimer>
+#include <QPromise>
+
+#include <QLoggingCategory>
+
+class UpnpActionBatchCall
+{
+public:
+    QMap<QString, QVariant> mArguments;
+
+    QElapsedTimer mDuration;
+};
+
+class UpnpActionBatchPrivate
+{
+public:
+    QList<UpnpActionBatchCall> mCalls;
+
+    QList<UpnpActionBatchResult> mResults;
+
+    QPromise<QList<UpnpActionBatchResult>> mPromise;
+
+    QElapsedTimer mDuration;
+
+    qint64 mTotalDuration = -1;
+
+    int mMaximumConcurrentCalls = 16;
+
+    int mNextCall = 0;
+
+    int mRunningCalls = 0;
+
+    int mFinishedCalls = 0;
+
+    int mFailedCalls = 0;
+
+    qint64 mLatencySum = 0;
+
+    int mLatencyCount = 0;
+
+    qint64 mMaximumLatency = 0;
+
+    bool mIsStarted = false;
+
+    bool mIsFinished = false;
+};
+
+UpnpActionBatch::UpnpActionBatch(QObject *parent)
+    : QObject(parent)
+    , d(std::make_unique<UpnpActionBatchPrivate>())
+{
+}
+
+UpnpActionBatch::~UpnpActionBatch() = default;
+
+void UpnpActionBatch::addCall(UpnpControlAbstractService *service, const QString &actionName, const QMap<QString, QVariant> &arguments)
+{
+    if (d->mIsStarted) {
+        qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpActionBatch::addCall" << "batch already started" << actionName;
+        return;
+    }
+
+    d->mCalls.push_back({arguments, {}});
+    d->mResults.push_back({service, actionName, {}, -1});
+}
+
+void UpnpActionBatch::addCalls(const QList<UpnpControlAbstractService *> &services, const QString &actionName, const QMap<QString, QVariant> &arguments)
+{
+    if (d->mIsStarted) {
+        qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpActionBatch::addCalls" << "batch already started" << actionName;
+        return;
+    }
+
+    d->mCalls.reserve(d->mCalls.size() + services.size());
+    d->mResults.reserve(d->mResults.size() + services.size());
+
+    for (auto *oneService : services) {
+        addCall(oneService, actionName, arguments);
+    }
+}
+
+QFuture<QList<UpnpActionBatchResult>> UpnpActionBatch::start()
+{
+    auto result = d->mPromise.future();
+
+    if (d->mIsStarted) {
+        return result;
+    }
+
+    d->mIsStarted = true;
+    d->mPromise.start();
+    d->mDuration.start();
+
+    startNextCalls();
+    checkFinished();
+
+    return result;
+}
+
+void UpnpActionBatch::cancel()
+{
+    while (d->mNextCall < d->mCalls.size()) {
+        const auto callIndex = d->mNextCall;
+        ++d->mNextCall;
+
+        finishCall(callIndex, UpnpActionResult::fromError(QStringLiteral("batch canceled")));
+    }
+
+    checkFinished();
+}
+
+int UpnpActionBatch::maximumConcurrentCalls() const
+{
+    return d->mMaximumConcurrentCalls;
+}
+
+const QList<UpnpActionBatchResult> &UpnpActionBatch::results() const
+{
+    return d->mResults;
+}
+
+int UpnpActionBatch::callsCount() const
+{
+    return d->mCalls.size();
+}
+
+int UpnpActionBatch::runningCalls() const
+{
+    return d->mRunningCalls;
+}
+
+int UpnpActionBatch::finishedCalls() const
+{
+    return d->mFinishedCalls;
+}
+
+int UpnpActionBatch::failedCalls() const
+{
+    return d->mFailedCalls;
+}
+
+bool UpnpActionBatch::isFinished() const
+{
+    return d->mIsFinished;
+}
+
+double UpnpActionBatch::averageLatency() const
+{
+    if (!d->mLatencyCount) {
+        return 0.;
+    }
+
+    return static_cast<double>(d->mLatencySum) / static_cast<double>(d->mLatencyCount);
+}
+
+qint64 UpnpActionBatch::maximumLatency() const
+{
+    return d->mMaximumLatency;
+}
+
+qint64 UpnpActionBatch::duration() const
+{
+    if (d->mTotalDuration != -1) {
+        return d->mTotalDuration;
+    }
+
+    return d->mDuration.isValid() ? d->mDuration.elapsed() : -1;
+}
+
+void UpnpActionBatch::setMaximumConcurrentCalls(int value)
+{
+    if (d->mMaximumConcurrentCalls == value || value < 1) {
+        return;
+    }
+
+    d->mMaximumConcurrentCalls = value;
+    Q_EMIT maximumConcurrentCallsChanged();
+
+    if (d->mIsStarted) {
+        startNextCalls();
+    }
+}
+
+void UpnpActionBatch::startNextCalls()
+{
+    while (d->mRunningCalls < d->mMaximumConcurrentCalls && d->mNextCall < d->mCalls.size()) {
+        const auto callIndex = d->mNextCall;
+        ++d->mNextCall;
+
+        auto *service = d->mResults[callIndex].mService.data();
+        if (!service) {
+            finishCall(callIndex, UpnpActionResult::fromError(QStringLiteral("service deleted")));
+            continue;
+        }
+
+        auto &oneCall = d->mCalls[callIndex];
+
+        ++d->mRunningCalls;
+        oneCall.mDuration.start();
+
+        service->callActionAsync(d->mResults[callIndex].mActionName, oneCall.mArguments)
+            .then(this,
+                  [this, callIndex](const UpnpActionResult &result) {
+                      --d->mRunningCalls;
+                      finishCall(callIndex, result);
+                      startNextCalls();
+                      checkFinished();
+                  })
+            .onCanceled(this, [this, callIndex]() {
+                --d->mRunningCalls;
+                finishCall(callIndex, UpnpActionResult::fromError(QStringLiteral("action call canceled")));
+                startNextCalls();
+                checkFinished();
+            });
+    }
+}
+
+void UpnpActionBatch::finishCall(int callIndex, const UpnpActionResult &result)
+{
+    auto &oneResult = d->mResults[callIndex];
+    const auto &oneCall = d->mCalls[callIndex];
+
+    oneResult.mResult = result;
+
+    if (oneCall.mDuration.isValid()) {
+        oneResult.mLatency = oneCall.mDuration.elapsed();
+
+        d->mLatencySum += oneResult.mLatency;
+        ++d->mLatencyCount;
+        d->mMaximumLatency = qMax(d->mMaximumLatency, oneResult.mLatency);
+    }
+
+    ++d->mFinishedCalls;
+    if (!result.mSuccess) {
+        ++d->mFailedCalls;
+    }
+
+    Q_EMIT callFinished(callIndex);
+}
+
+void UpnpActionBatch::checkFinished()
+{
+    if (!d->mIsStarted || d->mIsFinished || d->mFinishedCalls < d->mCalls.size()) {
+        return;
+    }
+
+    d->mIsFinished = true;
+    d->mTotalDuration = d->mDuration.elapsed();
+
+    qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpActionBatch::checkFinished" << d->mCalls.size() << "calls" << d->mFailedCalls << "failed"
+                                   << d->mTotalDuration << "ms";
+
+    d->mPromise.addResult(d->mResults);
+    d->mPromise.finish();
+
+    Q_EMIT finished();
+}
+
+#include "moc_upnpactionbatch.cpp"
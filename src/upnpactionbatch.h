@@ -0,0 +1,141 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef UPNPACTIONBATCH_H
+#define UPNPACTIONBATCH_H
+
+#include "upnplibqt_export.h"
+
+#include "upnpactionresult.h"
+
+#include <QFuture>
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QVariant>
+
+#include <memory>
+
+class UpnpControlAbstractService;
+class UpnpActionBatchPrivate;
+
+/**
+ * @brief The UpnpActionBatchResult class is the result of one call of a \class UpnpActionBatch
+ */
+class UPNPLIBQT_EXPORT UpnpActionBatchResult
+{
+public:
+    QPointer<UpnpControlAbstractService> mService;
+
+    QString mActionName;
+
+    UpnpActionResult mResult;
+
+    /**
+     * @brief mLatency is the duration of the call in milliseconds or -1 if it was not sent
+     */
+    qint64 mLatency = -1;
+};
+
+/**
+ * @brief The UpnpActionBatch class calls actions on many services with a limited number of concurrent calls
+ *
+ * Calls are added with addCall or addCalls and are sent when start is called. At most maximumConcurrentCalls
+ * calls are running at the same time. The results are given in the order the calls were added.
+ *
+ * @code
+ * auto *batch = new UpnpActionBatch(this);
+ * batch->addCalls(renderers, QStringLiteral("GetTransportInfo"), {{QStringLiteral("InstanceID"), 0}});
+ * batch->start().then(this, [](const QList<UpnpActionBatchResult> &results) { ... });
+ * @endcode
+ */
+class UPNPLIBQT_EXPORT UpnpActionBatch : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int maximumConcurrentCalls
+            READ maximumConcurrentCalls
+                WRITE setMaximumConcurrentCalls
+                    NOTIFY maximumConcurrentCallsChanged)
+
+public:
+    explicit UpnpActionBatch(QObject *parent = nullptr);
+
+    ~UpnpActionBatch() override;
+
+    void addCall(UpnpControlAbstractService *service, const QString &actionName, const QMap<QString, QVariant> &arguments);
+
+    /**
+     * @brief addCalls will call the same action with the same arguments on each service
+     */
+    void addCalls(const QList<UpnpControlAbstractService *> &services, const QString &actionName, const QMap<QString, QVariant> &arguments);
+
+    /**
+     * @brief start will send the calls
+     *
+     * @return a future that is finished with the results of all calls when the last one is finished
+     */
+    QFuture<QList<UpnpActionBatchResult>> start();
+
+    /**
+     * @brief cancel will stop sending new calls; the calls not yet sent are finished with an error
+     */
+    void cancel();
+
+    [[nodiscard]] int maximumConcurrentCalls() const;
+
+    [[nodiscard]] const QList<UpnpActionBatchResult> &results() const;
+
+    [[nodiscard]] int callsCount() const;
+
+    [[nodiscard]] int runningCalls() const;
+
+    [[nodiscard]] int finishedCalls() const;
+
+    [[nodiscard]] int failedCalls() const;
+
+    [[nodiscard]] bool isFinished() const;
+
+    /**
+     * @brief averageLatency is the average duration in milliseconds of the calls that were sent
+     */
+    [[nodiscard]] double averageLatency() const;
+
+    /**
+     * @brief maximumLatency is the duration in milliseconds of the slowest call
+     */
+    [[nodiscard]] qint64 maximumLatency() const;
+
+    /**
+     * @brief duration is the time in milliseconds between start and the end of the last call
+     */
+    [[nodiscard]] qint64 duration() const;
+
+Q_SIGNALS:
+
+    void maximumConcurrentCallsChanged();
+
+    void callFinished(int callIndex);
+
+    void finished();
+
+public Q_SLOTS:
+
+    void setMaximumConcurrentCalls(int value);
+
+private:
+    void startNextCalls();
+
+    void finishCall(int callIndex, const UpnpActionResult &result);
+
+    void checkFinished();
+
+    std::unique_ptr<UpnpActionBatchPrivate> d;
+};
+
+#endif // UPNPACTIONBATCH_H
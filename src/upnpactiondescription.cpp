@@ -5,3 +5,43 @@
  */
 
 #include "upnpactiondescription.h"
+
+#include <QDataStream>
+
+QDataStream &operator<<(QDataStream &stream, const UpnpActionArgumentDescription &data)
+{
+    stream << data.mIsValid << data.mName << static_cast<qint32>(data.mDirection) << data.mIsReturnValue << data.mRelatedStateVariable;
+
+    return stream;
+}
+
+QDataStream &operator>>(QDataStream &stream, UpnpActionArgumentDescription &data)
+{
+    qint32 direction = 0;
+
+    stream >> data.mIsValid >> data.mName >> direction >> data.mIsReturnValue >> data.mRelatedStateVariable;
+
+    data.mDirection = static_cast<UpnpArgumentDirection>(direction);
+
+    return stream;
+}
+
+QDataStream &operator<<(QDataStream &stream, const UpnpActionDescription &data)
+{
+    stream << data.mIsValid << data.mName << data.mArguments << static_cast<qint32>(data.mNumberInArgument) << static_cast<qint32>(data.mNumberOutArgument);
+
+    return stream;
+}
+
+QDataStream &operator>>(QDataStream &stream, UpnpActionDescription &data)
+{
+    qint32 numberInArgument = 0;
+    qint32 numberOutArgument = 0;
+
+    stream >> data.mIsValid >> data.mName >> data.mArguments >> numberInArgument >> numberOutArgument;
+
+    data.mNumberInArgument = numberInArgument;
+    data.mNumberOutArgument = numberOutArgument;
+
+    return stream;
+}
@@ -12,6 +12,8 @@
 #include <QString>
 #include <QVector>
 
+class QDataStream;
+
 /**
  * @brief The UpnpArgumentDirection enum indicates if an argument is sent with the request (In) or received with the answer (Out)
  */
@@ -64,4 +66,12 @@ public:
     int mNumberOutArgument = 0;
 };
 
+UPNPLIBQT_EXPORT QDataStream &operator<<(QDataStream &stream, const UpnpActionArgumentDescription &data);
+
+UPNPLIBQT_EXPORT QDataStream &operator>>(QDataStream &stream, UpnpActionArgumentDescription &data);
+
+UPNPLIBQT_EXPORT QDataStream &operator<<(QDataStream &stream, const UpnpActionDescription &data);
+
+UPNPLIBQT_EXPORT QDataStream &operator>>(QDataStream &stream, UpnpActionDescription &data);
+
 #endif // UPNPACTIONDESCRIPTION_H
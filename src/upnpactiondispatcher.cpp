@@ -0,0 +1,371 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpactiondispatcher.h"
+
+#include "upnplogging.h"
+
+#include "upnpactiondescription.h"
+#include "upnpstatevariabledescription.h"
+
+#include <QLocale>
+#include <QMetaMethod>
+#include <QMetaObject>
+#include <QObject>
+#include <QVarLengthArray>
+
+#include <QLoggingCategory>
+
+#include <cstddef>
+#include <limits>
+
+namespace
+{
+
+bool readString(const QString &value, QMetaType type, void *storage)
+{
+    Q_UNUSED(type)
+
+    *static_cast<QString *>(storage) = value;
+
+    return true;
+}
+
+bool readBoolean(const QString &value, QMetaType type, void *storage)
+{
+    Q_UNUSED(type)
+
+    bool conversionIsOk = false;
+    *static_cast<bool *>(storage) = UpnpStateVariableDescription::booleanValue(value, &conversionIsOk);
+
+    return conversionIsOk;
+}
+
+template<typename T>
+bool readSigned(const QString &value, QMetaType type, void *storage)
+{
+    Q_UNUSED(type)
+
+    bool conversionIsOk = false;
+    const auto result = value.toLongLong(&conversionIsOk);
+    if (!conversionIsOk || result < std::numeric_limits<T>::min() || result > std::numeric_limits<T>::max()) {
+        return false;
+    }
+
+    *static_cast<T *>(storage) = static_cast<T>(result);
+
+    return true;
+}
+
+template<typename T>
+bool readUnsigned(const QString &value, QMetaType type, void *storage)
+{
+    Q_UNUSED(type)
+
+    bool conversionIsOk = false;
+    const auto result = value.toULongLong(&conversionIsOk);
+    if (!conversionIsOk || result > std::numeric_limits<T>::max()) {
+        return false;
+    }
+
+    *static_cast<T *>(storage) = static_cast<T>(result);
+
+    return true;
+}
+
+bool readDouble(const QString &value, QMetaType type, void *storage)
+{
+    Q_UNUSED(type)
+
+    bool conversionIsOk = false;
+    *static_cast<double *>(storage) = value.toDouble(&conversionIsOk);
+
+    return conversionIsOk;
+}
+
+bool readConvertible(const QString &value, QMetaType type, void *storage)
+{
+    return QMetaType::convert(QMetaType::fromType<QString>(), &value, type, storage);
+}
+
+QString writeString(QMetaType type, const void *storage)
+{
+    Q_UNUSED(type)
+
+    return *static_cast<const QString *>(storage);
+}
+
+QString writeBoolean(QMetaType type, const void *storage)
+{
+    Q_UNUSED(type)
+
+    return *static_cast<const bool *>(storage) ? QStringLiteral("1") : QStringLiteral("0");
+}
+
+template<typename T>
+QString writeNumber(QMetaType type, const void *storage)
+{
+    Q_UNUSED(type)
+
+    return QString::number(*static_cast<const T *>(storage));
+}
+
+QString writeReal(QMetaType type, const void *storage)
+{
+    Q_UNUSED(type)
+
+    // the default precision of QString::number would round the value to 6 digits
+    return QString::number(*static_cast<const double *>(storage), 'g', QLocale::FloatingPointShortest);
+}
+
+QString writeConvertible(QMetaType type, const void *storage)
+{
+    QString result;
+    QMetaType::convert(type, storage, QMetaType::fromType<QString>(), &result);
+
+    return result;
+}
+
+}
+
+int UpnpActionDispatcher::registerActions(const QMetaObject *metaObject, const QMap<QString, UpnpActionDescription> &actions)
+{
+    clear();
+
+    for (const auto &oneAction : actions) {
+        QString methodName = oneAction.mName;
+        if (!methodName.isEmpty()) {
+            methodName[0] = methodName[0].toLower();
+        }
+
+        const QByteArray &exactName = oneAction.mName.toLatin1();
+        const QByteArray &lowerCaseName = methodName.toLatin1();
+        const auto argumentsCount = oneAction.mArguments.size();
+
+        auto method = QMetaMethod{};
+        for (int methodIndex = 0; methodIndex < metaObject->methodCount(); ++methodIndex) {
+            const auto &oneMethod = metaObject->method(methodIndex);
+            if (oneMethod.methodType() == QMetaMethod::Signal || oneMethod.access() != QMetaMethod::Public
+                || oneMethod.parameterCount() != argumentsCount) {
+                continue;
+            }
+
+            if (oneMethod.name() == exactName) {
+                method = oneMethod;
+                break;
+            }
+
+            if (!method.isValid() && oneMethod.name() == lowerCaseName) {
+                method = oneMethod;
+            }
+        }
+
+        if (!method.isValid()) {
+            continue;
+        }
+
+        const auto returnType = method.returnMetaType().id();
+        if (returnType != QMetaType::Void && returnType != QMetaType::Bool) {
+            qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpActionDispatcher::registerActions" << method.methodSignature() << "must return void or bool";
+            continue;
+        }
+
+        auto newHandler = Handler{};
+        newHandler.mMethodIndex = method.methodIndex();
+        newHandler.mReturnsBool = (returnType == QMetaType::Bool);
+        newHandler.mArguments.reserve(argumentsCount);
+
+        // the method parameters are the input arguments and then the output arguments
+        QVector<UpnpActionArgumentDescription> orderedArguments;
+        orderedArguments.reserve(argumentsCount);
+        for (const auto &oneArgument : oneAction.mArguments) {
+            if (oneArgument.mDirection == UpnpArgumentDirection::In) {
+                orderedArguments.push_back(oneArgument);
+            }
+        }
+        newHandler.mNumberInArgument = static_cast<int>(orderedArguments.size());
+        for (const auto &oneArgument : oneAction.mArguments) {
+            if (oneArgument.mDirection != UpnpArgumentDirection::In) {
+                orderedArguments.push_back(oneArgument);
+            }
+        }
+
+        bool handlerIsValid = true;
+        for (int argumentIndex = 0; argumentIndex < orderedArguments.size(); ++argumentIndex) {
+            const QByteArray &typeName = method.parameterTypeName(argumentIndex);
+            const bool isOutput = argumentIndex >= newHandler.mNumberInArgument;
+
+            if (typeName.endsWith('&') != isOutput) {
+                handlerIsValid = false;
+                break;
+            }
+
+            auto newArgument = Argument{};
+            newArgument.mName = orderedArguments[argumentIndex].mName;
+
+            if (!resolveArgument(isOutput ? typeName.chopped(1) : typeName, newArgument)) {
+                handlerIsValid = false;
+                break;
+            }
+
+            const auto alignment = qsizetype(newArgument.mType.alignOf());
+            newArgument.mOffset = (newHandler.mStorageSize + alignment - 1) / alignment * alignment;
+            newHandler.mStorageSize = newArgument.mOffset + newArgument.mType.sizeOf();
+
+            newHandler.mArguments.push_back(newArgument);
+        }
+
+        if (!handlerIsValid) {
+            qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpActionDispatcher::registerActions" << method.methodSignature() << "does not match the arguments of" << oneAction.mName;
+            continue;
+        }
+
+        mHandlers[oneAction.mName] = newHandler;
+    }
+
+    return static_cast<int>(mHandlers.size());
+}
+
+void UpnpActionDispatcher::clear()
+{
+    mHandlers.clear();
+}
+
+bool UpnpActionDispatcher::hasAction(const QString &actionName) const
+{
+    return mHandlers.contains(actionName);
+}
+
+int UpnpActionDispatcher::size() const
+{
+    return static_cast<int>(mHandlers.size());
+}
+
+bool UpnpActionDispatcher::dispatch(QObject *object,
+                                    const QString &actionName,
+                                    const QList<QPair<QString, QString>> &inputArguments,
+                                    QList<QPair<QString, QString>> &outputArguments) const
+{
+    const auto itHandler = mHandlers.constFind(actionName);
+    if (itHandler == mHandlers.constEnd()) {
+        return false;
+    }
+
+    const auto &handler = itHandler.value();
+    if (inputArguments.size() != handler.mNumberInArgument) {
+        return false;
+    }
+
+    for (int argumentIndex = 0; argumentIndex < handler.mNumberInArgument; ++argumentIndex) {
+        if (inputArguments[argumentIndex].first != handler.mArguments[argumentIndex].mName) {
+            return false;
+        }
+    }
+
+    const auto argumentsCount = handler.mArguments.size();
+
+    // the arguments are constructed on the stack for most actions
+    QVarLengthArray<std::max_align_t, 32> storage((handler.mStorageSize + qsizetype(sizeof(std::max_align_t)) - 1) / qsizetype(sizeof(std::max_align_t)));
+    auto *storageBytes = reinterpret_cast<char *>(storage.data());
+
+    bool callIsOk = true;
+    QVarLengthArray<void *, 16> metaCallArguments(argumentsCount + 1);
+    metaCallArguments[0] = handler.mReturnsBool ? &callIsOk : nullptr;
+
+    int constructedArguments = 0;
+    bool argumentsAreValid = true;
+    for (; constructedArguments < argumentsCount; ++constructedArguments) {
+        const auto &oneArgument = handler.mArguments[constructedArguments];
+        void *argumentStorage = storageBytes + oneArgument.mOffset;
+
+        oneArgument.mType.construct(argumentStorage);
+        metaCallArguments[constructedArguments + 1] = argumentStorage;
+
+        if (constructedArguments < handler.mNumberInArgument
+            && !oneArgument.mReader(inputArguments[constructedArguments].second, oneArgument.mType, argumentStorage)) {
+            ++constructedArguments;
+            argumentsAreValid = false;
+            break;
+        }
+    }
+
+    if (argumentsAreValid) {
+        QMetaObject::metacall(object, QMetaObject::InvokeMetaMethod, handler.mMethodIndex, metaCallArguments.data());
+
+        if (callIsOk) {
+            outputArguments.reserve(outputArguments.size() + argumentsCount - handler.mNumberInArgument);
+            for (int argumentIndex = handler.mNumberInArgument; argumentIndex < argumentsCount; ++argumentIndex) {
+                const auto &oneArgument = handler.mArguments[argumentIndex];
+                outputArguments.push_back({oneArgument.mName, oneArgument.mWriter(oneArgument.mType, metaCallArguments[argumentIndex + 1])});
+            }
+        }
+    }
+
+    for (int argumentIndex = 0; argumentIndex < constructedArguments; ++argumentIndex) {
+        const auto &oneArgument = handler.mArguments[argumentIndex];
+        oneArgument.mType.destruct(metaCallArguments[argumentIndex + 1]);
+    }
+
+    return argumentsAreValid && callIsOk;
+}
+
+bool UpnpActionDispatcher::resolveArgument(const QByteArray &typeName, Argument &argument)
+{
+    argument.mType = QMetaType::fromName(typeName);
+    if (!argument.mType.isValid() || argument.mType.alignOf() > alignof(std::max_align_t)) {
+        return false;
+    }
+
+    switch (argument.mType.id()) {
+    case QMetaType::QString:
+        argument.mReader = readString;
+        argument.mWriter = writeString;
+        break;
+    case QMetaType::Bool:
+        argument.mReader = readBoolean;
+        argument.mWriter = writeBoolean;
+        break;
+    case QMetaType::Short:
+        argument.mReader = readSigned<short>;
+        argument.mWriter = writeNumber<short>;
+        break;
+    case QMetaType::Int:
+        argument.mReader = readSigned<int>;
+        argument.mWriter = writeNumber<int>;
+        break;
+    case QMetaType::LongLong:
+        argument.mReader = readSigned<qlonglong>;
+        argument.mWriter = writeNumber<qlonglong>;
+        break;
+    case QMetaType::UShort:
+        argument.mReader = readUnsigned<ushort>;
+        argument.mWriter = writeNumber<ushort>;
+        break;
+    case QMetaType::UInt:
+        argument.mReader = readUnsigned<uint>;
+        argument.mWriter = writeNumber<uint>;
+        break;
+    case QMetaType::ULongLong:
+        argument.mReader = readUnsigned<qulonglong>;
+        argument.mWriter = writeNumber<qulonglong>;
+        break;
+    case QMetaType::Double:
+        argument.mReader = readDouble;
+        argument.mWriter = writeReal;
+        break;
+    default:
+        if (!QMetaType::canConvert(QMetaType::fromType<QString>(), argument.mType)
+            || !QMetaType::canConvert(argument.mType, QMetaType::fromType<QString>())) {
+            return false;
+        }
+
+        argument.mReader = readConvertible;
+        argument.mWriter = writeConvertible;
+        break;
+    }
+
+    return true;
+}
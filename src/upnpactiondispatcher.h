@@ -0,0 +1,127 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef UPNPACTIONDISPATCHER_H
+#define UPNPACTIONDISPATCHER_H
+
+#include "upnplibqt_export.h"
+
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QMetaType>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+class QObject;
+struct QMetaObject;
+class UpnpActionDescription;
+
+/**
+ * @brief The UpnpActionDispatcher class calls the Q_INVOKABLE methods implementing the actions of a service
+ *
+ * registerActions resolves each action to a method of the same name (or the same name starting with a lower case
+ * letter) once. The method takes the input arguments of the action by value or const reference, followed by its output
+ * arguments by non-const reference, in the order of the action description. It returns void or a bool that is false
+ * when the call is in error.
+ *
+ * The types of the arguments and the functions converting them from and to their string value are resolved at
+ * registration. A call is then one hash lookup of the action name and a direct meta call, without looking up methods
+ * by name or building QVariant lists.
+ */
+class UPNPLIBQT_EXPORT UpnpActionDispatcher
+{
+public:
+    /**
+     * @brief ArgumentReader converts the string value of an argument into storage constructed with type
+     */
+    using ArgumentReader = bool (*)(const QString &value, QMetaType type, void *storage);
+
+    /**
+     * @brief ArgumentWriter converts an argument constructed with type into its string value
+     */
+    using ArgumentWriter = QString (*)(QMetaType type, const void *storage);
+
+    /**
+     * @brief registerActions will resolve the method implementing each action in actions
+     *
+     * Actions without a matching method are skipped, they can still be handled by
+     * \class UpnpAbstractService::invokeAction.
+     *
+     * @return the number of actions that can be dispatched
+     */
+    int registerActions(const QMetaObject *metaObject, const QMap<QString, UpnpActionDescription> &actions);
+
+    void clear();
+
+    [[nodiscard]] bool hasAction(const QString &actionName) const;
+
+    /**
+     * @brief size is the number of actions that can be dispatched
+     */
+    [[nodiscard]] int size() const;
+
+    /**
+     * @brief dispatch will call the method implementing actionName on object
+     *
+     * @param inputArguments are the names and values of the input arguments in the order of the action description
+     * @param outputArguments receives the names and values of the output arguments
+     * @return false if the action is unknown, if the arguments do not have the names and the order of the action
+     * description or cannot be converted, or if the method reports an error
+     */
+    [[nodiscard]] bool dispatch(QObject *object,
+                                const QString &actionName,
+                                const QList<QPair<QString, QString>> &inputArguments,
+                                QList<QPair<QString, QString>> &outputArguments) const;
+
+private:
+    class Argument
+    {
+    public:
+        QString mName;
+
+        QMetaType mType;
+
+        /**
+         * @brief mOffset is the offset of the argument in the storage of a call
+         */
+        qsizetype mOffset = 0;
+
+        ArgumentReader mReader = nullptr;
+
+        ArgumentWriter mWriter = nullptr;
+    };
+
+    class Handler
+    {
+    public:
+        /**
+         * @brief mMethodIndex is the absolute index of the method given to QMetaObject::metacall
+         */
+        int mMethodIndex = -1;
+
+        bool mReturnsBool = false;
+
+        /**
+         * @brief mArguments are the input arguments followed by the output arguments, like the method parameters
+         */
+        QVector<Argument> mArguments;
+
+        int mNumberInArgument = 0;
+
+        /**
+         * @brief mStorageSize is the size in bytes needed to construct all the arguments of a call
+         */
+        qsizetype mStorageSize = 0;
+    };
+
+    [[nodiscard]] static bool resolveArgument(const QByteArray &typeName, Argument &argument);
+
+    QHash<QString, Handler> mHandlers;
+};
+
+#endif // UPNPACTIONDISPATCHER_H
@@ -0,0 +1,64 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpactionresult.h"
+
+#include <KDSoapClient/KDSoapMessage.h>
+#include <KDSoapClient/KDSoapPendingCall.h>
+
+UpnpActionResult UpnpActionResult::fromPendingCall(const KDSoapPendingCall &finishedCall)
+{
+    auto result = UpnpActionResult {};
+
+    const auto &returnMessage = finishedCall.returnMessage();
+
+    result.mSuccess = finishedCall.isFinished() && !returnMessage.isFault();
+    if (!result.mSuccess) {
+        result.mError = returnMessage.faultAsString();
+
+        // KDSoap reports network errors as faults whose code is the QNetworkReply::NetworkError value
+        auto isNumericFaultCode = false;
+        returnMessage.childValues().child(QStringLiteral("faultcode")).value().toString().toInt(&isNumericFaultCode);
+        result.mIsTransportError = !finishedCall.isFinished() || isNumericFaultCode;
+    }
+
+    const auto &returnedValues = returnMessage.childValues();
+    for (const auto &oneValue : returnedValues) {
+        result.mValues[oneValue.name()] = oneValue.value();
+    }
+
+    return result;
+}
+
+UpnpActionResult UpnpActionResult::fromError(const QString &errorMessage)
+{
+    auto result = UpnpActionResult {};
+
+    result.mError = errorMessage;
+
+    return result;
+}
+
+UpnpActionResult UpnpActionResult::fromTransportError(const QString &errorMessage)
+{
+    auto result = fromError(errorMessage);
+
+    result.mIsTransportError = true;
+
+    return result;
+}
+
+bool UpnpActionCompletion::isCanceled() const
+{
+    return mIsCanceled && mIsCanceled();
+}
+
+void UpnpActionCompletion::finish(const UpnpActionResult &result) const
+{
+    if (mFinished) {
+        mFinished(result);
+    }
+}
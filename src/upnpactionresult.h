@@ -0,0 +1,83 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef UPNPACTIONRESULT_H
+#define UPNPACTIONRESULT_H
+
+#include "upnplibqt_export.h"
+
+#include <QMetaType>
+#include <QString>
+#include <QVariantMap>
+
+#include <functional>
+
+class KDSoapPendingCall;
+
+/**
+ * @brief The UpnpActionResult class contains the answer to one action call
+ */
+class UPNPLIBQT_EXPORT UpnpActionResult
+{
+public:
+    bool mSuccess = false;
+
+    /**
+     * @brief mValues are the output arguments of the action indexed by their names
+     */
+    QVariantMap mValues;
+
+    QString mError;
+
+    /**
+     * @brief mIsTransportError is true when the call failed before the service could answer (network error or timeout)
+     *
+     * Errors returned by the service itself (UPnP errors) are not transport errors.
+     */
+    bool mIsTransportError = false;
+
+    [[nodiscard]] static UpnpActionResult fromPendingCall(const KDSoapPendingCall &finishedCall);
+
+    [[nodiscard]] static UpnpActionResult fromError(const QString &errorMessage);
+
+    [[nodiscard]] static UpnpActionResult fromTransportError(const QString &errorMessage);
+};
+
+/**
+ * @brief The UpnpActionCompletion class is what is called when an action call is finished
+ *
+ * It is a lightweight alternative to \class UpnpControlAbstractServiceReply: it is not a QObject and it is copied
+ * with the call until the answer is received.
+ */
+class UPNPLIBQT_EXPORT UpnpActionCompletion
+{
+public:
+    /**
+     * @brief mFinished receives the result of the call
+     */
+    std::function<void(const UpnpActionResult &)> mFinished;
+
+    /**
+     * @brief mIsCanceled returns true if nobody is waiting for the result anymore and the call does not need to be sent
+     */
+    std::function<bool()> mIsCanceled;
+
+    /**
+     * @brief mNotifiesCancellation is true when the caller tells the service that the call is canceled
+     *
+     * Replies are aborted with a signal. Canceled futures are not notified and are found by checking the calls
+     * regularly.
+     */
+    bool mNotifiesCancellation = false;
+
+    [[nodiscard]] bool isCanceled() const;
+
+    void finish(const UpnpActionResult &result) const;
+};
+
+Q_DECLARE_METATYPE(UpnpActionResult)
+
+#endif // UPNPACTIONRESULT_H
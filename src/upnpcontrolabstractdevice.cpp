@@ -10,36 +10,111 @@
 
 #include "upnpdevicedescription.h"
 #include "upnpservicedescription.h"
+#include "upnpsoapconnectionpool.h"
 
 #include <QDebug>
+#include <QHash>
 #include <QList>
 #include <QMap>
 #include <QPointer>
+#include <QSet>
 #include <QVariantMap>
 
 class UpnpControlAbstractDevicePrivate
 {
 public:
+    /**
+     * @brief mServices contains the proxies already created indexed by service id, they are owned by the device
+     */
+    QHash<QString, UpnpControlAbstractService *> mServices;
+
+    UpnpSoapConnectionPool mConnectionPool;
 };
 
 UpnpControlAbstractDevice::UpnpControlAbstractDevice(QObject *parent)
     : UpnpAbstractDevice(parent)
     , d(std::make_unique<UpnpControlAbstractDevicePrivate>())
 {
+    connect(this, &UpnpControlAbstractDevice::descriptionChanged, this, &UpnpControlAbstractDevice::refreshServices);
+}
+
+UpnpControlAbstractDevice::~UpnpControlAbstractDevice()
+{
+    qDeleteAll(d->mServices);
+}
+
+UpnpControlAbstractService *UpnpControlAbstractDevice::serviceById(const QString &serviceId) const
+{
+    auto *existingService = d->mServices.value(serviceId);
+    if (existingService) {
+        return existingService;
+    }
+
+    for (const auto &oneService : description().services()) {
+        if (oneService.serviceId() == serviceId) {
+            auto *result = serviceFromDescription(oneService).release();
+
+            d->mServices[serviceId] = result;
+
+            return result;
+        }
+    }
+
+    return nullptr;
 }
 
-UpnpControlAbstractDevice::~UpnpControlAbstractDevice() = default;
+UpnpControlAbstractService *UpnpControlAbstractDevice::serviceByIndex(int serviceIndex) const
+{
+    const auto &allServices = description().services();
+
+    if (serviceIndex < 0 || serviceIndex >= allServices.size()) {
+        return nullptr;
+    }
+
+    return serviceById(allServices[serviceIndex].serviceId());
+}
 
-std::unique_ptr<UpnpControlAbstractService> UpnpControlAbstractDevice::serviceById(const QString &serviceId) const
+UpnpSoapConnectionPool *UpnpControlAbstractDevice::connectionPool() const
 {
-    auto serviceDescription = serviceDescriptionById(serviceId);
-    return serviceFromDescription(serviceDescription);
+    return &d->mConnectionPool;
 }
 
-std::unique_ptr<UpnpControlAbstractService> UpnpControlAbstractDevice::serviceByIndex(int serviceIndex) const
+void UpnpControlAbstractDevice::refreshServices()
 {
-    auto serviceDescription = serviceDescriptionByIndex(serviceIndex);
-    return serviceFromDescription(serviceDescription);
+    QSet<QString> currentServiceIds;
+
+    for (const auto &oneService : description().services()) {
+        currentServiceIds.insert(oneService.serviceId());
+
+        auto *existingService = d->mServices.value(oneService.serviceId());
+        if (!existingService) {
+            continue;
+        }
+
+        auto newDescription = oneService;
+        const auto &oldDescription = existingService->description();
+
+        if (!newDescription.isSCPDLoaded() && oldDescription.isSCPDLoaded() && newDescription.SCPDURL() == oldDescription.SCPDURL()) {
+            newDescription.actions() = oldDescription.actions();
+            newDescription.stateVariables() = oldDescription.stateVariables();
+            newDescription.setSCPDHash(oldDescription.SCPDHash());
+            newDescription.setSCPDLoaded(true);
+        }
+
+        existingService->setDescription(newDescription);
+    }
+
+    // proxies of services that are no longer part of the device
+    for (auto itService = d->mServices.begin(); itService != d->mServices.end();) {
+        if (currentServiceIds.contains(itService.key())) {
+            ++itService;
+            continue;
+        }
+
+        // the proxy can be emitting the signal that triggered this refresh
+        itService.value()->deleteLater();
+        itService = d->mServices.erase(itService);
+    }
 }
 
 std::unique_ptr<UpnpControlAbstractService> UpnpControlAbstractDevice::serviceFromDescription(const UpnpServiceDescription &description) const
@@ -47,6 +122,7 @@ std::unique_ptr<UpnpControlAbstractService> UpnpControlAbstractDevice::serviceFr
     auto newService = std::make_unique<UpnpControlAbstractService>();
 
     newService->setDescription(description);
+    newService->setConnectionPool(&d->mConnectionPool);
 
     return newService;
 }
@@ -18,6 +18,7 @@
 class UpnpControlAbstractDevicePrivate;
 class QNetworkReply;
 class UpnpControlAbstractService;
+class UpnpSoapConnectionPool;
 
 class UPNPLIBQT_EXPORT UpnpControlAbstractDevice : public UpnpAbstractDevice
 {
@@ -29,9 +30,30 @@ public:
 
     ~UpnpControlAbstractDevice() override;
 
-    [[nodiscard]] std::unique_ptr<UpnpControlAbstractService> serviceById(const QString &serviceId) const;
-
-    [[nodiscard]] std::unique_ptr<UpnpControlAbstractService> serviceByIndex(int serviceIndex) const;
+    /**
+     * @brief serviceById returns the proxy used to control one service of this device
+     *
+     * The proxy is created on first use and then reused. It is owned by the device and stays valid as long as the
+     * device exists and the service is part of its description. Proxies of services removed from the description
+     * are deleted with deleteLater. Creating a proxy does not use the network: downloads, event subscriptions and SOAP
+     * connections are started on first use.
+     *
+     * @param serviceId is the id of the service in the device description
+     * @return the proxy or nullptr if there is no such service
+     */
+    [[nodiscard]] UpnpControlAbstractService *serviceById(const QString &serviceId) const;
+
+    /**
+     * @brief serviceByIndex returns the proxy used to control one service of this device
+     *
+     * See serviceById.
+     */
+    [[nodiscard]] UpnpControlAbstractService *serviceByIndex(int serviceIndex) const;
+
+    /**
+     * @brief connectionPool returns the pool of SOAP connections shared by all services of this device
+     */
+    [[nodiscard]] UpnpSoapConnectionPool *connectionPool() const;
 
 Q_SIGNALS:
 
@@ -41,6 +63,8 @@ public Q_SLOTS:
 
 private Q_SLOTS:
 
+    void refreshServices();
+
 protected:
     [[nodiscard]] std::unique_ptr<UpnpControlAbstractService> serviceFromDescription(const UpnpServiceDescription &description) const;
 
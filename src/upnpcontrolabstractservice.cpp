@@ -9,229 +9,1470 @@
 #include "upnplogging.h"
 
 #include "upnpbasictypes.h"
+#include "upnpeventpropertysetparser.h"
+#include "upnpeventsubscriptionscheduler.h"
 #include "upnphttpserver.h"
+#include "upnplastchangedecoder.h"
 #include "upnpservereventobject.h"
 
 #include "upnpactiondescription.h"
 #include "upnpservicedescription.h"
+#include "upnpservicedescriptionparser.h"
+#include "upnpsoapconnectionpool.h"
+#include "upnpstatevariabledescription.h"
 
 #include <KDSoapClient/KDSoapClientInterface.h>
 #include <KDSoapClient/KDSoapMessage.h>
+#include <KDSoapClient/KDSoapPendingCallWatcher.h>
 
 #include <QDnsLookup>
 #include <QHostInfo>
 #include <QNetworkAccessManager>
-#include <QNetworkInterface>
 #include <QNetworkReply>
 
-#include <QDomDocument>
-
 #include <QBuffer>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMetaObject>
 #include <QPointer>
+#include <QPromise>
+#include <QSet>
 #include <QTextStream>
+#include <QThread>
 #include <QTimer>
 
 #include <QLoggingCategory>
 
-class UpnpAbstractServiceDescriptionPrivate
+#include <limits>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @brief isSentArgument is false for invalid values and empty strings, without converting other values to a string
+ */
+static bool isSentArgument(const QVariant &value)
+{
+    switch (value.typeId()) {
+    case QMetaType::UnknownType:
+        return false;
+    case QMetaType::QString:
+        return !static_cast<const QString *>(value.constData())->isEmpty();
+    case QMetaType::QByteArray:
+        return !static_cast<const QByteArray *>(value.constData())->isEmpty();
+    default:
+        return true;
+    }
+}
+
+/**
+ * @brief The UpnpEventSubscriptionRequest enum tags the requests sent to the event URL of the service
+ */
+enum class UpnpEventSubscriptionRequest {
+    Subscribe = 1,
+    Renew,
+    Unsubscribe,
+};
+
+class UpnpPendingActionCall
+{
+public:
+    UpnpActionCompletion mCompletion;
+
+    QString mActionName;
+
+    QMap<QString, QVariant> mArguments;
+
+    /**
+     * @brief mDeadline is the time on UpnpAbstractServiceDescriptionPrivate::mActiveCallsClock when the call times out or -1
+     *
+     * The deadline includes the download of the service description.
+     */
+    qint64 mDeadline = -1;
+
+    /**
+     * @brief mIsSerialized is true for calls from callSerializedAction: mInputArgumentNames and mInputValues are sent
+     * instead of mArguments
+     */
+    bool mIsSerialized = false;
+
+    QList<QString> mInputArgumentNames;
+
+    QList<QString> mInputValues;
+};
+
+/**
+ * @brief The UpnpActiveActionCall class tracks one action call from the moment it is sent until its completion is called
+ */
+class UpnpActiveActionCall
+{
+public:
+    UpnpActionCompletion mCompletion;
+
+    QString mActionName;
+
+    KDSoapMessage mMessage;
+
+    QString mSoapAction;
+
+    int mTimeout = 0;
+
+    int mRetries = 0;
+
+    /**
+     * @brief mDeadline is the time on UpnpAbstractServiceDescriptionPrivate::mActiveCallsClock when the call times out or -1
+     */
+    qint64 mDeadline = -1;
+
+    /**
+     * @brief mRetryTime is the time on UpnpAbstractServiceDescriptionPrivate::mActiveCallsClock when the call is sent again or -1
+     */
+    qint64 mRetryTime = -1;
+
+    /**
+     * @brief mTransportId identifies the running request in mTransportPool or in the own SOAP client of the service, 0 if none
+     */
+    quint64 mTransportId = 0;
+
+    QPointer<UpnpSoapConnectionPool> mTransportPool;
+};
+
+/**
+ * @brief The UpnpActionInvocationPlan class contains everything needed to send one action that does not depend on the call
+ */
+class UpnpActionInvocationPlan
 {
 public:
-    QNetworkAccessManager mNetworkAccess;
+    QString mActionName;
 
+    QString mSoapAction;
+
+    /**
+     * @brief mInputArguments are the element names of the input arguments in the order of the service description
+     */
+    QList<QString> mInputArguments;
+};
+
+class UpnpAbstractServiceDescriptionPrivate
+{
+public:
     std::unique_ptr<KDSoapClientInterface> mInterface;
 
-    UpnpHttpServer mEventServer;
+    QPointer<UpnpSoapConnectionPool> mConnectionPool;
+
+    QPointer<UpnpHttpServer> mEventServer;
+
+    QString mEventCallbackPath;
 
-    QHostAddress mPublicAddress;
+    QString mEventSubscriptionId;
 
-    std::unique_ptr<QTimer> mEventSubscriptionTimer;
+    /**
+     * @brief mRequestedEventSubscriptionTimeout is the duration asked by subscribeEvents, used again to resubscribe
+     */
+    int mRequestedEventSubscriptionTimeout = 0;
 
+    /**
+     * @brief mRealEventSubscriptionTimeout is the duration granted by the service, 0 for an infinite subscription
+     */
     int mRealEventSubscriptionTimeout = 0;
+
+    /**
+     * @brief mEventSubscriptionRenewalId identifies the next renewal or retry in UpnpEventSubscriptionScheduler, 0 if none
+     */
+    quint64 mEventSubscriptionRenewalId = 0;
+
+    /**
+     * @brief mEventSubscriptionScheduler is the scheduler of mEventSubscriptionRenewalId, it can be destroyed before the service
+     */
+    QPointer<UpnpEventSubscriptionScheduler> mEventSubscriptionScheduler;
+
+    int mEventSubscriptionFailures = 0;
+
+    /**
+     * @brief mStaleEventSubscriptionId is the SID of the previous subscription, its late events are dropped
+     */
+    QString mStaleEventSubscriptionId;
+
+    /**
+     * @brief mExpectedEventSequence is the SEQ of the next event of the subscription or -1 before its first event
+     */
+    qint64 mExpectedEventSequence = -1;
+
+    /**
+     * @brief mEventResynchronizationPending is true from a resubscription caused by a gap until its initial event
+     */
+    bool mEventResynchronizationPending = false;
+
+    quint64 mEventSequenceGaps = 0;
+
+    quint64 mMissedEvents = 0;
+
+    quint64 mOutOfOrderEvents = 0;
+
+    quint64 mEventResynchronizations = 0;
+
+    QUrl mServiceDescriptionUrl;
+
+    bool mServiceDescriptionIsLoading = false;
+
+    QList<UpnpPendingActionCall> mPendingActionCalls;
+
+    /**
+     * @brief mPlannedActions is a shallow copy of the actions used to build mActionPlans
+     *
+     * The plans are rebuilt when the actions of the description are no longer shared with it.
+     */
+    QMap<QString, UpnpActionDescription> mPlannedActions;
+
+    QString mPlannedServiceType;
+
+    QList<UpnpActionInvocationPlan> mActionPlans;
+
+    QHash<QString, int> mActionPlanIndexes;
+
+    std::unordered_map<quint64, UpnpActiveActionCall> mActiveCalls;
+
+    quint64 mNextActiveCallId = 1;
+
+    /**
+     * @brief mRunningCalls are the requests sent with mInterface when no connection pool is used
+     */
+    QHash<quint64, KDSoapPendingCallWatcher *> mRunningCalls;
+
+    /**
+     * @brief mAbortedTransports are the requests of aborted calls still running on mInterface
+     *
+     * KDSoap cannot stop one request, they are stopped by destroying mInterface when no other call is running.
+     */
+    QList<KDSoapPendingCallWatcher *> mAbortedTransports;
+
+    quint64 mNextTransportId = 1;
+
+    QTimer mActiveCallsTimer;
+
+    QElapsedTimer mActiveCallsClock;
+
+    /**
+     * @brief mPollsCanceledCalls is true when calls whose cancellation is not notified may be active
+     */
+    bool mPollsCanceledCalls = false;
+
+    int mActionTimeout = 0;
+
+    int mMaximumRetries = 0;
+
+    int mRetryDelay = 500;
+
+    QSet<QString> mIdempotentActions;
+
+    quint64 mTimedOutCalls = 0;
+
+    quint64 mRetriedCalls = 0;
+
+    quint64 mAbortedCalls = 0;
+
+    /**
+     * @brief mStateVariableValues mirrors the state variables of the service from the received events
+     */
+    QVariantMap mStateVariableValues;
+
+    /**
+     * @brief mEventParser is kept to reuse its buffers for all event notifications of the service
+     */
+    UpnpEventPropertySetParser mEventParser;
+
+    /**
+     * @brief mLastChangeDecoder keeps the values of each instance of AV services given by LastChange events
+     */
+    UpnpLastChangeDecoder mLastChangeDecoder;
 };
 
 UpnpControlAbstractService::UpnpControlAbstractService(QObject *parent)
     : UpnpAbstractService(parent)
     , d(std::make_unique<UpnpAbstractServiceDescriptionPrivate>())
 {
-    connect(&d->mNetworkAccess, &QNetworkAccessManager::finished, this, &UpnpControlAbstractService::finishedDownload);
-
-    d->mEventServer.setService(this);
+    d->mActiveCallsTimer.setSingleShot(true);
+    d->mActiveCallsClock.start();
 
-    d->mEventServer.listen(QHostAddress::Any);
+    connect(&d->mActiveCallsTimer, &QTimer::timeout, this, &UpnpControlAbstractService::checkActiveCalls);
+    connect(this, &UpnpAbstractService::descriptionChanged, this, &UpnpControlAbstractService::convertStateVariableValues);
+}
 
-    const QList<QHostAddress> &list = QNetworkInterface::allAddresses();
-    for (const auto &address : list) {
-        if (!address.isLoopback()) {
-            if (address.protocol() == QAbstractSocket::IPv4Protocol) {
-                d->mPublicAddress = address;
-                break;
-            }
+UpnpControlAbstractService::~UpnpControlAbstractService()
+{
+    for (auto &oneCall : d->mActiveCalls) {
+        if (oneCall.second.mTransportPool) {
+            oneCall.second.mTransportPool->abort(oneCall.second.mTransportId);
         }
     }
+
+    cancelEventSubscriptionRenewal();
+
+    if (d->mEventServer) {
+        d->mEventServer->unregisterService(d->mEventCallbackPath);
+    }
 }
 
-UpnpControlAbstractService::~UpnpControlAbstractService() = default;
+UpnpControlAbstractServiceReply *UpnpControlAbstractService::callAction(const QString &actionName, const QMap<QString, QVariant> &arguments, int timeout)
+{
+    auto *newReply = new UpnpControlAbstractServiceReply(this);
+    connect(newReply, &UpnpControlAbstractServiceReply::aborted, this, &UpnpControlAbstractService::checkActiveCalls);
+    connect(newReply, &QObject::destroyed, this, &UpnpControlAbstractService::checkActiveCalls);
+
+    startAction(replyCompletion(newReply), actionName, arguments, timeout);
 
-UpnpControlAbstractServiceReply *UpnpControlAbstractService::callAction(const QString &actionName, const QMap<QString, QVariant> &arguments)
+    return newReply;
+}
+
+UpnpControlAbstractServiceReply *UpnpControlAbstractService::callAction(int actionIndex, const QVariantList &inputArguments, int timeout)
 {
-    KDSoapMessage message;
+    auto *newReply = new UpnpControlAbstractServiceReply(this);
+    connect(newReply, &UpnpControlAbstractServiceReply::aborted, this, &UpnpControlAbstractService::checkActiveCalls);
+    connect(newReply, &QObject::destroyed, this, &UpnpControlAbstractService::checkActiveCalls);
 
-    const UpnpActionDescription &actionDescription(action(actionName));
+    startAction(replyCompletion(newReply), actionIndex, inputArguments, timeout);
 
-    for (const auto &argumentDescription : actionDescription.mArguments) {
-        if (argumentDescription.mDirection == UpnpArgumentDirection::In &&
-                arguments[argumentDescription.mName].isValid() &&
-                !arguments[argumentDescription.mName].toString().isEmpty()) {
-            message.addArgument(argumentDescription.mName, arguments[argumentDescription.mName]);
-        }
+    return newReply;
+}
+
+UpnpControlAbstractServiceReply *UpnpControlAbstractService::callSerializedAction(int actionIndex, const QList<QString> &inputValues, int timeout)
+{
+    auto *newReply = new UpnpControlAbstractServiceReply(this);
+    connect(newReply, &UpnpControlAbstractServiceReply::aborted, this, &UpnpControlAbstractService::checkActiveCalls);
+    connect(newReply, &QObject::destroyed, this, &UpnpControlAbstractService::checkActiveCalls);
+
+    startSerializedAction(replyCompletion(newReply), actionIndex, inputValues, timeout);
+
+    return newReply;
+}
+
+UpnpControlAbstractServiceReply *
+UpnpControlAbstractService::callSerializedAction(const QString &actionName, const QList<QString> &inputArgumentNames, const QList<QString> &inputValues, int timeout)
+{
+    auto *newReply = new UpnpControlAbstractServiceReply(this);
+    connect(newReply, &UpnpControlAbstractServiceReply::aborted, this, &UpnpControlAbstractService::checkActiveCalls);
+    connect(newReply, &QObject::destroyed, this, &UpnpControlAbstractService::checkActiveCalls);
+
+    startSerializedAction(replyCompletion(newReply), actionName, inputArgumentNames, inputValues, timeout);
+
+    return newReply;
+}
+
+QFuture<UpnpActionResult> UpnpControlAbstractService::callActionAsync(const QString &actionName, const QMap<QString, QVariant> &arguments, int timeout)
+{
+    auto promise = std::make_shared<QPromise<UpnpActionResult>>();
+    promise->start();
+
+    auto result = promise->future();
+
+    startAction(promiseCompletion(promise), actionName, arguments, timeout);
+
+    return result;
+}
+
+QFuture<UpnpActionResult> UpnpControlAbstractService::callActionAsync(int actionIndex, const QVariantList &inputArguments, int timeout)
+{
+    auto promise = std::make_shared<QPromise<UpnpActionResult>>();
+    promise->start();
+
+    auto result = promise->future();
+
+    startAction(promiseCompletion(promise), actionIndex, inputArguments, timeout);
+
+    return result;
+}
+
+int UpnpControlAbstractService::actionIndex(const QString &actionName) const
+{
+    updateActionPlans();
+
+    return d->mActionPlanIndexes.value(actionName, -1);
+}
+
+QList<QString> UpnpControlAbstractService::actionInputArguments(int actionIndex) const
+{
+    updateActionPlans();
+
+    if (actionIndex < 0 || actionIndex >= d->mActionPlans.size()) {
+        return {};
     }
 
-    if (!d->mInterface) {
-        d->mInterface = std::make_unique<KDSoapClientInterface>(description().controlURL().toString(), description().serviceType());
-        d->mInterface->setSoapVersion(KDSoapClientInterface::SOAP1_1);
-        d->mInterface->setStyle(KDSoapClientInterface::RPCStyle);
+    return d->mActionPlans[actionIndex].mInputArguments;
+}
+
+void UpnpControlAbstractService::setConnectionPool(UpnpSoapConnectionPool *pool)
+{
+    d->mConnectionPool = pool;
+}
+
+UpnpSoapConnectionPool *UpnpControlAbstractService::connectionPool() const
+{
+    return d->mConnectionPool;
+}
+
+int UpnpControlAbstractService::actionTimeout() const
+{
+    return d->mActionTimeout;
+}
+
+int UpnpControlAbstractService::maximumRetries() const
+{
+    return d->mMaximumRetries;
+}
+
+int UpnpControlAbstractService::retryDelay() const
+{
+    return d->mRetryDelay;
+}
+
+void UpnpControlAbstractService::setIdempotentActions(const QList<QString> &actionNames)
+{
+    d->mIdempotentActions = QSet<QString>(actionNames.begin(), actionNames.end());
+}
+
+QList<QString> UpnpControlAbstractService::idempotentActions() const
+{
+    return d->mIdempotentActions.values();
+}
+
+int UpnpControlAbstractService::activeCalls() const
+{
+    return static_cast<int>(d->mActiveCalls.size());
+}
+
+quint64 UpnpControlAbstractService::timedOutCalls() const
+{
+    return d->mTimedOutCalls;
+}
+
+quint64 UpnpControlAbstractService::retriedCalls() const
+{
+    return d->mRetriedCalls;
+}
+
+quint64 UpnpControlAbstractService::abortedCalls() const
+{
+    return d->mAbortedCalls;
+}
+
+void UpnpControlAbstractService::resetCallStatistics()
+{
+    d->mTimedOutCalls = 0;
+    d->mRetriedCalls = 0;
+    d->mAbortedCalls = 0;
+}
+
+void UpnpControlAbstractService::setActionTimeout(int value)
+{
+    if (d->mActionTimeout == value || value < 0) {
+        return;
     }
 
-    return new UpnpControlAbstractServiceReply(d->mInterface->asyncCall(actionName, message, description().serviceType() + QStringLiteral("#") + actionName), this);
+    d->mActionTimeout = value;
+    Q_EMIT actionTimeoutChanged();
 }
 
-void UpnpControlAbstractService::subscribeEvents(int duration)
+void UpnpControlAbstractService::setMaximumRetries(int value)
 {
-    QString webServerAddess(QStringLiteral("<http://"));
+    if (d->mMaximumRetries == value || value < 0) {
+        return;
+    }
 
-    if (!d->mPublicAddress.isNull()) {
-        webServerAddess += d->mPublicAddress.toString();
-    } else {
-        webServerAddess += QStringLiteral("127.0.0.1");
+    d->mMaximumRetries = value;
+    Q_EMIT maximumRetriesChanged();
+}
+
+void UpnpControlAbstractService::setRetryDelay(int value)
+{
+    if (d->mRetryDelay == value || value < 0) {
+        return;
     }
 
-    webServerAddess += QStringLiteral(":") + QString::number(d->mEventServer.serverPort()) + QStringLiteral(">");
+    d->mRetryDelay = value;
+    Q_EMIT retryDelayChanged();
+}
+
+UpnpActionCompletion UpnpControlAbstractService::replyCompletion(UpnpControlAbstractServiceReply *reply)
+{
+    const auto replyGuard = QPointer<UpnpControlAbstractServiceReply>(reply);
 
-    QNetworkRequest myRequest(description().eventURL());
-    myRequest.setRawHeader("CALLBACK", webServerAddess.toUtf8());
-    myRequest.setRawHeader("NT", "upnp:event");
-    QString timeoutDefinition(QStringLiteral("Second-"));
-    timeoutDefinition += QString::number(duration);
-    myRequest.setRawHeader("TIMEOUT", timeoutDefinition.toLatin1());
+    auto completion = UpnpActionCompletion{[replyGuard](const UpnpActionResult &result) {
+                                               if (replyGuard) {
+                                                   replyGuard->finish(result);
+                                               }
+                                           },
+                                           [replyGuard]() {
+                                               return replyGuard.isNull() || replyGuard->isAborted();
+                                           }};
 
-    d->mNetworkAccess.sendCustomRequest(myRequest, "SUBSCRIBE");
+    // the service is told by the aborted and destroyed signals of the reply
+    completion.mNotifiesCancellation = true;
+
+    return completion;
 }
 
-void UpnpControlAbstractService::handleEventNotification(const QByteArray &requestData, const QMap<QByteArray, QByteArray> &headers)
+UpnpActionCompletion UpnpControlAbstractService::promiseCompletion(const std::shared_ptr<QPromise<UpnpActionResult>> &promise)
+{
+    return {[promise](const UpnpActionResult &result) {
+                promise->addResult(result);
+                promise->finish();
+            },
+            [promise]() {
+                return promise->isCanceled();
+            }};
+}
+
+void UpnpControlAbstractService::startAction(const UpnpActionCompletion &completion, const QString &actionName, const QMap<QString, QVariant> &arguments, int timeout)
 {
-    Q_UNUSED(headers)
+    if (!isServiceDescriptionLoaded()) {
+        const auto callTimeout = (timeout < 0 ? d->mActionTimeout : timeout);
+        const auto deadline = (callTimeout > 0 ? d->mActiveCallsClock.elapsed() + callTimeout : qint64{-1});
 
-    const QString &requestAnswer(QString::fromLatin1(requestData));
+        d->mPendingActionCalls.push_back({completion, actionName, arguments, deadline});
+        d->mPollsCanceledCalls = d->mPollsCanceledCalls || !completion.mNotifiesCancellation;
 
-    QDomDocument requestDocument;
-    requestDocument.setContent(requestAnswer);
+        scheduleActiveCallsCheck(deadline);
 
-    const QDomElement &eventRoot = requestDocument.documentElement();
+        loadServiceDescription();
 
-    const QDomElement &propertysetRoot = eventRoot.firstChildElement();
-    if (!propertysetRoot.isNull()) {
-        const QDomElement &propertyNode = propertysetRoot.firstChildElement();
-        if (!propertyNode.isNull()) {
-            QDomNode currentChild = propertyNode.firstChild();
-            if (!currentChild.isNull()) {
-                parseEventNotification(propertyNode.tagName(), currentChild.toCharacterData().data());
-            }
-        }
+        return;
     }
+
+    sendAction(completion, actionName, arguments, timeout);
 }
 
-void UpnpControlAbstractService::downloadServiceDescription(const QUrl &serviceUrl)
+void UpnpControlAbstractService::startSerializedAction(const UpnpActionCompletion &completion,
+                                                       const QString &actionName,
+                                                       const QList<QString> &inputArgumentNames,
+                                                       const QList<QString> &inputValues,
+                                                       int timeout)
 {
-    d->mNetworkAccess.get(QNetworkRequest(serviceUrl));
+    if (!isServiceDescriptionLoaded()) {
+        const auto callTimeout = (timeout < 0 ? d->mActionTimeout : timeout);
+        const auto deadline = (callTimeout > 0 ? d->mActiveCallsClock.elapsed() + callTimeout : qint64{-1});
+
+        d->mPendingActionCalls.push_back({completion, actionName, {}, deadline, true, inputArgumentNames, inputValues});
+        d->mPollsCanceledCalls = d->mPollsCanceledCalls || !completion.mNotifiesCancellation;
+
+        scheduleActiveCallsCheck(deadline);
+
+        loadServiceDescription();
+
+        return;
+    }
+
+    sendSerializedAction(completion, actionName, inputArgumentNames, inputValues, timeout);
 }
 
-void UpnpControlAbstractService::finishedDownload(QNetworkReply *reply)
+void UpnpControlAbstractService::startAction(const UpnpActionCompletion &completion, int actionIndex, const QVariantList &inputArguments, int timeout)
 {
-    if (reply->isFinished() && reply->error() == QNetworkReply::NoError) {
-        if (reply->url() == description().eventURL()) {
-            if (reply->hasRawHeader("TIMEOUT")) {
-                if (reply->rawHeader("TIMEOUT").startsWith("Second-")) {
-                    d->mRealEventSubscriptionTimeout = reply->rawHeader("TIMEOUT").mid(7).toInt();
-
-                    if (!d->mEventSubscriptionTimer) {
-                        d->mEventSubscriptionTimer = std::make_unique<QTimer>();
-                        connect(d->mEventSubscriptionTimer.get(), &QTimer::timeout, this, &UpnpControlAbstractService::eventSubscriptionTimeout);
-                        d->mEventSubscriptionTimer->setInterval(1000 * (d->mRealEventSubscriptionTimeout > 60 ? d->mRealEventSubscriptionTimeout - 60 : d->mRealEventSubscriptionTimeout));
-                        d->mEventSubscriptionTimer->start();
-                    }
-                }
-            }
-        } else {
-            parseServiceDescription(reply);
+    if (!checkActionIndex(completion, actionIndex)) {
+        return;
+    }
+
+    const auto &actionPlan = d->mActionPlans[actionIndex];
+
+    KDSoapMessage message;
+
+    const auto argumentsCount = qMin(actionPlan.mInputArguments.size(), inputArguments.size());
+    for (qsizetype i = 0; i < argumentsCount; ++i) {
+        if (inputArguments[i].isValid()) {
+            message.addArgument(actionPlan.mInputArguments[i], inputArguments[i]);
         }
-    } else if (reply->isFinished()) {
-        qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpAbstractServiceDescription::finishedDownload"
-                                       << "error";
     }
+
+    sendMessage(completion, actionPlan.mActionName, message, actionPlan.mSoapAction, timeout);
+}
+
+void UpnpControlAbstractService::startSerializedAction(const UpnpActionCompletion &completion, int actionIndex, const QList<QString> &inputValues, int timeout)
+{
+    if (!checkActionIndex(completion, actionIndex)) {
+        return;
+    }
+
+    const auto &actionPlan = d->mActionPlans[actionIndex];
+
+    KDSoapMessage message;
+
+    const auto argumentsCount = qMin(actionPlan.mInputArguments.size(), inputValues.size());
+    for (qsizetype i = 0; i < argumentsCount; ++i) {
+        message.addArgument(actionPlan.mInputArguments[i], inputValues[i]);
+    }
+
+    sendMessage(completion, actionPlan.mActionName, message, actionPlan.mSoapAction, timeout);
 }
 
-void UpnpControlAbstractService::eventSubscriptionTimeout()
+bool UpnpControlAbstractService::checkActionIndex(const UpnpActionCompletion &completion, int actionIndex)
 {
-    subscribeEvents(d->mRealEventSubscriptionTimeout);
+    updateActionPlans();
+
+    if (actionIndex >= 0 && actionIndex < d->mActionPlans.size()) {
+        return true;
+    }
+
+    QMetaObject::invokeMethod(
+        this,
+        [completion]() {
+            completion.finish(UpnpActionResult::fromError(QStringLiteral("invalid action index")));
+        },
+        Qt::QueuedConnection);
+
+    return false;
 }
 
-void UpnpControlAbstractService::parseServiceDescription(QIODevice *serviceDescriptionContent)
+void UpnpControlAbstractService::sendAction(const UpnpActionCompletion &completion, const QString &actionName, const QMap<QString, QVariant> &arguments, int timeout)
 {
-    QDomDocument serviceDescriptionDocument;
-    serviceDescriptionDocument.setContent(serviceDescriptionContent);
+    KDSoapMessage message;
 
-    const QDomElement &scpdRoot = serviceDescriptionDocument.documentElement();
+    updateActionPlans();
+
+    const auto actionPlanIndex = d->mActionPlanIndexes.value(actionName, -1);
+    if (actionPlanIndex == -1) {
+        sendMessage(completion, actionName, message, description().serviceType() + QStringLiteral("#") + actionName, timeout);
+        return;
+    }
 
-    const QDomElement &actionListRoot = scpdRoot.firstChildElement(QStringLiteral("actionList"));
-    QDomNode currentChild = actionListRoot.firstChild();
-    while (!currentChild.isNull()) {
-        const QDomNode &nameNode = currentChild.firstChildElement(QStringLiteral("name"));
+    const auto &actionPlan = d->mActionPlans[actionPlanIndex];
 
-        QString actionName;
-        if (!nameNode.isNull()) {
-            actionName = nameNode.toElement().text();
+    for (const auto &argumentName : actionPlan.mInputArguments) {
+        auto itArgument = arguments.constFind(argumentName);
+        if (itArgument != arguments.constEnd() && isSentArgument(*itArgument)) {
+            message.addArgument(argumentName, *itArgument);
         }
+    }
+
+    sendMessage(completion, actionPlan.mActionName, message, actionPlan.mSoapAction, timeout);
+}
 
-        UpnpActionDescription newAction;
+void UpnpControlAbstractService::sendSerializedAction(const UpnpActionCompletion &completion,
+                                                      const QString &actionName,
+                                                      const QList<QString> &inputArgumentNames,
+                                                      const QList<QString> &inputValues,
+                                                      int timeout)
+{
+    KDSoapMessage message;
 
-        newAction.mName = actionName;
+    updateActionPlans();
 
-        const QDomNode &argumentListNode = currentChild.firstChildElement(QStringLiteral("argumentList"));
-        QDomNode argumentNode = argumentListNode.firstChild();
-        while (!argumentNode.isNull()) {
-            const QDomNode &argumentNameNode = argumentNode.firstChildElement(QStringLiteral("name"));
-            const QDomNode &argumentDirectionNode = argumentNode.firstChildElement(QStringLiteral("direction"));
-            const QDomNode &argumentRetvalNode = argumentNode.firstChildElement(QStringLiteral("retval"));
-            const QDomNode &argumentRelatedStateVariableNode = argumentNode.firstChildElement(QStringLiteral("relatedStateVariable"));
+    const auto argumentsCount = qMin(inputArgumentNames.size(), inputValues.size());
 
-            UpnpActionArgumentDescription newArgument;
-            newArgument.mName = argumentNameNode.toElement().text();
-            newArgument.mDirection = (argumentDirectionNode.toElement().text() == QStringLiteral("in") ? UpnpArgumentDirection::In : UpnpArgumentDirection::Out);
-            newArgument.mIsReturnValue = !argumentRetvalNode.isNull();
-            newArgument.mRelatedStateVariable = argumentRelatedStateVariableNode.toElement().text();
+    const auto actionPlanIndex = d->mActionPlanIndexes.value(actionName, -1);
+    if (actionPlanIndex == -1) {
+        for (qsizetype i = 0; i < argumentsCount; ++i) {
+            message.addArgument(inputArgumentNames[i], inputValues[i]);
+        }
 
-            newAction.mArguments.push_back(newArgument);
+        sendMessage(completion, actionName, message, description().serviceType() + QStringLiteral("#") + actionName, timeout);
+        return;
+    }
 
-            addAction(newAction);
+    const auto &actionPlan = d->mActionPlans[actionPlanIndex];
 
-            argumentNode = argumentNode.nextSibling();
+    // the arguments are sent in the order of the service description
+    for (const auto &argumentName : actionPlan.mInputArguments) {
+        const auto argumentIndex = inputArgumentNames.indexOf(argumentName);
+        if (argumentIndex >= 0 && argumentIndex < argumentsCount) {
+            message.addArgument(argumentName, inputValues[argumentIndex]);
         }
+    }
+
+    sendMessage(completion, actionPlan.mActionName, message, actionPlan.mSoapAction, timeout);
+}
+
+void UpnpControlAbstractService::sendMessage(const UpnpActionCompletion &completion, const QString &actionName, const KDSoapMessage &message, const QString &soapAction, int timeout)
+{
+    if (completion.isCanceled()) {
+        return;
+    }
+
+    const auto callId = d->mNextActiveCallId++;
+
+    auto &newCall = d->mActiveCalls[callId];
+    newCall.mCompletion = completion;
+    newCall.mActionName = actionName;
+    newCall.mMessage = message;
+    newCall.mSoapAction = soapAction;
+    newCall.mTimeout = (timeout < 0 ? d->mActionTimeout : timeout);
+
+    d->mPollsCanceledCalls = d->mPollsCanceledCalls || !completion.mNotifiesCancellation;
 
-        currentChild = currentChild.nextSibling();
+    transmitActiveCall(callId);
+}
+
+void UpnpControlAbstractService::transmitActiveCall(quint64 callId)
+{
+    auto itCall = d->mActiveCalls.find(callId);
+    if (itCall == d->mActiveCalls.end()) {
+        return;
     }
 
-#if 0
-    const QDomElement &serviceStateTableRoot = scpdRoot.firstChildElement(QStringLiteral("serviceStateTable"));
-    currentChild = serviceStateTableRoot.firstChild();
-    while (!currentChild.isNull()) {
-        const QDomNode &nameNode = currentChild.firstChildElement(QStringLiteral("name"));
-        if (!nameNode.isNull()) {
-            qCDebug(orgKdeUpnpLibQtUpnp()) << "state variable name" << nameNode.toElement().text();
+    auto &activeCall = itCall->second;
+    const auto now = d->mActiveCallsClock.elapsed();
+
+    activeCall.mRetryTime = -1;
+    activeCall.mDeadline = (activeCall.mTimeout > 0 ? now + activeCall.mTimeout : -1);
+
+    const auto serviceGuard = QPointer<UpnpControlAbstractService>(this);
+    const auto transportCompletion = UpnpActionCompletion{[serviceGuard, callId](const UpnpActionResult &result) {
+                                                              if (serviceGuard) {
+                                                                  serviceGuard->activeCallFinished(callId, result);
+                                                              }
+                                                          },
+                                                          [serviceGuard, callId]() {
+                                                              return !serviceGuard || serviceGuard->d->mActiveCalls.count(callId) == 0;
+                                                          }};
+
+    if (d->mConnectionPool) {
+        activeCall.mTransportPool = d->mConnectionPool;
+        activeCall.mTransportId =
+            d->mConnectionPool->call(transportCompletion, description().controlURL(), description().serviceType(), activeCall.mActionName, activeCall.mMessage, activeCall.mSoapAction);
+    } else {
+        if (!d->mInterface) {
+            d->mInterface = std::make_unique<KDSoapClientInterface>(description().controlURL().toString(), description().serviceType());
+            d->mInterface->setSoapVersion(KDSoapClientInterface::SOAP1_1);
+            d->mInterface->setStyle(KDSoapClientInterface::RPCStyle);
         }
 
-        currentChild = currentChild.nextSibling();
+        const auto transportId = d->mNextTransportId++;
+
+        auto *callWatcher = new KDSoapPendingCallWatcher(d->mInterface->asyncCall(activeCall.mActionName, activeCall.mMessage, activeCall.mSoapAction), this);
+        d->mRunningCalls[transportId] = callWatcher;
+
+        connect(callWatcher, &KDSoapPendingCallWatcher::finished, this, [this, transportId, transportCompletion](KDSoapPendingCallWatcher *watcher) {
+            watcher->deleteLater();
+
+            d->mRunningCalls.remove(transportId);
+
+            if (d->mRunningCalls.isEmpty() && !d->mAbortedTransports.isEmpty()) {
+                // the client cannot be destroyed while it delivers an answer
+                QMetaObject::invokeMethod(this, &UpnpControlAbstractService::closeAbortedTransports, Qt::QueuedConnection);
+            }
+
+            transportCompletion.finish(UpnpActionResult::fromPendingCall(*watcher));
+        });
+
+        activeCall.mTransportPool = nullptr;
+        activeCall.mTransportId = transportId;
+    }
+
+    scheduleActiveCallsCheck(activeCall.mDeadline);
+}
+
+void UpnpControlAbstractService::activeCallFinished(quint64 callId, const UpnpActionResult &result)
+{
+    auto itCall = d->mActiveCalls.find(callId);
+    if (itCall == d->mActiveCalls.end()) {
+        return;
+    }
+
+    auto &activeCall = itCall->second;
+    activeCall.mTransportId = 0;
+
+    if (!result.mSuccess && result.mIsTransportError && canRetry(activeCall)) {
+        qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpControlAbstractService::activeCallFinished" << activeCall.mActionName << "retry after" << result.mError;
+
+        scheduleRetry(activeCall, d->mActiveCallsClock.elapsed());
+        scheduleActiveCallsCheck(activeCall.mRetryTime);
+
+        return;
+    }
+
+    const auto completion = std::move(activeCall.mCompletion);
+    d->mActiveCalls.erase(itCall);
+
+    completion.finish(result);
+}
+
+void UpnpControlAbstractService::abortTransport(UpnpActiveActionCall &activeCall)
+{
+    if (!activeCall.mTransportId) {
+        return;
+    }
+
+    const auto transportId = std::exchange(activeCall.mTransportId, 0);
+
+    if (activeCall.mTransportPool) {
+        activeCall.mTransportPool->abort(transportId);
+        return;
+    }
+
+    auto *callWatcher = d->mRunningCalls.take(transportId);
+    if (!callWatcher) {
+        return;
+    }
+
+    callWatcher->disconnect(this);
+
+    // the request keeps running until its answer or until the client is destroyed
+    d->mAbortedTransports.push_back(callWatcher);
+    connect(callWatcher, &KDSoapPendingCallWatcher::finished, this, [this](KDSoapPendingCallWatcher *watcher) {
+        d->mAbortedTransports.removeOne(watcher);
+        watcher->deleteLater();
+    });
+
+    closeAbortedTransports();
+}
+
+void UpnpControlAbstractService::closeAbortedTransports()
+{
+    if (!d->mRunningCalls.isEmpty() || d->mAbortedTransports.isEmpty()) {
+        return;
+    }
+
+    for (auto *oneWatcher : std::as_const(d->mAbortedTransports)) {
+        oneWatcher->disconnect(this);
+        oneWatcher->deleteLater();
+    }
+    d->mAbortedTransports.clear();
+
+    // destroying the client closes its connections, the only way to stop a request that does not answer
+    d->mInterface.reset();
+}
+
+bool UpnpControlAbstractService::canRetry(const UpnpActiveActionCall &activeCall) const
+{
+    return activeCall.mRetries < d->mMaximumRetries && d->mIdempotentActions.contains(activeCall.mActionName) && !activeCall.mCompletion.isCanceled();
+}
+
+void UpnpControlAbstractService::scheduleRetry(UpnpActiveActionCall &activeCall, qint64 now)
+{
+    ++activeCall.mRetries;
+    ++d->mRetriedCalls;
+
+    activeCall.mDeadline = -1;
+    activeCall.mRetryTime = now + (static_cast<qint64>(d->mRetryDelay) << qMin(activeCall.mRetries - 1, 10));
+}
+
+void UpnpControlAbstractService::scheduleActiveCallsCheck(qint64 eventTime)
+{
+    if (d->mActiveCalls.empty() && d->mPendingActionCalls.isEmpty()) {
+        d->mActiveCallsTimer.stop();
+        return;
+    }
+
+    // canceled futures are not notified, they are noticed by checking the calls twice per second
+    static const qint64 cancelCheckInterval = 500;
+
+    if (eventTime == -1 && !d->mPollsCanceledCalls) {
+        return;
+    }
+
+    const auto now = d->mActiveCallsClock.elapsed();
+    auto interval = (eventTime == -1 ? cancelCheckInterval : qBound(qint64{0}, eventTime - now, qint64{std::numeric_limits<int>::max()}));
+    if (d->mPollsCanceledCalls) {
+        interval = qMin(interval, cancelCheckInterval);
+    }
+
+    if (!d->mActiveCallsTimer.isActive() || d->mActiveCallsTimer.remainingTime() > interval) {
+        d->mActiveCallsTimer.start(static_cast<int>(interval));
+    }
+}
+
+void UpnpControlAbstractService::checkActiveCalls()
+{
+    const auto now = d->mActiveCallsClock.elapsed();
+
+    QList<QPair<UpnpActionCompletion, UpnpActionResult>> finishedCalls;
+    QList<quint64> retriedCalls;
+    auto nextEventTime = qint64{-1};
+    auto pollsCanceledCalls = false;
+
+    for (auto itPendingCall = d->mPendingActionCalls.begin(); itPendingCall != d->mPendingActionCalls.end();) {
+        if (itPendingCall->mCompletion.isCanceled()) {
+            ++d->mAbortedCalls;
+
+            itPendingCall = d->mPendingActionCalls.erase(itPendingCall);
+            continue;
+        }
+
+        if (itPendingCall->mDeadline != -1 && now >= itPendingCall->mDeadline) {
+            qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpControlAbstractService::checkActiveCalls" << itPendingCall->mActionName << "timed out while loading the service description";
+
+            ++d->mTimedOutCalls;
+            finishedCalls.push_back({std::move(itPendingCall->mCompletion), UpnpActionResult::fromTransportError(QStringLiteral("action call timed out"))});
+
+            itPendingCall = d->mPendingActionCalls.erase(itPendingCall);
+            continue;
+        }
+
+        if (itPendingCall->mDeadline != -1 && (nextEventTime == -1 || itPendingCall->mDeadline < nextEventTime)) {
+            nextEventTime = itPendingCall->mDeadline;
+        }
+        pollsCanceledCalls = pollsCanceledCalls || !itPendingCall->mCompletion.mNotifiesCancellation;
+
+        ++itPendingCall;
+    }
+
+    for (auto itCall = d->mActiveCalls.begin(); itCall != d->mActiveCalls.end();) {
+        auto &activeCall = itCall->second;
+
+        if (activeCall.mCompletion.isCanceled()) {
+            abortTransport(activeCall);
+            ++d->mAbortedCalls;
+
+            itCall = d->mActiveCalls.erase(itCall);
+            continue;
+        }
+
+        if (activeCall.mTransportId && activeCall.mDeadline != -1 && now >= activeCall.mDeadline) {
+            qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpControlAbstractService::checkActiveCalls" << activeCall.mActionName << "timed out";
+
+            abortTransport(activeCall);
+            ++d->mTimedOutCalls;
+
+            if (!canRetry(activeCall)) {
+                finishedCalls.push_back({std::move(activeCall.mCompletion), UpnpActionResult::fromTransportError(QStringLiteral("action call timed out"))});
+
+                itCall = d->mActiveCalls.erase(itCall);
+                continue;
+            }
+
+            scheduleRetry(activeCall, now);
+        }
+
+        if (activeCall.mRetryTime != -1 && now >= activeCall.mRetryTime) {
+            retriedCalls.push_back(itCall->first);
+        } else {
+            const auto callEventTime = (activeCall.mRetryTime != -1 ? activeCall.mRetryTime : activeCall.mDeadline);
+            if (callEventTime != -1 && (nextEventTime == -1 || callEventTime < nextEventTime)) {
+                nextEventTime = callEventTime;
+            }
+        }
+        pollsCanceledCalls = pollsCanceledCalls || !activeCall.mCompletion.mNotifiesCancellation;
+
+        ++itCall;
+    }
+
+    d->mActiveCallsTimer.stop();
+    d->mPollsCanceledCalls = pollsCanceledCalls;
+
+    for (const auto oneCallId : retriedCalls) {
+        transmitActiveCall(oneCallId);
+    }
+
+    scheduleActiveCallsCheck(nextEventTime);
+
+    for (const auto &oneCall : finishedCalls) {
+        oneCall.first.finish(oneCall.second);
+    }
+}
+
+void UpnpControlAbstractService::updateActionPlans() const
+{
+    const auto &allActions = description().actions();
+
+    if (d->mPlannedActions.isSharedWith(allActions) && d->mPlannedServiceType == description().serviceType()) {
+        return;
+    }
+
+    d->mPlannedActions = allActions;
+    d->mPlannedServiceType = description().serviceType();
+    d->mActionPlans.clear();
+    d->mActionPlanIndexes.clear();
+
+    d->mActionPlans.reserve(allActions.size());
+    d->mActionPlanIndexes.reserve(allActions.size());
+
+    for (const auto &oneAction : allActions) {
+        UpnpActionInvocationPlan newPlan;
+
+        newPlan.mActionName = oneAction.mName;
+        newPlan.mSoapAction = d->mPlannedServiceType + QStringLiteral("#") + oneAction.mName;
+        newPlan.mInputArguments.reserve(oneAction.mNumberInArgument);
+
+        for (const auto &oneArgument : oneAction.mArguments) {
+            if (oneArgument.mDirection == UpnpArgumentDirection::In) {
+                newPlan.mInputArguments.push_back(oneArgument.mName);
+            }
+        }
+
+        d->mActionPlanIndexes[newPlan.mActionName] = static_cast<int>(d->mActionPlans.size());
+        d->mActionPlans.push_back(std::move(newPlan));
+    }
+}
+
+void UpnpControlAbstractService::subscribeEvents(int duration)
+{
+    // the data types of the state variables are needed to convert the evented values
+    loadServiceDescription();
+
+    if (!d->mEventServer) {
+        d->mEventServer = UpnpHttpServer::eventServer();
+        d->mEventCallbackPath = d->mEventServer->registerService(this);
+    }
+
+    d->mRequestedEventSubscriptionTimeout = duration;
+    d->mExpectedEventSequence = -1;
+    if (!d->mEventSubscriptionId.isEmpty()) {
+        d->mStaleEventSubscriptionId = std::exchange(d->mEventSubscriptionId, {});
+    }
+    cancelEventSubscriptionRenewal();
+
+    const QString webServerAddess(QStringLiteral("<") + d->mEventServer->callbackUrl(d->mEventCallbackPath) + QStringLiteral(">"));
+
+    QNetworkRequest myRequest(description().eventURL());
+    myRequest.setAttribute(QNetworkRequest::User, static_cast<int>(UpnpEventSubscriptionRequest::Subscribe));
+    myRequest.setRawHeader("CALLBACK", webServerAddess.toUtf8());
+    myRequest.setRawHeader("NT", "upnp:event");
+    QString timeoutDefinition(QStringLiteral("Second-"));
+    timeoutDefinition += QString::number(duration);
+    myRequest.setRawHeader("TIMEOUT", timeoutDefinition.toLatin1());
+
+    watchReply(networkAccess()->sendCustomRequest(myRequest, "SUBSCRIBE"));
+}
+
+void UpnpControlAbstractService::renewEventSubscription()
+{
+    if (d->mEventSubscriptionId.isEmpty()) {
+        subscribeEvents(d->mRequestedEventSubscriptionTimeout);
+        return;
+    }
+
+    cancelEventSubscriptionRenewal();
+
+    QNetworkRequest myRequest(description().eventURL());
+    myRequest.setAttribute(QNetworkRequest::User, static_cast<int>(UpnpEventSubscriptionRequest::Renew));
+    myRequest.setRawHeader("SID", d->mEventSubscriptionId.toLatin1());
+    QString timeoutDefinition(QStringLiteral("Second-"));
+    timeoutDefinition += QString::number(d->mRequestedEventSubscriptionTimeout);
+    myRequest.setRawHeader("TIMEOUT", timeoutDefinition.toLatin1());
+
+    watchReply(networkAccess()->sendCustomRequest(myRequest, "SUBSCRIBE"));
+}
+
+void UpnpControlAbstractService::unsubscribeEvents()
+{
+    cancelEventSubscriptionRenewal();
+
+    if (d->mEventSubscriptionId.isEmpty()) {
+        return;
+    }
+
+    QNetworkRequest myRequest(description().eventURL());
+    myRequest.setAttribute(QNetworkRequest::User, static_cast<int>(UpnpEventSubscriptionRequest::Unsubscribe));
+    myRequest.setRawHeader("SID", d->mEventSubscriptionId.toLatin1());
+
+    watchReply(networkAccess()->sendCustomRequest(myRequest, "UNSUBSCRIBE"));
+
+    d->mStaleEventSubscriptionId = std::exchange(d->mEventSubscriptionId, {});
+}
+
+QString UpnpControlAbstractService::eventSubscriptionId() const
+{
+    return d->mEventSubscriptionId;
+}
+
+void UpnpControlAbstractService::cancelEventSubscriptionRenewal()
+{
+    // the shared scheduler is not looked up again, it would be created again during the teardown of the application
+    if (d->mEventSubscriptionRenewalId && d->mEventSubscriptionScheduler) {
+        d->mEventSubscriptionScheduler->cancel(d->mEventSubscriptionRenewalId);
+    }
+
+    d->mEventSubscriptionRenewalId = 0;
+}
+
+void UpnpControlAbstractService::eventSubscriptionFinished(QNetworkReply *reply)
+{
+    const auto requestKind = static_cast<UpnpEventSubscriptionRequest>(reply->request().attribute(QNetworkRequest::User).toInt());
+    if (requestKind == UpnpEventSubscriptionRequest::Unsubscribe) {
+        return;
+    }
+
+    auto *scheduler = UpnpEventSubscriptionScheduler::instance();
+
+    if (reply->error() != QNetworkReply::NoError) {
+        const auto httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+        qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpControlAbstractService::eventSubscriptionFinished"
+                                       << "error" << httpStatus << reply->errorString();
+
+        if (requestKind == UpnpEventSubscriptionRequest::Renew && httpStatus == 412) {
+            // the service does not know the SID anymore (expired or the device rebooted)
+            d->mEventSubscriptionId.clear();
+            subscribeEvents(d->mRequestedEventSubscriptionTimeout);
+            return;
+        }
+
+        // retry with exponential backoff, capped to one minute
+        const auto retryDelay = qMin<qint64>(1000LL << qMin(d->mEventSubscriptionFailures, 6), 60000);
+        ++d->mEventSubscriptionFailures;
+
+        cancelEventSubscriptionRenewal();
+        d->mEventSubscriptionScheduler = scheduler;
+        d->mEventSubscriptionRenewalId = scheduler->schedule(retryDelay, this, [this]() {
+            d->mEventSubscriptionRenewalId = 0;
+            renewEventSubscription();
+        });
+
+        return;
+    }
+
+    d->mEventSubscriptionFailures = 0;
+
+    if (reply->hasRawHeader("SID")) {
+        d->mEventSubscriptionId = QString::fromLatin1(reply->rawHeader("SID"));
+
+        if (d->mEventServer) {
+            d->mEventServer->setSubscriptionId(d->mEventCallbackPath, d->mEventSubscriptionId);
+        }
+    }
+
+    d->mRealEventSubscriptionTimeout = 0;
+    const auto &timeoutHeader = reply->rawHeader("TIMEOUT");
+    if (timeoutHeader.startsWith("Second-")) {
+        d->mRealEventSubscriptionTimeout = timeoutHeader.mid(7).toInt();
+    }
+
+    cancelEventSubscriptionRenewal();
+    if (d->mRealEventSubscriptionTimeout > 0) {
+        d->mEventSubscriptionScheduler = scheduler;
+        d->mEventSubscriptionRenewalId = scheduler->scheduleRenewal(d->mRealEventSubscriptionTimeout, this, [this]() {
+            d->mEventSubscriptionRenewalId = 0;
+            renewEventSubscription();
+        });
+    }
+}
+
+void UpnpControlAbstractService::handleEventNotification(const QByteArray &requestData, const QMap<QByteArray, QByteArray> &headers)
+{
+    if (!checkEventSequence(headers)) {
+        return;
+    }
+
+    const auto parsed = d->mEventParser.parse(requestData, [this](QStringView variableName, QStringView variableValue) {
+        const auto &name = variableName.toString();
+        const auto &newValue = typedStateVariableValue(name, variableValue);
+
+        updateStateVariable(name, newValue);
+
+        // a string value already holds a copy of the text, it is shared instead of copied again
+        const auto &textValue = newValue.metaType().id() == QMetaType::QString ? newValue.toString() : variableValue.toString();
+        parseEventNotification(name, textValue);
+
+        if (name == QLatin1String("LastChange")) {
+            decodeLastChange(textValue);
+        }
+    });
+
+    if (!parsed) {
+        qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpControlAbstractService::handleEventNotification"
+                                       << "invalid event notification" << d->mEventParser.errorString();
+    }
+
+    Q_EMIT eventNotificationProcessed();
+}
+
+bool UpnpControlAbstractService::checkEventSequence(const QMap<QByteArray, QByteArray> &headers)
+{
+    const auto &subscriptionId = headers.value("sid");
+    if (!subscriptionId.isEmpty() && !d->mStaleEventSubscriptionId.isEmpty() && subscriptionId == d->mStaleEventSubscriptionId.toLatin1()) {
+        qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpControlAbstractService::checkEventSequence"
+                                       << "event of previous subscription" << subscriptionId;
+        return false;
+    }
+
+    bool isValidSequence = false;
+    const auto sequence = headers.value("seq").toUInt(&isValidSequence);
+    if (!isValidSequence) {
+        return true;
+    }
+
+    // SEQ is a 32 bits counter starting at 0 with the initial event and wrapping to 1
+    const auto nextSequence = [](quint32 value) -> qint64 {
+        return value == std::numeric_limits<quint32>::max() ? 1 : static_cast<qint64>(value) + 1;
+    };
+
+    if (sequence == 0 || d->mExpectedEventSequence == -1) {
+        d->mEventResynchronizationPending = false;
+        d->mExpectedEventSequence = nextSequence(sequence);
+        return true;
+    }
+
+    const auto expectedSequence = static_cast<quint32>(d->mExpectedEventSequence);
+    if (sequence == expectedSequence) {
+        d->mExpectedEventSequence = nextSequence(sequence);
+        return true;
+    }
+
+    const quint32 distance = sequence - expectedSequence;
+    if (distance > std::numeric_limits<quint32>::max() / 2) {
+        // an event older than the last one received, its values are outdated
+        ++d->mOutOfOrderEvents;
+        return false;
+    }
+
+    const auto missedEvents = (sequence < expectedSequence ? distance - 1 : distance);
+
+    ++d->mEventSequenceGaps;
+    d->mMissedEvents += missedEvents;
+    d->mExpectedEventSequence = nextSequence(sequence);
+
+    qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpControlAbstractService::checkEventSequence"
+                                   << "missed" << missedEvents << "events before" << sequence;
+
+    Q_EMIT eventSequenceGapDetected(expectedSequence, sequence);
+
+    if (!d->mEventResynchronizationPending) {
+        // a new subscription starts with an initial event giving the value of all evented state variables
+        d->mEventResynchronizationPending = true;
+        ++d->mEventResynchronizations;
+
+        const auto duration = d->mRequestedEventSubscriptionTimeout;
+        unsubscribeEvents();
+        subscribeEvents(duration);
+    }
+
+    return true;
+}
+
+quint64 UpnpControlAbstractService::eventSequenceGaps() const
+{
+    return d->mEventSequenceGaps;
+}
+
+quint64 UpnpControlAbstractService::missedEvents() const
+{
+    return d->mMissedEvents;
+}
+
+quint64 UpnpControlAbstractService::outOfOrderEvents() const
+{
+    return d->mOutOfOrderEvents;
+}
+
+quint64 UpnpControlAbstractService::eventResynchronizations() const
+{
+    return d->mEventResynchronizations;
+}
+
+void UpnpControlAbstractService::resetEventStatistics()
+{
+    d->mEventSequenceGaps = 0;
+    d->mMissedEvents = 0;
+    d->mOutOfOrderEvents = 0;
+    d->mEventResynchronizations = 0;
+}
+
+QVariant UpnpControlAbstractService::stateVariableValue(const QString &variableName) const
+{
+    return d->mStateVariableValues.value(variableName);
+}
+
+QVariantMap UpnpControlAbstractService::stateVariableValues() const
+{
+    return d->mStateVariableValues;
+}
+
+QVariant UpnpControlAbstractService::instanceStateVariableValue(quint32 instanceId, const QString &variableName, const QString &channel) const
+{
+    const auto &textValue = d->mLastChangeDecoder.value(instanceId, variableName, channel);
+    if (textValue.isNull()) {
+        return {};
+    }
+
+    return typedStateVariableValue(variableName, textValue);
+}
+
+QVariant UpnpControlAbstractService::typedStateVariableValue(const QString &variableName, QStringView textValue) const
+{
+    const auto &allStateVariables = description().stateVariables();
+
+    const auto itStateVariable = allStateVariables.constFind(variableName);
+    if (itStateVariable == allStateVariables.constEnd()) {
+        return textValue.toString();
+    }
+
+    return itStateVariable->typedValue(textValue);
+}
+
+void UpnpControlAbstractService::updateStateVariable(const QString &variableName, const QVariant &newValue)
+{
+    auto &currentValue = d->mStateVariableValues[variableName];
+    if (currentValue == newValue && currentValue.metaType() == newValue.metaType()) {
+        return;
+    }
+
+    currentValue = newValue;
+
+    Q_EMIT stateVariableChanged(variableName, newValue);
+}
+
+void UpnpControlAbstractService::convertStateVariableValues()
+{
+    const auto &allStateVariables = description().stateVariables();
+
+    for (auto itValue = d->mStateVariableValues.begin(); itValue != d->mStateVariableValues.end(); ++itValue) {
+        if (itValue->metaType().id() != QMetaType::QString) {
+            continue;
+        }
+
+        const auto itStateVariable = allStateVariables.constFind(itValue.key());
+        if (itStateVariable == allStateVariables.constEnd() || itStateVariable->mType == UpnpStateVariableType::String) {
+            continue;
+        }
+
+        // only the type of the value changes, stateVariableChanged is not emitted
+        *itValue = itStateVariable->typedValue(itValue->toString());
+    }
+}
+
+void UpnpControlAbstractService::decodeLastChange(const QString &lastChange)
+{
+    const auto decoded =
+        d->mLastChangeDecoder.decode(lastChange, [this](quint32 instanceId, QStringView variableName, QStringView channel, QStringView value) {
+            const auto &name = variableName.toString();
+            const auto &newValue = typedStateVariableValue(name, value);
+
+            if (instanceId == 0 && (channel.isEmpty() || channel == QLatin1String("Master"))) {
+                updateStateVariable(name, newValue);
+            }
+
+            Q_EMIT instanceStateVariableChanged(instanceId, name, channel.toString(), newValue);
+        });
+
+    if (!decoded) {
+        qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpControlAbstractService::decodeLastChange"
+                                       << "invalid LastChange value" << d->mLastChangeDecoder.errorString();
+    }
+}
+
+bool UpnpControlAbstractService::isServiceDescriptionLoaded() const
+{
+    return description().isSCPDLoaded() || !description().actions().isEmpty() || description().SCPDURL().isEmpty();
+}
+
+void UpnpControlAbstractService::loadServiceDescription()
+{
+    if (isServiceDescriptionLoaded() || d->mServiceDescriptionIsLoading) {
+        return;
+    }
+
+    QUrl serviceUrl(description().SCPDURL().toString());
+    if (!serviceUrl.isValid() || serviceUrl.scheme().isEmpty()) {
+        serviceUrl.setUrl(description().baseURL());
+        serviceUrl.setPath(description().SCPDURL().toString());
+    }
+
+    d->mServiceDescriptionIsLoading = true;
+
+    downloadServiceDescription(serviceUrl);
+}
+
+void UpnpControlAbstractService::downloadServiceDescription(const QUrl &serviceUrl)
+{
+    d->mServiceDescriptionUrl = serviceUrl;
+    watchReply(networkAccess()->get(QNetworkRequest(serviceUrl)));
+}
+
+QNetworkAccessManager *UpnpControlAbstractService::networkAccess()
+{
+    static thread_local QPointer<QNetworkAccessManager> sharedNetworkAccess;
+
+    if (!sharedNetworkAccess) {
+        auto *currentThread = QThread::currentThread();
+        auto *application = QCoreApplication::instance();
+
+        if (application && application->thread() == currentThread) {
+            sharedNetworkAccess = new QNetworkAccessManager(application);
+        } else {
+            sharedNetworkAccess = new QNetworkAccessManager;
+            connect(currentThread, &QThread::finished, sharedNetworkAccess.data(), &QObject::deleteLater);
+        }
+    }
+
+    return sharedNetworkAccess;
+}
+
+void UpnpControlAbstractService::watchReply(QNetworkReply *reply)
+{
+    // the reply is aborted if the service is destroyed before it is finished
+    reply->setParent(this);
+
+    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
+        finishedDownload(reply);
+    });
+}
+
+void UpnpControlAbstractService::finishedDownload(QNetworkReply *reply)
+{
+    if (!reply->isFinished()) {
+        return;
+    }
+
+    if (reply->request().attribute(QNetworkRequest::User).isValid()) {
+        eventSubscriptionFinished(reply);
+    } else if (reply->error() == QNetworkReply::NoError) {
+        parseServiceDescription(reply);
+
+        sendPendingActionCalls();
+    } else {
+        qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpAbstractServiceDescription::finishedDownload"
+                                       << "error";
+
+        if (reply->url() == d->mServiceDescriptionUrl) {
+            failPendingActionCalls(reply->errorString());
+        }
+    }
+
+    reply->deleteLater();
+}
+
+void UpnpControlAbstractService::parseServiceDescription(QIODevice *serviceDescriptionContent)
+{
+    const auto &parsedDescription = UpnpServiceDescriptionParser::parseServiceDescriptionContent(serviceDescriptionContent->readAll());
+
+    description().actions() = parsedDescription.actions();
+    description().stateVariables() = parsedDescription.stateVariables();
+    description().setSCPDHash(parsedDescription.SCPDHash());
+}
+
+void UpnpControlAbstractService::sendPendingActionCalls()
+{
+    d->mServiceDescriptionIsLoading = false;
+    description().setSCPDLoaded(true);
+
+    // values received in events before the description are still strings
+    convertStateVariableValues();
+
+    Q_EMIT serviceDescriptionLoaded();
+
+    const auto now = d->mActiveCallsClock.elapsed();
+
+    const auto pendingActionCalls = std::exchange(d->mPendingActionCalls, {});
+    for (const auto &oneCall : pendingActionCalls) {
+        if (oneCall.mCompletion.isCanceled()) {
+            ++d->mAbortedCalls;
+            continue;
+        }
+
+        if (oneCall.mDeadline != -1 && now >= oneCall.mDeadline) {
+            ++d->mTimedOutCalls;
+            oneCall.mCompletion.finish(UpnpActionResult::fromTransportError(QStringLiteral("action call timed out")));
+            continue;
+        }
+
+        // the time spent loading the service description is part of the deadline of the call
+        const auto remainingTime = (oneCall.mDeadline == -1 ? 0 : static_cast<int>(oneCall.mDeadline - now));
+
+        if (oneCall.mIsSerialized) {
+            sendSerializedAction(oneCall.mCompletion, oneCall.mActionName, oneCall.mInputArgumentNames, oneCall.mInputValues, remainingTime);
+        } else {
+            sendAction(oneCall.mCompletion, oneCall.mActionName, oneCall.mArguments, remainingTime);
+        }
+    }
+}
+
+void UpnpControlAbstractService::failPendingActionCalls(const QString &errorMessage)
+{
+    d->mServiceDescriptionIsLoading = false;
+
+    Q_EMIT serviceDescriptionInError();
+
+    const auto pendingActionCalls = std::exchange(d->mPendingActionCalls, {});
+    for (const auto &oneCall : pendingActionCalls) {
+        oneCall.mCompletion.finish(UpnpActionResult::fromError(errorMessage));
     }
-#endif
 }
 
 void UpnpControlAbstractService::parseEventNotification(const QString &eventName, const QString &eventValue)
@@ -10,10 +10,13 @@
 #include "upnplibqt_export.h"
 
 #include "upnpabstractservice.h"
+#include "upnpactionresult.h"
 #include "upnpcontrolabstractservicereply.h"
 
+#include <QFuture>
 #include <QObject>
 #include <QString>
+#include <QStringView>
 #include <QUrl>
 #include <QVariant>
 #include <QVariantList>
@@ -22,7 +25,13 @@
 
 class UpnpAbstractServiceDescriptionPrivate;
 class QNetworkReply;
+class QNetworkAccessManager;
 class QHostInfo;
+class UpnpSoapConnectionPool;
+class KDSoapMessage;
+class UpnpActiveActionCall;
+template<typename T>
+class QPromise;
 
 /**
  * @brief The UpnpControlAbstractService class is the base class with infrastructure needed to call actions on UPnP services (i.e. control of the service)
@@ -31,28 +40,284 @@ class UPNPLIBQT_EXPORT UpnpControlAbstractService : public UpnpAbstractService
 {
     Q_OBJECT
 
+    Q_PROPERTY(int actionTimeout
+            READ actionTimeout
+                WRITE setActionTimeout
+                    NOTIFY actionTimeoutChanged)
+
+    Q_PROPERTY(int maximumRetries
+            READ maximumRetries
+                WRITE setMaximumRetries
+                    NOTIFY maximumRetriesChanged)
+
+    Q_PROPERTY(int retryDelay
+            READ retryDelay
+                WRITE setRetryDelay
+                    NOTIFY retryDelayChanged)
+
 public:
     explicit UpnpControlAbstractService(QObject *parent = nullptr);
 
     ~UpnpControlAbstractService() override;
 
-    [[nodiscard]] UpnpControlAbstractServiceReply *callAction(const QString &action, const QMap<QString, QVariant> &arguments);
+    /**
+     * @brief callAction will call an action of the service
+     *
+     * If the actions of the service are not yet known (i.e. the device description was parsed in lazy mode), the
+     * service description is downloaded first and the action is sent once it is parsed.
+     *
+     * @param timeout is the deadline of the call in milliseconds, 0 for no deadline or -1 to use actionTimeout
+     */
+    [[nodiscard]] UpnpControlAbstractServiceReply *callAction(const QString &action, const QMap<QString, QVariant> &arguments, int timeout = -1);
+
+    /**
+     * @brief callAction will call an action of the service identified by its index
+     *
+     * This is the fast path for actions called often: the action, its SOAPAction header and the names of its input
+     * arguments are looked up once in a precomputed invocation plan. The service description must be loaded.
+     *
+     * @param actionIndex is the index returned by actionIndex
+     * @param inputArguments are the values of the input arguments in the order given by actionInputArguments;
+     * invalid values are not sent
+     */
+    [[nodiscard]] UpnpControlAbstractServiceReply *callAction(int actionIndex, const QVariantList &inputArguments, int timeout = -1);
+
+    /**
+     * @brief callSerializedAction will call an action of the service identified by its index with the SOAP
+     * representation of its input arguments
+     *
+     * This is the path used by the proxies generated by upnpscpd2cpp: the values are already converted to strings and
+     * are all sent, without being stored in a QVariantList first.
+     */
+    [[nodiscard]] UpnpControlAbstractServiceReply *callSerializedAction(int actionIndex, const QList<QString> &inputValues, int timeout = -1);
+
+    /**
+     * @brief callSerializedAction will call an action of the service identified by its name with the SOAP
+     * representation of its input arguments
+     *
+     * Unlike callAction, empty values are sent. If the actions of the service are not yet known, the call waits for
+     * the service description like callAction does.
+     *
+     * @param inputArgumentNames are the names of the input arguments, in the same order as inputValues
+     */
+    [[nodiscard]] UpnpControlAbstractServiceReply *
+    callSerializedAction(const QString &actionName, const QList<QString> &inputArgumentNames, const QList<QString> &inputValues, int timeout = -1);
+
+    /**
+     * @brief callActionAsync will call an action of the service and return a future for its result
+     *
+     * Unlike callAction, no QObject is created for the call. This is the preferred way to sequence actions with
+     * QFuture::then or, with C++20, to co_await them (see \class UpnpActionAwaiter). Canceling the future before the
+     * call is sent drops the call.
+     */
+    [[nodiscard]] QFuture<UpnpActionResult> callActionAsync(const QString &action, const QMap<QString, QVariant> &arguments, int timeout = -1);
+
+    /**
+     * @brief callActionAsync will call an action of the service identified by its index and return a future for its result
+     */
+    [[nodiscard]] QFuture<UpnpActionResult> callActionAsync(int actionIndex, const QVariantList &inputArguments, int timeout = -1);
+
+    /**
+     * @brief actionIndex returns the index of an action for callAction or -1 if the action is unknown
+     *
+     * The index stays valid until the actions of the service description change.
+     */
+    [[nodiscard]] int actionIndex(const QString &actionName) const;
+
+    /**
+     * @brief actionInputArguments returns the names of the input arguments of an action in the order expected by callAction
+     */
+    [[nodiscard]] QList<QString> actionInputArguments(int actionIndex) const;
 
+    /**
+     * @brief subscribeEvents will subscribe to the events of the service for duration seconds
+     *
+     * The subscription is then renewed with its SID before it expires (see \class UpnpEventSubscriptionScheduler).
+     * If the service does not know the SID anymore (412 Precondition Failed), a new subscription is made. Failed
+     * requests are retried with an increasing delay.
+     */
     void subscribeEvents(int duration);
 
+    /**
+     * @brief renewEventSubscription will renew the current subscription now or subscribe if there is none
+     */
+    void renewEventSubscription();
+
+    /**
+     * @brief unsubscribeEvents will cancel the current subscription and stop its renewals
+     */
+    void unsubscribeEvents();
+
+    /**
+     * @brief eventSubscriptionId is the SID of the current subscription or an empty string
+     */
+    [[nodiscard]] QString eventSubscriptionId() const;
+
+    /**
+     * @brief handleEventNotification will update the state of the service from an event notification
+     *
+     * The SEQ header of the notification is checked. Events older than the last received one are dropped. When
+     * events have been missed, the service subscribes again to receive a new initial event with the value of all
+     * evented state variables.
+     */
     void handleEventNotification(const QByteArray &requestData, const QMap<QByteArray, QByteArray> &headers);
 
+    /**
+     * @brief eventSequenceGaps is the number of times events were detected as missing from the SEQ header
+     */
+    [[nodiscard]] quint64 eventSequenceGaps() const;
+
+    [[nodiscard]] quint64 missedEvents() const;
+
+    /**
+     * @brief outOfOrderEvents is the number of events dropped because they were received after a newer one
+     */
+    [[nodiscard]] quint64 outOfOrderEvents() const;
+
+    /**
+     * @brief eventResynchronizations is the number of subscriptions made again after a gap
+     */
+    [[nodiscard]] quint64 eventResynchronizations() const;
+
+    void resetEventStatistics();
+
+    /**
+     * @brief stateVariableValue returns the last value received in events for a state variable
+     *
+     * The value is converted to the data type of the state variable given by the service description (see
+     * UpnpStateVariableDescription::typedValue). An invalid QVariant is returned if no event gave a value yet.
+     *
+     * For AV services, the variables of InstanceID 0 given by LastChange are also available here (for the Master
+     * channel when the variable has a channel).
+     */
+    [[nodiscard]] QVariant stateVariableValue(const QString &variableName) const;
+
+    /**
+     * @brief stateVariableValues returns all values received in events indexed by the name of their state variable
+     */
+    [[nodiscard]] QVariantMap stateVariableValues() const;
+
+    /**
+     * @brief instanceStateVariableValue returns the last value given by the LastChange events of AV services for a
+     * variable of one instance
+     *
+     * @param channel is the channel of the variable for RenderingControl variables like Volume or empty
+     */
+    [[nodiscard]] QVariant instanceStateVariableValue(quint32 instanceId, const QString &variableName, const QString &channel = {}) const;
+
+    /**
+     * @brief setConnectionPool will send the action calls through pool
+     *
+     * Services created by \class UpnpControlAbstractDevice share the pool of their device. Without pool, the
+     * service uses its own SOAP client.
+     */
+    void setConnectionPool(UpnpSoapConnectionPool *pool);
+
+    [[nodiscard]] UpnpSoapConnectionPool *connectionPool() const;
+
+    /**
+     * @brief actionTimeout is the default deadline of action calls in milliseconds, 0 means no deadline
+     *
+     * A call that is not answered before its deadline is aborted and finished with a transport error. The deadline
+     * includes the download of the service description when it is not yet loaded.
+     *
+     * There is no deadline by default: it is set for all calls of the service with setActionTimeout or for one call
+     * with the timeout argument of callAction.
+     */
+    [[nodiscard]] int actionTimeout() const;
+
+    /**
+     * @brief maximumRetries is the number of times a call of an idempotent action is sent again after a transport error
+     *
+     * Retries are disabled by default. Only the actions given to setIdempotentActions are retried, and only when
+     * the service did not answer (network error or timeout), never when it returned an UPnP error.
+     */
+    [[nodiscard]] int maximumRetries() const;
+
+    /**
+     * @brief retryDelay is the delay in milliseconds before the first retry, it is doubled for each following retry
+     */
+    [[nodiscard]] int retryDelay() const;
+
+    void setIdempotentActions(const QList<QString> &actionNames);
+
+    [[nodiscard]] QList<QString> idempotentActions() const;
+
+    /**
+     * @brief activeCalls is the number of calls sent or waiting for a retry
+     */
+    [[nodiscard]] int activeCalls() const;
+
+    [[nodiscard]] quint64 timedOutCalls() const;
+
+    [[nodiscard]] quint64 retriedCalls() const;
+
+    /**
+     * @brief abortedCalls is the number of calls stopped because their reply was aborted or their future canceled
+     */
+    [[nodiscard]] quint64 abortedCalls() const;
+
+    void resetCallStatistics();
+
+    /**
+     * @brief isServiceDescriptionLoaded is true when the actions and state variables of the service are known
+     */
+    [[nodiscard]] bool isServiceDescriptionLoaded() const;
+
 Q_SIGNALS:
 
+    void serviceDescriptionLoaded();
+
+    void serviceDescriptionInError();
+
+    /**
+     * @brief stateVariableChanged is emitted when an event gives a new value to a state variable
+     */
+    void stateVariableChanged(const QString &variableName, const QVariant &value);
+
+    /**
+     * @brief instanceStateVariableChanged is emitted when a LastChange event gives a new value to a variable of an instance
+     */
+    void instanceStateVariableChanged(quint32 instanceId, const QString &variableName, const QString &channel, const QVariant &value);
+
+    /**
+     * @brief eventNotificationProcessed is emitted after all state variables of one event are updated
+     */
+    void eventNotificationProcessed();
+
+    /**
+     * @brief eventSequenceGapDetected is emitted when the SEQ of an event shows that previous events were missed
+     */
+    void eventSequenceGapDetected(quint32 expectedSequence, quint32 receivedSequence);
+
+    void actionTimeoutChanged();
+
+    void maximumRetriesChanged();
+
+    void retryDelayChanged();
+
 public Q_SLOTS:
 
+    void setActionTimeout(int value);
+
+    void setMaximumRetries(int value);
+
+    void setRetryDelay(int value);
+
+    /**
+     * @brief loadServiceDescription will download the service description if it is not yet loaded
+     *
+     * serviceDescriptionLoaded or serviceDescriptionInError is emitted when the download is finished.
+     */
+    void loadServiceDescription();
+
     void downloadServiceDescription(const QUrl &serviceUrl);
 
 private Q_SLOTS:
 
     void finishedDownload(QNetworkReply *reply);
 
-    void eventSubscriptionTimeout();
+    void checkActiveCalls();
 
 protected:
     virtual void parseServiceDescription(QIODevice *serviceDescriptionContent);
@@ -60,6 +325,77 @@ protected:
     virtual void parseEventNotification(const QString &eventName, const QString &eventValue);
 
 private:
+    /**
+     * @brief networkAccess returns the manager shared by all services of the current thread
+     *
+     * It is created on first use and destroyed with the application or with its thread.
+     */
+    [[nodiscard]] static QNetworkAccessManager *networkAccess();
+
+    void watchReply(QNetworkReply *reply);
+
+    [[nodiscard]] static UpnpActionCompletion replyCompletion(UpnpControlAbstractServiceReply *reply);
+
+    [[nodiscard]] static UpnpActionCompletion promiseCompletion(const std::shared_ptr<QPromise<UpnpActionResult>> &promise);
+
+    void startAction(const UpnpActionCompletion &completion, const QString &actionName, const QMap<QString, QVariant> &arguments, int timeout);
+
+    void startAction(const UpnpActionCompletion &completion, int actionIndex, const QVariantList &inputArguments, int timeout);
+
+    void startSerializedAction(const UpnpActionCompletion &completion, int actionIndex, const QList<QString> &inputValues, int timeout);
+
+    void startSerializedAction(const UpnpActionCompletion &completion,
+                               const QString &actionName,
+                               const QList<QString> &inputArgumentNames,
+                               const QList<QString> &inputValues,
+                               int timeout);
+
+    [[nodiscard]] bool checkActionIndex(const UpnpActionCompletion &completion, int actionIndex);
+
+    void sendAction(const UpnpActionCompletion &completion, const QString &actionName, const QMap<QString, QVariant> &arguments, int timeout);
+
+    void sendSerializedAction(const UpnpActionCompletion &completion,
+                              const QString &actionName,
+                              const QList<QString> &inputArgumentNames,
+                              const QList<QString> &inputValues,
+                              int timeout);
+
+    void sendMessage(const UpnpActionCompletion &completion, const QString &actionName, const KDSoapMessage &message, const QString &soapAction, int timeout);
+
+    void transmitActiveCall(quint64 callId);
+
+    void activeCallFinished(quint64 callId, const UpnpActionResult &result);
+
+    void abortTransport(UpnpActiveActionCall &activeCall);
+
+    void closeAbortedTransports();
+
+    [[nodiscard]] bool canRetry(const UpnpActiveActionCall &activeCall) const;
+
+    void scheduleRetry(UpnpActiveActionCall &activeCall, qint64 now);
+
+    void scheduleActiveCallsCheck(qint64 eventTime);
+
+    void cancelEventSubscriptionRenewal();
+
+    [[nodiscard]] bool checkEventSequence(const QMap<QByteArray, QByteArray> &headers);
+
+    void eventSubscriptionFinished(QNetworkReply *reply);
+
+    [[nodiscard]] QVariant typedStateVariableValue(const QString &variableName, QStringView textValue) const;
+
+    void updateStateVariable(const QString &variableName, const QVariant &newValue);
+
+    void convertStateVariableValues();
+
+    void decodeLastChange(const QString &lastChange);
+
+    void updateActionPlans() const;
+
+    void sendPendingActionCalls();
+
+    void failPendingActionCalls(const QString &errorMessage);
+
     std::unique_ptr<UpnpAbstractServiceDescriptionPrivate> d;
 };
 
@@ -12,31 +12,100 @@
 class UpnpControlAbstractServiceReplyPrivate
 {
 public:
+    UpnpControlAbstractServiceReplyPrivate() = default;
+
     explicit UpnpControlAbstractServiceReplyPrivate(const KDSoapPendingCall &soapAnswer)
-        : mAnswer(soapAnswer)
-        , mWatcher(mAnswer)
+        : mAnswer(std::make_unique<KDSoapPendingCall>(soapAnswer))
+        , mWatcher(std::make_unique<KDSoapPendingCallWatcher>(*mAnswer))
     {
     }
 
-    KDSoapPendingCall mAnswer;
+    std::unique_ptr<KDSoapPendingCall> mAnswer;
 
-    KDSoapPendingCallWatcher mWatcher;
+    std::unique_ptr<KDSoapPendingCallWatcher> mWatcher;
 
     QVariantMap mResult;
+
+    QString mErrorMessage;
+
+    bool mIsFinished = false;
+
+    bool mIsAborted = false;
+
+    bool mSuccess = false;
 };
 
 UpnpControlAbstractServiceReply::UpnpControlAbstractServiceReply(const KDSoapPendingCall &soapAnswer, QObject *parent)
     : QObject(parent)
     , d(std::make_unique<UpnpControlAbstractServiceReplyPrivate>(soapAnswer))
 {
-    connect(&d->mWatcher, &KDSoapPendingCallWatcher::finished, this, &UpnpControlAbstractServiceReply::callFinished);
+    connect(d->mWatcher.get(), &KDSoapPendingCallWatcher::finished, this, &UpnpControlAbstractServiceReply::callFinished);
+}
+
+UpnpControlAbstractServiceReply::UpnpControlAbstractServiceReply(QObject *parent)
+    : QObject(parent)
+    , d(std::make_unique<UpnpControlAbstractServiceReplyPrivate>())
+{
 }
 
 UpnpControlAbstractServiceReply::~UpnpControlAbstractServiceReply() = default;
 
+void UpnpControlAbstractServiceReply::setPendingCall(const KDSoapPendingCall &soapAnswer)
+{
+    if (d->mAnswer || d->mIsFinished) {
+        return;
+    }
+
+    d->mAnswer = std::make_unique<KDSoapPendingCall>(soapAnswer);
+    d->mWatcher = std::make_unique<KDSoapPendingCallWatcher>(*d->mAnswer);
+
+    connect(d->mWatcher.get(), &KDSoapPendingCallWatcher::finished, this, &UpnpControlAbstractServiceReply::callFinished);
+}
+
+void UpnpControlAbstractServiceReply::finishWithError(const QString &errorMessage)
+{
+    finish(UpnpActionResult::fromError(errorMessage));
+}
+
+void UpnpControlAbstractServiceReply::finish(const UpnpActionResult &result)
+{
+    if (d->mAnswer || d->mIsFinished) {
+        return;
+    }
+
+    d->mIsFinished = true;
+    d->mSuccess = result.mSuccess;
+    d->mResult = result.mValues;
+    d->mErrorMessage = result.mError;
+
+    Q_EMIT finished(this);
+}
+
+void UpnpControlAbstractServiceReply::abort()
+{
+    if (d->mAnswer || d->mIsFinished) {
+        return;
+    }
+
+    d->mIsAborted = true;
+
+    finishWithError(QStringLiteral("action call aborted"));
+
+    Q_EMIT aborted(this);
+}
+
+bool UpnpControlAbstractServiceReply::isAborted() const
+{
+    return d->mIsAborted;
+}
+
 bool UpnpControlAbstractServiceReply::success() const
 {
-    return d->mAnswer.isFinished() && !d->mWatcher.returnMessage().isFault();
+    if (!d->mAnswer) {
+        return d->mSuccess;
+    }
+
+    return d->mAnswer->isFinished() && !d->mWatcher->returnMessage().isFault();
 }
 
 QVariantMap UpnpControlAbstractServiceReply::result() const
@@ -46,7 +115,11 @@ QVariantMap UpnpControlAbstractServiceReply::result() const
 
 QString UpnpControlAbstractServiceReply::error() const
 {
-    return d->mWatcher.returnMessage().faultAsString();
+    if (!d->mWatcher) {
+        return d->mErrorMessage;
+    }
+
+    return d->mWatcher->returnMessage().faultAsString();
 }
 
 void UpnpControlAbstractServiceReply::callFinished()
@@ -58,11 +131,11 @@ void UpnpControlAbstractServiceReply::callFinished()
 
 void UpnpControlAbstractServiceReply::parseAnswer()
 {
-    if (!d->mAnswer.isFinished()) {
+    if (!d->mAnswer || !d->mAnswer->isFinished()) {
         return;
     }
 
-    const auto &returnedValues = d->mAnswer.returnMessage().childValues();
+    const auto &returnedValues = d->mAnswer->returnMessage().childValues();
 
     for (const KDSoapValue &oneValue : returnedValues) {
         d->mResult[oneValue.name()] = oneValue.value();
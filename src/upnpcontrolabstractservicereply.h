@@ -9,6 +9,8 @@
 
 #include "upnplibqt_export.h"
 
+#include "upnpactionresult.h"
+
 #include <QObject>
 #include <QVariantMap>
 
@@ -30,8 +32,40 @@ class UPNPLIBQT_EXPORT UpnpControlAbstractServiceReply : public QObject
 public:
     explicit UpnpControlAbstractServiceReply(const KDSoapPendingCall &soapAnswer, QObject *parent = nullptr);
 
+    /**
+     * @brief UpnpControlAbstractServiceReply creates a reply for an action that has not yet been sent
+     *
+     * It is used when the action call needs to wait for the download of the service description.
+     * setPendingCall or finishWithError must be called later.
+     */
+    explicit UpnpControlAbstractServiceReply(QObject *parent = nullptr);
+
     ~UpnpControlAbstractServiceReply() override;
 
+    /**
+     * @brief setPendingCall will attach the SOAP call to a reply created without it
+     */
+    void setPendingCall(const KDSoapPendingCall &soapAnswer);
+
+    /**
+     * @brief finishWithError will finish a reply created without SOAP call when the action cannot be sent
+     */
+    void finishWithError(const QString &errorMessage);
+
+    /**
+     * @brief finish will finish a reply created without SOAP call with the result received for the action
+     */
+    void finish(const UpnpActionResult &result);
+
+    /**
+     * @brief abort will stop the action call
+     *
+     * The reply is finished with an error and the request is aborted if it was already sent.
+     */
+    void abort();
+
+    [[nodiscard]] bool isAborted() const;
+
     [[nodiscard]] bool success() const;
 
     [[nodiscard]] QVariantMap result() const;
@@ -42,6 +76,8 @@ Q_SIGNALS:
 
     void finished(UpnpControlAbstractServiceReply *self);
 
+    void aborted(UpnpControlAbstractServiceReply *self);
+
 public Q_SLOTS:
 
     void callFinished();
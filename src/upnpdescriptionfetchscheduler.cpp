@@ -0,0 +1,338 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpdescriptionfetchscheduler.h"
+
+#include "upnplogging.h"
+
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+
+#include <QHash>
+#include <QPointer>
+#include <QTimer>
+
+#include <QLoggingCategory>
+
+#include <map>
+#include <utility>
+
+class UpnpDescriptionFetch
+{
+public:
+    quint64 mId = 0;
+
+    QUrl mUrl;
+
+    QString mHostKey;
+
+    QPointer<QObject> mReceiver;
+
+    std::function<void(QNetworkReply *)> mCallback;
+
+    QPointer<QNetworkReply> mReply;
+};
+
+class UpnpDescriptionFetchSchedulerPrivate
+{
+public:
+    explicit UpnpDescriptionFetchSchedulerPrivate(QNetworkAccessManager *networkAccess)
+        : mNetworkAccess(networkAccess)
+    {
+    }
+
+    using FetchKey = std::pair<int, quint64>;
+
+    /**
+     * @brief updateReadyHost will add hostKey to mReadyHosts if it has pending fetches and can start one more
+     */
+    void updateReadyHost(const QString &hostKey)
+    {
+        auto itReadyKey = mReadyHostKeys.find(hostKey);
+        if (itReadyKey != mReadyHostKeys.end()) {
+            mReadyHosts.erase(itReadyKey.value());
+            mReadyHostKeys.erase(itReadyKey);
+        }
+
+        const auto itQueue = mPendingFetchesPerHost.constFind(hostKey);
+        if (itQueue == mPendingFetchesPerHost.constEnd() || itQueue->empty() || mRunningFetchesPerHost.value(hostKey) >= mMaximumConnectionsPerHost) {
+            return;
+        }
+
+        const auto &headKey = itQueue->begin()->first;
+        mReadyHosts.emplace(headKey, hostKey);
+        mReadyHostKeys[hostKey] = headKey;
+    }
+
+    QNetworkAccessManager *mNetworkAccess;
+
+    /**
+     * @brief mPendingFetchesPerHost are the queues of each host ordered by decreasing priority and then by order of arrival
+     */
+    QHash<QString, std::map<FetchKey, UpnpDescriptionFetch>> mPendingFetchesPerHost;
+
+    /**
+     * @brief mPendingFetchKeys gives the host and the key in the queue of the host of each pending fetch
+     */
+    QHash<quint64, std::pair<QString, FetchKey>> mPendingFetchKeys;
+
+    /**
+     * @brief mReadyHosts are the hosts below their connection limit with pending fetches ordered by their next fetch
+     *
+     * Starting a fetch only looks at the first host instead of all the pending fetches.
+     */
+    std::map<FetchKey, QString> mReadyHosts;
+
+    QHash<QString, FetchKey> mReadyHostKeys;
+
+    QHash<quint64, UpnpDescriptionFetch> mRunningFetches;
+
+    QHash<QString, int> mRunningFetchesPerHost;
+
+    QHash<QString, int> mTypePriorities;
+
+    quint64 mNextFetchId = 1;
+
+    int mMaximumConnectionsPerHost = 2;
+
+    int mMaximumConnections = 16;
+
+    int mTimeout = 10000;
+};
+
+UpnpDescriptionFetchScheduler::UpnpDescriptionFetchScheduler(QNetworkAccessManager *networkAccess, QObject *parent)
+    : QObject(parent)
+    , d(std::make_unique<UpnpDescriptionFetchSchedulerPrivate>(networkAccess))
+{
+}
+
+UpnpDescriptionFetchScheduler::~UpnpDescriptionFetchScheduler()
+{
+    const auto allRunningFetches = d->mRunningFetches;
+    d->mRunningFetches.clear();
+
+    for (const auto &oneFetch : allRunningFetches) {
+        if (oneFetch.mReply) {
+            oneFetch.mReply->abort();
+            oneFetch.mReply->deleteLater();
+        }
+    }
+}
+
+int UpnpDescriptionFetchScheduler::maximumConnectionsPerHost() const
+{
+    return d->mMaximumConnectionsPerHost;
+}
+
+int UpnpDescriptionFetchScheduler::maximumConnections() const
+{
+    return d->mMaximumConnections;
+}
+
+int UpnpDescriptionFetchScheduler::timeout() const
+{
+    return d->mTimeout;
+}
+
+void UpnpDescriptionFetchScheduler::setTypePriority(const QString &deviceOrServiceType, int priority)
+{
+    d->mTypePriorities[deviceOrServiceType] = priority;
+}
+
+int UpnpDescriptionFetchScheduler::typePriority(const QString &deviceOrServiceType) const
+{
+    auto itPriority = d->mTypePriorities.constFind(deviceOrServiceType);
+    if (itPriority != d->mTypePriorities.constEnd()) {
+        return *itPriority;
+    }
+
+    const auto versionSeparator = deviceOrServiceType.lastIndexOf(QLatin1Char(':'));
+    if (versionSeparator > 0) {
+        itPriority = d->mTypePriorities.constFind(deviceOrServiceType.left(versionSeparator));
+        if (itPriority != d->mTypePriorities.constEnd()) {
+            return *itPriority;
+        }
+    }
+
+    return 0;
+}
+
+quint64 UpnpDescriptionFetchScheduler::fetch(const QUrl &url, const QString &deviceOrServiceType, QObject *receiver, std::function<void(QNetworkReply *)> callback)
+{
+    UpnpDescriptionFetch newFetch;
+    newFetch.mId = d->mNextFetchId++;
+    newFetch.mUrl = url;
+    newFetch.mHostKey = url.host() + QLatin1Char(':') + QString::number(url.port(url.scheme() == QLatin1String("https") ? 443 : 80));
+    newFetch.mReceiver = receiver;
+    newFetch.mCallback = std::move(callback);
+
+    const auto fetchId = newFetch.mId;
+    const auto hostKey = newFetch.mHostKey;
+    const auto fetchKey = std::make_pair(-typePriority(deviceOrServiceType), fetchId);
+
+    d->mPendingFetchKeys[fetchId] = {hostKey, fetchKey};
+    d->mPendingFetchesPerHost[hostKey].emplace(fetchKey, std::move(newFetch));
+    d->updateReadyHost(hostKey);
+
+    startPendingFetches();
+
+    return fetchId;
+}
+
+void UpnpDescriptionFetchScheduler::cancel(quint64 fetchId)
+{
+    auto itPendingKey = d->mPendingFetchKeys.find(fetchId);
+    if (itPendingKey != d->mPendingFetchKeys.end()) {
+        const auto hostKey = itPendingKey->first;
+
+        auto itQueue = d->mPendingFetchesPerHost.find(hostKey);
+        itQueue->erase(itPendingKey->second);
+        if (itQueue->empty()) {
+            d->mPendingFetchesPerHost.erase(itQueue);
+        }
+
+        d->mPendingFetchKeys.erase(itPendingKey);
+        d->updateReadyHost(hostKey);
+        return;
+    }
+
+    auto itRunning = d->mRunningFetches.find(fetchId);
+    if (itRunning == d->mRunningFetches.end()) {
+        return;
+    }
+
+    auto cancelledFetch = std::move(itRunning.value());
+    d->mRunningFetches.erase(itRunning);
+
+    auto itHost = d->mRunningFetchesPerHost.find(cancelledFetch.mHostKey);
+    if (itHost != d->mRunningFetchesPerHost.end() && --itHost.value() <= 0) {
+        d->mRunningFetchesPerHost.erase(itHost);
+    }
+    d->updateReadyHost(cancelledFetch.mHostKey);
+
+    if (cancelledFetch.mReply) {
+        cancelledFetch.mReply->abort();
+        cancelledFetch.mReply->deleteLater();
+    }
+
+    startPendingFetches();
+}
+
+int UpnpDescriptionFetchScheduler::pendingFetches() const
+{
+    return d->mPendingFetchKeys.size();
+}
+
+int UpnpDescriptionFetchScheduler::runningFetches() const
+{
+    return d->mRunningFetches.size();
+}
+
+void UpnpDescriptionFetchScheduler::setMaximumConnectionsPerHost(int value)
+{
+    if (d->mMaximumConnectionsPerHost == value || value < 1) {
+        return;
+    }
+
+    d->mMaximumConnectionsPerHost = value;
+    Q_EMIT maximumConnectionsPerHostChanged();
+
+    const auto allHostKeys = d->mPendingFetchesPerHost.keys();
+    for (const auto &oneHostKey : allHostKeys) {
+        d->updateReadyHost(oneHostKey);
+    }
+
+    startPendingFetches();
+}
+
+void UpnpDescriptionFetchScheduler::setMaximumConnections(int value)
+{
+    if (d->mMaximumConnections == value || value < 1) {
+        return;
+    }
+
+    d->mMaximumConnections = value;
+    Q_EMIT maximumConnectionsChanged();
+
+    startPendingFetches();
+}
+
+void UpnpDescriptionFetchScheduler::setTimeout(int value)
+{
+    if (d->mTimeout == value || value < 0) {
+        return;
+    }
+
+    d->mTimeout = value;
+    Q_EMIT timeoutChanged();
+}
+
+void UpnpDescriptionFetchScheduler::startPendingFetches()
+{
+    while (!d->mReadyHosts.empty() && d->mRunningFetches.size() < d->mMaximumConnections) {
+        const auto hostKey = d->mReadyHosts.begin()->second;
+
+        auto itQueue = d->mPendingFetchesPerHost.find(hostKey);
+        auto newFetch = std::move(itQueue->begin()->second);
+        itQueue->erase(itQueue->begin());
+        if (itQueue->empty()) {
+            d->mPendingFetchesPerHost.erase(itQueue);
+        }
+
+        d->mPendingFetchKeys.remove(newFetch.mId);
+        ++d->mRunningFetchesPerHost[hostKey];
+        d->updateReadyHost(hostKey);
+
+        qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpDescriptionFetchScheduler::startPendingFetches" << newFetch.mUrl;
+
+        QNetworkRequest newRequest(newFetch.mUrl);
+        newRequest.setTransferTimeout(d->mTimeout);
+
+        const auto fetchId = newFetch.mId;
+        newFetch.mReply = d->mNetworkAccess->get(newRequest);
+
+        connect(newFetch.mReply.data(), &QNetworkReply::finished, this, [this, fetchId]() {
+            fetchFinished(fetchId);
+        });
+
+        // the transfer timeout only detects inactivity, this is the deadline of the whole download
+        if (d->mTimeout > 0) {
+            QTimer::singleShot(d->mTimeout, newFetch.mReply.data(), &QNetworkReply::abort);
+        }
+
+        d->mRunningFetches[fetchId] = std::move(newFetch);
+    }
+}
+
+void UpnpDescriptionFetchScheduler::fetchFinished(quint64 fetchId)
+{
+    auto itRunning = d->mRunningFetches.find(fetchId);
+    if (itRunning == d->mRunningFetches.end()) {
+        return;
+    }
+
+    auto finishedFetch = std::move(itRunning.value());
+    d->mRunningFetches.erase(itRunning);
+
+    auto itHost = d->mRunningFetchesPerHost.find(finishedFetch.mHostKey);
+    if (itHost != d->mRunningFetchesPerHost.end() && --itHost.value() <= 0) {
+        d->mRunningFetchesPerHost.erase(itHost);
+    }
+    d->updateReadyHost(finishedFetch.mHostKey);
+
+    if (finishedFetch.mReply) {
+        if (finishedFetch.mReceiver && finishedFetch.mCallback) {
+            finishedFetch.mCallback(finishedFetch.mReply.data());
+        }
+
+        finishedFetch.mReply->deleteLater();
+    }
+
+    startPendingFetches();
+}
+
+#include "moc_upnpdescriptionfetchscheduler.cpp"
@@ -0,0 +1,128 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef UPNPDESCRIPTIONFETCHSCHEDULER_H
+#define UPNPDESCRIPTIONFETCHSCHEDULER_H
+
+#include "upnplibqt_export.h"
+
+#include <QObject>
+#include <QString>
+#include <QUrl>
+
+#include <functional>
+#include <memory>
+
+class QNetworkAccessManager;
+class QNetworkReply;
+class UpnpDescriptionFetchSchedulerPrivate;
+
+/**
+ * @brief The UpnpDescriptionFetchScheduler class limits and orders the downloads of device and service descriptions
+ *
+ * A discovery burst can trigger hundreds of description downloads at once. The scheduler queues them and only starts
+ * a limited number of requests per host and in total. Queued downloads are started by decreasing priority. The
+ * priority is chosen from the device or service type given with each download (see setTypePriority). Each
+ * download is aborted if it does not finish before the configured timeout.
+ */
+class UPNPLIBQT_EXPORT UpnpDescriptionFetchScheduler : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int maximumConnectionsPerHost
+            READ maximumConnectionsPerHost
+                WRITE setMaximumConnectionsPerHost
+                    NOTIFY maximumConnectionsPerHostChanged)
+
+    Q_PROPERTY(int maximumConnections
+            READ maximumConnections
+                WRITE setMaximumConnections
+                    NOTIFY maximumConnectionsChanged)
+
+    Q_PROPERTY(int timeout
+            READ timeout
+                WRITE setTimeout
+                    NOTIFY timeoutChanged)
+
+public:
+    explicit UpnpDescriptionFetchScheduler(QNetworkAccessManager *networkAccess, QObject *parent = nullptr);
+
+    ~UpnpDescriptionFetchScheduler() override;
+
+    [[nodiscard]] int maximumConnectionsPerHost() const;
+
+    [[nodiscard]] int maximumConnections() const;
+
+    /**
+     * @brief timeout is the maximum duration in milliseconds of one download, 0 to wait without limit
+     *
+     * The download is aborted when it is not finished after timeout, even if data is still being received. It starts
+     * when the request is sent, not while it is waiting in the queue.
+     */
+    [[nodiscard]] int timeout() const;
+
+    /**
+     * @brief setTypePriority will set the priority of downloads for a device or service type
+     *
+     * Downloads with a higher priority are started first. Types without a priority have priority 0.
+     * A type given without version (i.e. urn:schemas-upnp-org:device:MediaRenderer) matches all versions.
+     *
+     * @param deviceOrServiceType is a device or service type like urn:schemas-upnp-org:device:MediaRenderer:1
+     * @param priority is the new priority
+     */
+    void setTypePriority(const QString &deviceOrServiceType, int priority);
+
+    [[nodiscard]] int typePriority(const QString &deviceOrServiceType) const;
+
+    /**
+     * @brief fetch will queue the download of url
+     *
+     * callback is called with the finished reply, including in case of error or timeout. The reply is deleted
+     * after callback returns. callback is not called if receiver has been destroyed or if the download has
+     * been cancelled.
+     *
+     * @param url is the url of the description
+     * @param deviceOrServiceType is the type used to choose the priority of this download
+     * @param receiver is the object owning callback
+     * @param callback is called when the download is finished
+     * @return an identifier that can be given to cancel
+     */
+    quint64 fetch(const QUrl &url, const QString &deviceOrServiceType, QObject *receiver, std::function<void(QNetworkReply *)> callback);
+
+    /**
+     * @brief cancel will remove a queued download or abort a running download
+     */
+    void cancel(quint64 fetchId);
+
+    [[nodiscard]] int pendingFetches() const;
+
+    [[nodiscard]] int runningFetches() const;
+
+Q_SIGNALS:
+
+    void maximumConnectionsPerHostChanged();
+
+    void maximumConnectionsChanged();
+
+    void timeoutChanged();
+
+public Q_SLOTS:
+
+    void setMaximumConnectionsPerHost(int value);
+
+    void setMaximumConnections(int value);
+
+    void setTimeout(int value);
+
+private:
+    void startPendingFetches();
+
+    void fetchFinished(quint64 fetchId);
+
+    std::unique_ptr<UpnpDescriptionFetchSchedulerPrivate> d;
+};
+
+#endif // UPNPDESCRIPTIONFETCHSCHEDULER_H
@@ -0,0 +1,136 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpdescriptionparsingpool.h"
+
+#include "upnplogging.h"
+
+#include <QList>
+#include <QMetaObject>
+#include <QPointer>
+#include <QThreadPool>
+
+#include <QLoggingCategory>
+
+class UpnpDescriptionParsingJob
+{
+public:
+    QPointer<QObject> mContext;
+
+    std::function<void()> mWork;
+
+    std::function<void()> mDone;
+};
+
+class UpnpDescriptionParsingPoolPrivate
+{
+public:
+    /**
+     * @brief mRunningJobs is the number of jobs given to mThreadPool and not yet done, only used in the thread of the pool
+     */
+    int mRunningJobs = 0;
+
+    int mMaximumQueueDepth = 64;
+
+    /**
+     * @brief mWaitingJobs are the jobs started when running jobs are done
+     */
+    QList<UpnpDescriptionParsingJob> mWaitingJobs;
+
+    QThreadPool mThreadPool;
+};
+
+UpnpDescriptionParsingPool::UpnpDescriptionParsingPool(QObject *parent)
+    : QObject(parent)
+    , d(std::make_unique<UpnpDescriptionParsingPoolPrivate>())
+{
+    d->mThreadPool.setMaxThreadCount(2);
+}
+
+UpnpDescriptionParsingPool::~UpnpDescriptionParsingPool()
+{
+    d->mThreadPool.waitForDone();
+}
+
+int UpnpDescriptionParsingPool::maximumThreadCount() const
+{
+    return d->mThreadPool.maxThreadCount();
+}
+
+int UpnpDescriptionParsingPool::maximumQueueDepth() const
+{
+    return d->mMaximumQueueDepth;
+}
+
+int UpnpDescriptionParsingPool::pendingJobs() const
+{
+    return d->mRunningJobs + static_cast<int>(d->mWaitingJobs.size());
+}
+
+void UpnpDescriptionParsingPool::run(QObject *context, std::function<void()> work, std::function<void()> done)
+{
+    d->mWaitingJobs.push_back({context, std::move(work), std::move(done)});
+
+    if (d->mRunningJobs >= d->mMaximumQueueDepth) {
+        qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpDescriptionParsingPool::run"
+                                       << "queue is full, waiting for running jobs" << d->mWaitingJobs.size();
+    }
+
+    startWaitingJobs();
+}
+
+void UpnpDescriptionParsingPool::startWaitingJobs()
+{
+    while (!d->mWaitingJobs.isEmpty() && d->mRunningJobs < d->mMaximumQueueDepth) {
+        auto nextJob = d->mWaitingJobs.takeFirst();
+        if (!nextJob.mContext) {
+            continue;
+        }
+
+        ++d->mRunningJobs;
+
+        d->mThreadPool.start([this, guardedContext = nextJob.mContext, work = std::move(nextJob.mWork), done = std::move(nextJob.mDone)]() {
+            work();
+
+            QMetaObject::invokeMethod(
+                this,
+                [this, guardedContext, done]() {
+                    --d->mRunningJobs;
+
+                    if (guardedContext) {
+                        done();
+                    }
+
+                    startWaitingJobs();
+                },
+                Qt::QueuedConnection);
+        });
+    }
+}
+
+void UpnpDescriptionParsingPool::setMaximumThreadCount(int value)
+{
+    if (d->mThreadPool.maxThreadCount() == value || value < 1) {
+        return;
+    }
+
+    d->mThreadPool.setMaxThreadCount(value);
+    Q_EMIT maximumThreadCountChanged();
+}
+
+void UpnpDescriptionParsingPool::setMaximumQueueDepth(int value)
+{
+    if (d->mMaximumQueueDepth == value || value < 1) {
+        return;
+    }
+
+    d->mMaximumQueueDepth = value;
+    Q_EMIT maximumQueueDepthChanged();
+
+    startWaitingJobs();
+}
+
+#include "moc_upnpdescriptionparsingpool.cpp"
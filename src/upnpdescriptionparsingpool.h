@@ -0,0 +1,88 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef UPNPDESCRIPTIONPARSINGPOOL_H
+#define UPNPDESCRIPTIONPARSINGPOOL_H
+
+#include "upnplibqt_export.h"
+
+#include <QObject>
+
+#include <functional>
+#include <memory>
+
+class UpnpDescriptionParsingPoolPrivate;
+
+/**
+ * @brief The UpnpDescriptionParsingPool class runs the parsing of downloaded descriptions on a bounded pool of threads
+ *
+ * It can be given to \class UpnpDeviceDescriptionParser to move the XML parsing of device and service descriptions out
+ * of the thread owning the QNetworkAccessManager. Results are always delivered back in the thread of the pool.
+ *
+ * At most maximumQueueDepth documents are given to the worker threads at a time. During a discovery burst, the next
+ * documents wait in the thread of the pool and are started as running jobs finish, they are never parsed by the
+ * caller.
+ */
+class UPNPLIBQT_EXPORT UpnpDescriptionParsingPool : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int maximumThreadCount
+            READ maximumThreadCount
+                WRITE setMaximumThreadCount
+                    NOTIFY maximumThreadCountChanged)
+
+    Q_PROPERTY(int maximumQueueDepth
+            READ maximumQueueDepth
+                WRITE setMaximumQueueDepth
+                    NOTIFY maximumQueueDepthChanged)
+
+public:
+    explicit UpnpDescriptionParsingPool(QObject *parent = nullptr);
+
+    ~UpnpDescriptionParsingPool() override;
+
+    [[nodiscard]] int maximumThreadCount() const;
+
+    [[nodiscard]] int maximumQueueDepth() const;
+
+    /**
+     * @brief pendingJobs is the number of jobs running in the worker threads or waiting for them
+     */
+    [[nodiscard]] int pendingJobs() const;
+
+    /**
+     * @brief run will execute work in one thread of the pool and then done in the thread of the pool object
+     *
+     * It must be called from the thread of the pool object.
+     *
+     * done is not called if context has been destroyed before the work was finished.
+     *
+     * @param context is the object requesting the work
+     * @param work is executed in a worker thread and must not touch objects owned by other threads
+     * @param done is executed in the thread of the pool once work is finished
+     */
+    void run(QObject *context, std::function<void()> work, std::function<void()> done);
+
+Q_SIGNALS:
+
+    void maximumThreadCountChanged();
+
+    void maximumQueueDepthChanged();
+
+public Q_SLOTS:
+
+    void setMaximumThreadCount(int value);
+
+    void setMaximumQueueDepth(int value);
+
+private:
+    void startWaitingJobs();
+
+    std::unique_ptr<UpnpDescriptionParsingPoolPrivate> d;
+};
+
+#endif // UPNPDESCRIPTIONPARSINGPOOL_H
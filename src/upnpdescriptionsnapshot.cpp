@@ -0,0 +1,341 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpdescriptionsnapshot.h"
+
+#include "upnplogging.h"
+
+#include "upnpdevicedescription.h"
+#include "upnpservicedescription.h"
+#include "upnpservicedescriptionstore.h"
+
+#include <QBuffer>
+#include <QDataStream>
+#include <QFile>
+#include <QHash>
+#include <QSaveFile>
+
+#include <QLoggingCategory>
+
+static constexpr quint32 SnapshotMagic = 0x55504e53;
+
+static constexpr int SnapshotStreamVersion = QDataStream::Qt_6_0;
+
+class UpnpDescriptionSnapshotEntry
+{
+public:
+    int mConfigId = -1;
+
+    /**
+     * @brief mDescription is set for entries inserted since the snapshot was loaded
+     */
+    std::optional<UpnpDeviceDescription> mDescription;
+
+    /**
+     * @brief mSerializedDescription points into the memory-mapped file for entries read by load
+     */
+    QByteArray mSerializedDescription;
+};
+
+class UpnpDescriptionSnapshotPrivate
+{
+public:
+    [[nodiscard]] static UpnpDeviceDescription decode(const UpnpDescriptionSnapshotEntry &entry);
+
+    [[nodiscard]] static QByteArray encode(const UpnpDescriptionSnapshotEntry &entry);
+
+    void unmap();
+
+    QHash<QUrl, UpnpDescriptionSnapshotEntry> mEntries;
+
+    std::unique_ptr<QFile> mMappedFile;
+
+    uchar *mMappedData = nullptr;
+};
+
+UpnpDeviceDescription UpnpDescriptionSnapshotPrivate::decode(const UpnpDescriptionSnapshotEntry &entry)
+{
+    if (entry.mDescription) {
+        return *entry.mDescription;
+    }
+
+    auto result = UpnpDeviceDescription {};
+
+    QDataStream descriptionStream(entry.mSerializedDescription);
+    descriptionStream.setVersion(SnapshotStreamVersion);
+    descriptionStream >> result;
+
+    if (descriptionStream.status() != QDataStream::Ok) {
+        qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpDescriptionSnapshot::decode"
+                                       << "corrupted entry";
+        return {};
+    }
+
+    for (auto &oneService : result.services()) {
+        if (!oneService.SCPDHash().isEmpty()) {
+            UpnpServiceDescriptionStore::insert(oneService.SCPDHash(), oneService);
+        }
+    }
+
+    return result;
+}
+
+QByteArray UpnpDescriptionSnapshotPrivate::encode(const UpnpDescriptionSnapshotEntry &entry)
+{
+    if (!entry.mDescription) {
+        return QByteArray{entry.mSerializedDescription.constData(), entry.mSerializedDescription.size()};
+    }
+
+    QByteArray result;
+
+    QDataStream descriptionStream(&result, QIODevice::WriteOnly);
+    descriptionStream.setVersion(SnapshotStreamVersion);
+    descriptionStream << *entry.mDescription;
+
+    return result;
+}
+
+void UpnpDescriptionSnapshotPrivate::unmap()
+{
+    mEntries.clear();
+
+    if (mMappedFile) {
+        if (mMappedData) {
+            mMappedFile->unmap(mMappedData);
+            mMappedData = nullptr;
+        }
+
+        mMappedFile.reset();
+    }
+}
+
+UpnpDescriptionSnapshot::UpnpDescriptionSnapshot()
+    : d(std::make_unique<UpnpDescriptionSnapshotPrivate>())
+{
+}
+
+UpnpDescriptionSnapshot::UpnpDescriptionSnapshot(UpnpDescriptionSnapshot &&other) noexcept
+    : d()
+{
+    d.swap(other.d);
+}
+
+UpnpDescriptionSnapshot::~UpnpDescriptionSnapshot()
+{
+    if (d) {
+        d->unmap();
+    }
+}
+
+UpnpDescriptionSnapshot &UpnpDescriptionSnapshot::operator=(UpnpDescriptionSnapshot &&other) noexcept
+{
+    if (this != &other) {
+        if (d) {
+            d->unmap();
+        }
+
+        d.reset();
+        d.swap(other.d);
+    }
+
+    return *this;
+}
+
+void UpnpDescriptionSnapshot::insert(const UpnpDeviceDescription &description, int configId)
+{
+    auto &newEntry = d->mEntries[description.locationUrl()];
+    newEntry.mConfigId = configId;
+    newEntry.mDescription = description;
+    newEntry.mSerializedDescription.clear();
+}
+
+void UpnpDescriptionSnapshot::remove(const QUrl &location)
+{
+    d->mEntries.remove(location);
+}
+
+std::optional<UpnpDeviceDescription> UpnpDescriptionSnapshot::find(const QUrl &location, int configId) const
+{
+    auto itEntry = d->mEntries.constFind(location);
+    if (itEntry == d->mEntries.constEnd() || itEntry->mConfigId != configId) {
+        return {};
+    }
+
+    auto result = UpnpDescriptionSnapshotPrivate::decode(*itEntry);
+    if (result.UDN().isEmpty()) {
+        return {};
+    }
+
+    return result;
+}
+
+bool UpnpDescriptionSnapshot::contains(const QUrl &location, int configId) const
+{
+    auto itEntry = d->mEntries.constFind(location);
+
+    return itEntry != d->mEntries.constEnd() && itEntry->mConfigId == configId;
+}
+
+QList<QUrl> UpnpDescriptionSnapshot::locations() const
+{
+    return d->mEntries.keys();
+}
+
+QList<UpnpDeviceDescription> UpnpDescriptionSnapshot::descriptions() const
+{
+    QList<UpnpDeviceDescription> result;
+    result.reserve(d->mEntries.size());
+
+    for (const auto &oneEntry : qAsConst(d->mEntries)) {
+        auto oneDescription = UpnpDescriptionSnapshotPrivate::decode(oneEntry);
+        if (!oneDescription.UDN().isEmpty()) {
+            result.push_back(std::move(oneDescription));
+        }
+    }
+
+    return result;
+}
+
+int UpnpDescriptionSnapshot::size() const
+{
+    return d->mEntries.size();
+}
+
+void UpnpDescriptionSnapshot::clear()
+{
+    d->unmap();
+}
+
+bool UpnpDescriptionSnapshot::save(const QString &fileName) const
+{
+    QList<QUrl> allLocations;
+    QList<QByteArray> allSerializedDescriptions;
+    QList<qint32> allConfigIds;
+
+    allLocations.reserve(d->mEntries.size());
+    allSerializedDescriptions.reserve(d->mEntries.size());
+    allConfigIds.reserve(d->mEntries.size());
+
+    for (auto itEntry = d->mEntries.constBegin(); itEntry != d->mEntries.constEnd(); ++itEntry) {
+        allLocations.push_back(itEntry.key());
+        allSerializedDescriptions.push_back(UpnpDescriptionSnapshotPrivate::encode(itEntry.value()));
+        allConfigIds.push_back(itEntry->mConfigId);
+    }
+
+    QSaveFile snapshotFile(fileName);
+    if (!snapshotFile.open(QIODevice::WriteOnly)) {
+        qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpDescriptionSnapshot::save" << fileName << snapshotFile.errorString();
+        return false;
+    }
+
+    QDataStream snapshotStream(&snapshotFile);
+    snapshotStream.setVersion(SnapshotStreamVersion);
+
+    snapshotStream << SnapshotMagic << FormatVersion << static_cast<qint32>(SnapshotStreamVersion) << static_cast<quint32>(allLocations.size());
+
+    quint64 currentOffset = 0;
+    for (int i = 0; i < allLocations.size(); ++i) {
+        const auto entrySize = static_cast<quint64>(allSerializedDescriptions[i].size());
+
+        snapshotStream << allLocations[i] << allConfigIds[i] << currentOffset << entrySize;
+
+        currentOffset += entrySize;
+    }
+
+    for (const auto &oneSerializedDescription : qAsConst(allSerializedDescriptions)) {
+        snapshotStream.writeRawData(oneSerializedDescription.constData(), oneSerializedDescription.size());
+    }
+
+    if (snapshotStream.status() != QDataStream::Ok) {
+        snapshotFile.cancelWriting();
+        return false;
+    }
+
+    return snapshotFile.commit();
+}
+
+bool UpnpDescriptionSnapshot::load(const QString &fileName)
+{
+    d->unmap();
+
+    auto snapshotFile = std::make_unique<QFile>(fileName);
+    if (!snapshotFile->open(QIODevice::ReadOnly)) {
+        qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpDescriptionSnapshot::load" << fileName << snapshotFile->errorString();
+        return false;
+    }
+
+    const auto fileSize = snapshotFile->size();
+    auto *mappedData = snapshotFile->map(0, fileSize);
+    if (!mappedData) {
+        qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpDescriptionSnapshot::load" << fileName << "cannot be mapped";
+        return false;
+    }
+
+    d->mMappedFile = std::move(snapshotFile);
+    d->mMappedData = mappedData;
+
+    auto mappedContent = QByteArray::fromRawData(reinterpret_cast<const char *>(mappedData), fileSize);
+    QBuffer mappedBuffer(&mappedContent);
+    mappedBuffer.open(QIODevice::ReadOnly);
+
+    QDataStream snapshotStream(&mappedBuffer);
+    snapshotStream.setVersion(SnapshotStreamVersion);
+
+    quint32 magic = 0;
+    quint32 formatVersion = 0;
+    qint32 streamVersion = 0;
+    quint32 entriesCount = 0;
+
+    snapshotStream >> magic >> formatVersion >> streamVersion >> entriesCount;
+
+    if (snapshotStream.status() != QDataStream::Ok || magic != SnapshotMagic || formatVersion != FormatVersion || streamVersion != SnapshotStreamVersion) {
+        qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpDescriptionSnapshot::load" << fileName << "has an unsupported format";
+        d->unmap();
+        return false;
+    }
+
+    QList<QUrl> allLocations;
+    QList<qint32> allConfigIds;
+    QList<std::pair<quint64, quint64>> allRanges;
+
+    for (quint32 i = 0; i < entriesCount && snapshotStream.status() == QDataStream::Ok; ++i) {
+        QUrl location;
+        qint32 configId = -1;
+        quint64 offset = 0;
+        quint64 entrySize = 0;
+
+        snapshotStream >> location >> configId >> offset >> entrySize;
+
+        allLocations.push_back(location);
+        allConfigIds.push_back(configId);
+        allRanges.push_back({offset, entrySize});
+    }
+
+    const auto payloadStart = static_cast<quint64>(mappedBuffer.pos());
+    const auto payloadSize = static_cast<quint64>(fileSize) - payloadStart;
+
+    if (snapshotStream.status() != QDataStream::Ok) {
+        qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpDescriptionSnapshot::load" << fileName << "has a truncated index";
+        d->unmap();
+        return false;
+    }
+
+    for (int i = 0; i < allLocations.size(); ++i) {
+        const auto &[offset, entrySize] = allRanges[i];
+
+        if (offset > payloadSize || entrySize > payloadSize - offset) {
+            qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpDescriptionSnapshot::load" << fileName << "is truncated";
+            d->unmap();
+            return false;
+        }
+
+        auto &newEntry = d->mEntries[allLocations[i]];
+        newEntry.mConfigId = allConfigIds[i];
+        newEntry.mSerializedDescription = QByteArray::fromRawData(reinterpret_cast<const char *>(mappedData + payloadStart + offset), static_cast<qsizetype>(entrySize));
+    }
+
+    return true;
+}
@@ -0,0 +1,103 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef UPNPDESCRIPTIONSNAPSHOT_H
+#define UPNPDESCRIPTIONSNAPSHOT_H
+
+#include "upnplibqt_export.h"
+
+#include <QList>
+#include <QString>
+#include <QUrl>
+
+#include <memory>
+#include <optional>
+
+class UpnpDeviceDescription;
+class UpnpDescriptionSnapshotPrivate;
+
+/**
+ * @brief The UpnpDescriptionSnapshot class stores parsed device descriptions in a compact binary file
+ *
+ * A control point can save the descriptions of known devices when it exits and load them at the next start
+ * instead of downloading and parsing all device and service descriptions again.
+ *
+ * The file starts with a versioned header followed by an index of all devices and by one serialized block per
+ * device. load memory-maps the file and only reads the header and the index. A device description is decoded the
+ * first time it is requested.
+ *
+ * Each device is stored with the LOCATION url of its description and the CONFIGID.UPNP.ORG value announced by the
+ * device. A stored description is only returned if both match the current announce of the device.
+ */
+class UPNPLIBQT_EXPORT UpnpDescriptionSnapshot
+{
+public:
+    /**
+     * @brief FormatVersion is the version of the file format written by save
+     */
+    static constexpr quint32 FormatVersion = 1;
+
+    UpnpDescriptionSnapshot();
+
+    UpnpDescriptionSnapshot(UpnpDescriptionSnapshot &&other) noexcept;
+
+    ~UpnpDescriptionSnapshot();
+
+    UpnpDescriptionSnapshot &operator=(UpnpDescriptionSnapshot &&other) noexcept;
+
+    /**
+     * @brief insert will add or replace the description stored for its location url
+     *
+     * @param description is a fully parsed device description
+     * @param configId is the CONFIGID.UPNP.ORG value announced by the device or -1
+     */
+    void insert(const UpnpDeviceDescription &description, int configId = -1);
+
+    void remove(const QUrl &location);
+
+    /**
+     * @brief find will return the description stored for location if it is still valid
+     *
+     * @param location is the LOCATION url announced by the device
+     * @param configId is the CONFIGID.UPNP.ORG value announced by the device or -1
+     * @return the description or nothing if there is no entry for location or if the configuration changed
+     */
+    [[nodiscard]] std::optional<UpnpDeviceDescription> find(const QUrl &location, int configId = -1) const;
+
+    [[nodiscard]] bool contains(const QUrl &location, int configId = -1) const;
+
+    [[nodiscard]] QList<QUrl> locations() const;
+
+    /**
+     * @brief descriptions will decode and return all stored descriptions
+     */
+    [[nodiscard]] QList<UpnpDeviceDescription> descriptions() const;
+
+    [[nodiscard]] int size() const;
+
+    void clear();
+
+    /**
+     * @brief save will atomically write all stored descriptions to fileName
+     *
+     * @return true if the file was written
+     */
+    bool save(const QString &fileName) const;
+
+    /**
+     * @brief load will replace the content of this snapshot by the content of fileName
+     *
+     * Files written with another format version or truncated files are rejected and leave the snapshot empty.
+     *
+     * @return true if the file could be read
+     */
+    bool load(const QString &fileName);
+
+private:
+    std::unique_ptr<UpnpDescriptionSnapshotPrivate> d;
+};
+
+#endif // UPNPDESCRIPTIONSNAPSHOT_H
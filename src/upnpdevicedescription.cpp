@@ -9,6 +9,7 @@
 #include "upnpactiondescription.h"
 
 #include <QBuffer>
+#include <QDataStream>
 #include <QIODevice>
 #include <QPointer>
 #include <QXmlStreamWriter>
@@ -279,3 +280,51 @@ int UpnpDeviceDescription::addService(UpnpServiceDescription newService)
     d->mServices.push_back(std::move(newService));
     return d->mServices.count() - 1;
 }
+
+QDataStream &operator<<(QDataStream &stream, const UpnpDeviceDescription &data)
+{
+    stream << data.UDN() << data.UPC() << data.deviceType() << data.friendlyName() << data.manufacturer() << data.manufacturerURL()
+           << data.modelDescription() << data.modelName() << data.modelNumber() << data.modelURL() << data.serialNumber()
+           << data.URLBase() << static_cast<qint32>(data.cacheControl()) << data.locationUrl() << data.services();
+
+    return stream;
+}
+
+QDataStream &operator>>(QDataStream &stream, UpnpDeviceDescription &data)
+{
+    QString UDN;
+    QString UPC;
+    QString deviceType;
+    QString friendlyName;
+    QString manufacturer;
+    QUrl manufacturerURL;
+    QString modelDescription;
+    QString modelName;
+    QString modelNumber;
+    QUrl modelURL;
+    QString serialNumber;
+    QString URLBase;
+    qint32 cacheControl = 0;
+    QUrl locationUrl;
+
+    stream >> UDN >> UPC >> deviceType >> friendlyName >> manufacturer >> manufacturerURL
+        >> modelDescription >> modelName >> modelNumber >> modelURL >> serialNumber
+        >> URLBase >> cacheControl >> locationUrl >> data.services();
+
+    data.setUDN(UDN);
+    data.setUPC(UPC);
+    data.setDeviceType(deviceType);
+    data.setFriendlyName(friendlyName);
+    data.setManufacturer(manufacturer);
+    data.setManufacturerURL(manufacturerURL);
+    data.setModelDescription(modelDescription);
+    data.setModelName(modelName);
+    data.setModelNumber(modelNumber);
+    data.setModelURL(modelURL);
+    data.setSerialNumber(serialNumber);
+    data.setURLBase(URLBase);
+    data.setCacheControl(cacheControl);
+    data.setLocationUrl(locationUrl);
+
+    return stream;
+}
@@ -15,6 +15,7 @@
 #include <memory>
 
 class UpnpServiceDescription;
+class QDataStream;
 class UpnpDeviceDescriptionPrivate;
 
 /**
@@ -146,6 +147,10 @@ private:
     std::unique_ptr<UpnpDeviceDescriptionPrivate> d;
 };
 
+UPNPLIBQT_EXPORT QDataStream &operator<<(QDataStream &stream, const UpnpDeviceDescription &data);
+
+UPNPLIBQT_EXPORT QDataStream &operator>>(QDataStream &stream, UpnpDeviceDescription &data);
+
 Q_DECLARE_METATYPE(UpnpDeviceDescription)
 
 #endif
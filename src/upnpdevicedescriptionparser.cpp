@@ -8,6 +8,8 @@
 
 #include "upnplogging.h"
 
+#include "upnpdescriptionfetchscheduler.h"
+#include "upnpdescriptionparsingpool.h"
 #include "upnpdevicedescription.h"
 #include "upnpservicedescription.h"
 
@@ -19,6 +21,8 @@
 
 #include <QDomDocument>
 
+#include <QPointer>
+
 #include <QLoggingCategory>
 
 class UpnpDeviceDescriptionParserPrivate
@@ -38,6 +42,14 @@ public:
     std::map<QString, std::unique_ptr<UpnpServiceDescriptionParser>> mServiceDescriptionParsers;
 
     QUrl mDeviceURL;
+
+    UpnpDescriptionParsingPool *mParsingPool = nullptr;
+
+    QPointer<UpnpDescriptionFetchScheduler> mFetchScheduler;
+
+    quint64 mFetchId = 0;
+
+    bool mLazyServiceDescriptions = false;
 };
 
 UpnpDeviceDescriptionParser::UpnpDeviceDescriptionParser(QNetworkAccessManager *aNetworkAccess, UpnpDeviceDescription &deviceDescription, QObject *parent)
@@ -46,11 +58,45 @@ UpnpDeviceDescriptionParser::UpnpDeviceDescriptionParser(QNetworkAccessManager *
 {
 }
 
-UpnpDeviceDescriptionParser::~UpnpDeviceDescriptionParser() = default;
+UpnpDeviceDescriptionParser::~UpnpDeviceDescriptionParser()
+{
+    if (d->mFetchScheduler && d->mFetchId) {
+        d->mFetchScheduler->cancel(d->mFetchId);
+    }
+}
+
+void UpnpDeviceDescriptionParser::setParsingPool(UpnpDescriptionParsingPool *pool)
+{
+    d->mParsingPool = pool;
+}
+
+void UpnpDeviceDescriptionParser::setFetchScheduler(UpnpDescriptionFetchScheduler *scheduler)
+{
+    d->mFetchScheduler = scheduler;
+}
+
+void UpnpDeviceDescriptionParser::setLazyServiceDescriptions(bool value)
+{
+    d->mLazyServiceDescriptions = value;
+}
+
+bool UpnpDeviceDescriptionParser::lazyServiceDescriptions() const
+{
+    return d->mLazyServiceDescriptions;
+}
 
 void UpnpDeviceDescriptionParser::downloadDeviceDescription(const QUrl &deviceUrl)
 {
     d->mDeviceURL = deviceUrl;
+
+    if (d->mFetchScheduler) {
+        d->mFetchId = d->mFetchScheduler->fetch(deviceUrl, d->mDeviceDescription.deviceType(), this, [this](QNetworkReply *reply) {
+            d->mFetchId = 0;
+            finishedDownload(reply);
+        });
+        return;
+    }
+
     d->mNetworkAccess->get(QNetworkRequest(deviceUrl));
 }
 
@@ -70,7 +116,7 @@ void UpnpDeviceDescriptionParser::finishedDownload(QNetworkReply *reply)
     qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpDeviceDescriptionParser::finishedDownload";
     if (reply->url() == d->mDeviceURL) {
         if (reply->isFinished() && reply->error() == QNetworkReply::NoError) {
-            parseDeviceDescription(reply, reply->url().adjusted(QUrl::RemovePath).toString());
+            parseDeviceDescription(reply->readAll(), reply->url().adjusted(QUrl::RemovePath).toString());
         } else if (reply->isFinished()) {
             qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpDeviceDescriptionParser::finishedDownload"
                                            << "error when downloading device description";
@@ -82,10 +128,82 @@ void UpnpDeviceDescriptionParser::finishedDownload(QNetworkReply *reply)
     }
 }
 
-void UpnpDeviceDescriptionParser::parseDeviceDescription(QIODevice *deviceDescriptionContent, const QString &fallBackURLBase)
+void UpnpDeviceDescriptionParser::parseDeviceDescription(const QByteArray &deviceDescriptionContent, const QString &fallBackURLBase)
 {
+    if (!d->mParsingPool) {
+        deviceDescriptionContentParsed(parseDeviceDescriptionContent(deviceDescriptionContent, fallBackURLBase));
+        return;
+    }
+
+    auto parsedDescription = std::make_shared<UpnpDeviceDescription>();
+
+    d->mParsingPool->run(
+        this,
+        [parsedDescription, deviceDescriptionContent, fallBackURLBase]() {
+            *parsedDescription = parseDeviceDescriptionContent(deviceDescriptionContent, fallBackURLBase);
+        },
+        [this, parsedDescription]() {
+            deviceDescriptionContentParsed(*parsedDescription);
+        });
+}
+
+void UpnpDeviceDescriptionParser::deviceDescriptionContentParsed(const UpnpDeviceDescription &parsedDescription)
+{
+    d->mDeviceDescription.setUDN(parsedDescription.UDN());
+    d->mDeviceDescription.setUPC(parsedDescription.UPC());
+    d->mDeviceDescription.setDeviceType(parsedDescription.deviceType());
+    d->mDeviceDescription.setFriendlyName(parsedDescription.friendlyName());
+    d->mDeviceDescription.setManufacturer(parsedDescription.manufacturer());
+    d->mDeviceDescription.setManufacturerURL(parsedDescription.manufacturerURL());
+    d->mDeviceDescription.setModelDescription(parsedDescription.modelDescription());
+    d->mDeviceDescription.setModelName(parsedDescription.modelName());
+    d->mDeviceDescription.setModelNumber(parsedDescription.modelNumber());
+    d->mDeviceDescription.setModelURL(parsedDescription.modelURL());
+    d->mDeviceDescription.setSerialNumber(parsedDescription.serialNumber());
+    d->mDeviceDescription.setURLBase(parsedDescription.URLBase());
+
+    const auto firstNewServiceIndex = d->mDeviceDescription.services().count();
+
+    for (const auto &oneService : parsedDescription.services()) {
+        d->mDeviceDescription.addService(oneService);
+    }
+
+    if (d->mLazyServiceDescriptions || firstNewServiceIndex == d->mDeviceDescription.services().count()) {
+        Q_EMIT descriptionParsed(d->mDeviceDescription.UDN());
+        return;
+    }
+
+    for (auto serviceIndex = firstNewServiceIndex; serviceIndex < d->mDeviceDescription.services().count(); ++serviceIndex) {
+        auto &serviceJustCreated = d->mDeviceDescription.serviceByIndex(serviceIndex);
+
+        QUrl serviceUrl(serviceJustCreated.SCPDURL().toString());
+        if (!serviceUrl.isValid() || serviceUrl.scheme().isEmpty()) {
+            serviceUrl.setUrl(d->mDeviceDescription.URLBase());
+            serviceUrl.setPath(serviceJustCreated.SCPDURL().toString());
+        }
+
+        auto &newParser = d->mServiceDescriptionParsers[serviceJustCreated.serviceId()];
+        newParser = std::make_unique<UpnpServiceDescriptionParser>(d->mNetworkAccess, serviceJustCreated);
+        newParser->setParsingPool(d->mParsingPool);
+        newParser->setFetchScheduler(d->mFetchScheduler);
+
+        connect(newParser.get(), &UpnpServiceDescriptionParser::descriptionParsed,
+            this, &UpnpDeviceDescriptionParser::serviceDescriptionParsed);
+        if (!d->mFetchScheduler) {
+            connect(d->mNetworkAccess, &QNetworkAccessManager::finished,
+                newParser.get(), &UpnpServiceDescriptionParser::finishedDownload);
+        }
+
+        newParser->downloadServiceDescription(serviceUrl);
+    }
+}
+
+UpnpDeviceDescription UpnpDeviceDescriptionParser::parseDeviceDescriptionContent(const QByteArray &content, const QString &fallBackURLBase)
+{
+    auto result = UpnpDeviceDescription {};
+
     QDomDocument deviceDescriptionDocument;
-    deviceDescriptionDocument.setContent(deviceDescriptionContent);
+    deviceDescriptionDocument.setContent(content);
 
     const QDomElement &documentRoot = deviceDescriptionDocument.documentElement();
 
@@ -109,22 +227,22 @@ void UpnpDeviceDescriptionParser::parseDeviceDescription(QIODevice *deviceDescri
         currentChild = currentChild.nextSibling();
     }
 
-    d->mDeviceDescription.setUDN(deviceDescription[QStringLiteral("UDN")].toString());
-    d->mDeviceDescription.setUPC(deviceDescription[QStringLiteral("UPC")].toString());
-    d->mDeviceDescription.setDeviceType(deviceDescription[QStringLiteral("deviceType")].toString());
-    d->mDeviceDescription.setFriendlyName(deviceDescription[QStringLiteral("friendlyName")].toString());
-    d->mDeviceDescription.setManufacturer(deviceDescription[QStringLiteral("manufacturer")].toString());
-    d->mDeviceDescription.setManufacturerURL(deviceDescription[QStringLiteral("manufacturerURL")].toUrl());
-    d->mDeviceDescription.setModelDescription(deviceDescription[QStringLiteral("modelDescription")].toString());
-    d->mDeviceDescription.setModelName(deviceDescription[QStringLiteral("modelName")].toString());
-    d->mDeviceDescription.setModelNumber(deviceDescription[QStringLiteral("modelNumber")].toString());
-    d->mDeviceDescription.setModelURL(deviceDescription[QStringLiteral("modelURL")].toUrl());
-    d->mDeviceDescription.setSerialNumber(deviceDescription[QStringLiteral("serialNumber")].toString());
+    result.setUDN(deviceDescription[QStringLiteral("UDN")].toString());
+    result.setUPC(deviceDescription[QStringLiteral("UPC")].toString());
+    result.setDeviceType(deviceDescription[QStringLiteral("deviceType")].toString());
+    result.setFriendlyName(deviceDescription[QStringLiteral("friendlyName")].toString());
+    result.setManufacturer(deviceDescription[QStringLiteral("manufacturer")].toString());
+    result.setManufacturerURL(deviceDescription[QStringLiteral("manufacturerURL")].toUrl());
+    result.setModelDescription(deviceDescription[QStringLiteral("modelDescription")].toString());
+    result.setModelName(deviceDescription[QStringLiteral("modelName")].toString());
+    result.setModelNumber(deviceDescription[QStringLiteral("modelNumber")].toString());
+    result.setModelURL(deviceDescription[QStringLiteral("modelURL")].toUrl());
+    result.setSerialNumber(deviceDescription[QStringLiteral("serialNumber")].toString());
 
     if (deviceDescription[QStringLiteral("URLBase")].isValid() && !deviceDescription[QStringLiteral("URLBase")].toString().isEmpty()) {
-        d->mDeviceDescription.setURLBase(deviceDescription[QStringLiteral("URLBase")].toString());
+        result.setURLBase(deviceDescription[QStringLiteral("URLBase")].toString());
     } else {
-        d->mDeviceDescription.setURLBase(fallBackURLBase);
+        result.setURLBase(fallBackURLBase);
     }
 
     auto serviceList = deviceDescriptionDocument.elementsByTagName(QStringLiteral("service"));
@@ -154,7 +272,7 @@ void UpnpDeviceDescriptionParser::parseDeviceDescription(QIODevice *deviceDescri
             }
 #endif
 
-            newService.setBaseURL(d->mDeviceDescription.URLBase());
+            newService.setBaseURL(result.URLBase());
             if (!serviceTypeNode.isNull()) {
                 newService.setServiceType(serviceTypeNode.toElement().text());
             }
@@ -173,7 +291,7 @@ void UpnpDeviceDescriptionParser::parseDeviceDescription(QIODevice *deviceDescri
             if (!controlURLNode.isNull()) {
                 QUrl controlUrl(controlURLNode.toElement().text());
                 if (!controlUrl.isValid() || controlUrl.scheme().isEmpty()) {
-                    controlUrl = QUrl(d->mDeviceDescription.URLBase());
+                    controlUrl = QUrl(result.URLBase());
                     controlUrl.setPath(controlURLNode.toElement().text());
                 }
                 newService.setControlURL(controlUrl);
@@ -183,32 +301,17 @@ void UpnpDeviceDescriptionParser::parseDeviceDescription(QIODevice *deviceDescri
             if (!eventSubURLNode.isNull()) {
                 QUrl eventUrl(eventSubURLNode.toElement().text());
                 if (!eventUrl.isValid() || eventUrl.scheme().isEmpty()) {
-                    eventUrl = QUrl(d->mDeviceDescription.URLBase());
+                    eventUrl = QUrl(result.URLBase());
                     eventUrl.setPath(eventSubURLNode.toElement().text());
                 }
                 newService.setEventURL(eventUrl);
             }
 
-            QUrl serviceUrl(newService.SCPDURL().toString());
-            if (!serviceUrl.isValid() || serviceUrl.scheme().isEmpty()) {
-                serviceUrl.setUrl(d->mDeviceDescription.URLBase());
-                serviceUrl.setPath(newService.SCPDURL().toString());
-            }
-
-            d->mDeviceDescription.addService(std::move(newService));
-
-            auto &serviceJustCreated = d->mDeviceDescription.serviceByIndex(serviceIndex);
-            d->mServiceDescriptionParsers[serviceJustCreated.serviceId()]
-                    = std::make_unique<UpnpServiceDescriptionParser>(d->mNetworkAccess, d->mDeviceDescription.serviceByIndex(serviceIndex));
-
-            connect(d->mServiceDescriptionParsers[serviceJustCreated.serviceId()].get(), &UpnpServiceDescriptionParser::descriptionParsed,
-                this, &UpnpDeviceDescriptionParser::serviceDescriptionParsed);
-            connect(d->mNetworkAccess, &QNetworkAccessManager::finished,
-                d->mServiceDescriptionParsers[serviceJustCreated.serviceId()].get(), &UpnpServiceDescriptionParser::finishedDownload);
-
-            d->mServiceDescriptionParsers[serviceJustCreated.serviceId()]->downloadServiceDescription(serviceUrl);
+            result.addService(std::move(newService));
         }
     }
+
+    return result;
 }
 
 #include "moc_upnpdevicedescriptionparser.cpp"
@@ -21,6 +21,8 @@ class QIODevice;
 class QNetworkAccessManager;
 
 class UpnpDeviceDescription;
+class UpnpDescriptionParsingPool;
+class UpnpDescriptionFetchScheduler;
 
 class UpnpDeviceDescriptionParserPrivate;
 
@@ -36,6 +38,47 @@ public:
 
     ~UpnpDeviceDescriptionParser() override;
 
+    /**
+     * @brief setParsingPool will move the parsing of the device and service descriptions to pool
+     *
+     * If no pool is set, descriptions are parsed synchronously when their download is finished.
+     * The pool must live in the same thread as the parser.
+     */
+    void setParsingPool(UpnpDescriptionParsingPool *pool);
+
+    /**
+     * @brief setFetchScheduler will make the downloads of the device and service descriptions go through scheduler
+     *
+     * The device type set in the device description before calling downloadDeviceDescription (i.e. from the SSDP
+     * discovery) is used to choose the priority of the device description download.
+     * If no scheduler is set, downloads are started immediately and finishedDownload must be connected to the
+     * QNetworkAccessManager::finished signal.
+     */
+    void setFetchScheduler(UpnpDescriptionFetchScheduler *scheduler);
+
+    /**
+     * @brief setLazyServiceDescriptions will skip the download of the service descriptions
+     *
+     * In lazy mode, descriptionParsed is emitted as soon as the device description is parsed. The services have no
+     * actions and no state variables. \class UpnpControlAbstractService downloads them on first use.
+     *
+     * @param value is true to enable the lazy mode
+     */
+    void setLazyServiceDescriptions(bool value);
+
+    [[nodiscard]] bool lazyServiceDescriptions() const;
+
+    /**
+     * @brief parseDeviceDescriptionContent parses a device description document
+     *
+     * It only reads its arguments and can be called from any thread. Services are returned without their actions
+     * and state variables that are described in a separate document.
+     *
+     * @param content is the device description XML document
+     * @param fallBackURLBase is used as URLBase if the document does not provide one
+     */
+    [[nodiscard]] static UpnpDeviceDescription parseDeviceDescriptionContent(const QByteArray &content, const QString &fallBackURLBase);
+
 Q_SIGNALS:
 
     void descriptionParsed(const QString &UDN);
@@ -53,7 +96,9 @@ private Q_SLOTS:
     void serviceDescriptionParsed(const QString &upnpServiceId);
 
 private:
-    void parseDeviceDescription(QIODevice *deviceDescriptionContent, const QString &fallBackURLBase);
+    void parseDeviceDescription(const QByteArray &deviceDescriptionContent, const QString &fallBackURLBase);
+
+    void deviceDescriptionContentParsed(const UpnpDeviceDescription &parsedDescription);
 
     std::unique_ptr<UpnpDeviceDescriptionParserPrivate> d;
 };
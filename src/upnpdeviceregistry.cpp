@@ -0,0 +1,81 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpdeviceregistry.h"
+
+#include <QMetaObject>
+#include <QMutexLocker>
+#include <QThread>
+
+UpnpDeviceRegistry::UpnpDeviceRegistry()
+    : mSnapshot(std::make_shared<const UpnpDeviceRouteTable>())
+{
+}
+
+std::shared_ptr<const UpnpDeviceRouteTable> UpnpDeviceRegistry::snapshot() const
+{
+    QMutexLocker locker(&mSnapshotMutex);
+
+    return mSnapshot;
+}
+
+void UpnpDeviceRegistry::update(const std::function<void(UpnpDeviceRouteTable &)> &modifier)
+{
+    QMutexLocker updateLocker(&mUpdateMutex);
+
+    auto newTable = std::make_shared<UpnpDeviceRouteTable>(*snapshot());
+    modifier(*newTable);
+
+    QMutexLocker snapshotLocker(&mSnapshotMutex);
+
+    mSnapshot = std::move(newTable);
+}
+
+bool UpnpDeviceRegistry::invoke(const std::function<void()> &function)
+{
+    if (mContext.thread() == QThread::currentThread()) {
+        function();
+        return true;
+    }
+
+    auto isFinished = std::make_shared<bool>(false);
+
+    QMutexLocker locker(&mCallMutex);
+
+    if (mIsClosed) {
+        return false;
+    }
+
+    QMetaObject::invokeMethod(&mContext, [this, &function, isFinished]() {
+        // close is called in this thread: while the registry is open, the caller is still waiting
+        {
+            QMutexLocker callLocker(&mCallMutex);
+            if (mIsClosed) {
+                return;
+            }
+        }
+
+        function();
+
+        QMutexLocker callLocker(&mCallMutex);
+        *isFinished = true;
+        mCallFinished.wakeAll();
+    });
+
+    while (!*isFinished && !mIsClosed) {
+        mCallFinished.wait(&mCallMutex);
+    }
+
+    return *isFinished;
+}
+
+void UpnpDeviceRegistry::close()
+{
+    QMutexLocker locker(&mCallMutex);
+
+    mIsClosed = true;
+    mCallFinished.wakeAll();
+}
@@ -0,0 +1,84 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef UPNPDEVICEREGISTRY_H
+#define UPNPDEVICEREGISTRY_H
+
+#include "upnplibqt_export.h"
+
+#include "upnpdeviceroutetable.h"
+
+#include <QMutex>
+#include <QObject>
+#include <QWaitCondition>
+
+#include <functional>
+#include <memory>
+
+/**
+ * @brief The UpnpDeviceRegistry class publishes the route table of hosted devices to the threads serving requests
+ *
+ * Readers take an immutable snapshot of the table and keep using it for the whole request, without holding any lock.
+ * Writers copy the current table, modify the copy and publish it (copy on write). A snapshot stays valid after
+ * newer tables are published.
+ *
+ * Devices and services are not thread safe: the description documents are published with the routes and the
+ * threads serving requests only use devices through invoke, in the thread that created the registry.
+ */
+class UPNPLIBQT_EXPORT UpnpDeviceRegistry
+{
+public:
+    UpnpDeviceRegistry();
+
+    [[nodiscard]] std::shared_ptr<const UpnpDeviceRouteTable> snapshot() const;
+
+    /**
+     * @brief update will publish a copy of the current table modified by modifier
+     *
+     * Updates are serialized, readers see either the table before or after the update.
+     */
+    void update(const std::function<void(UpnpDeviceRouteTable &)> &modifier);
+
+    /**
+     * @brief invoke runs function in the thread that created the registry and waits for it
+     *
+     * @return false if the registry has been closed before function could run
+     */
+    bool invoke(const std::function<void()> &function);
+
+    /**
+     * @brief close will release the threads waiting in invoke, the functions not yet run are dropped
+     *
+     * It must be called in the thread that created the registry, before the threads serving requests are stopped.
+     */
+    void close();
+
+private:
+    /**
+     * @brief mSnapshotMutex is only held to copy or replace mSnapshot
+     */
+    mutable QMutex mSnapshotMutex;
+
+    QMutex mUpdateMutex;
+
+    std::shared_ptr<const UpnpDeviceRouteTable> mSnapshot;
+
+    /**
+     * @brief mContext receives the functions given to invoke, its pending calls are dropped with the registry
+     */
+    QObject mContext;
+
+    /**
+     * @brief mCallMutex protects mIsClosed and the completion of the functions given to invoke
+     */
+    QMutex mCallMutex;
+
+    QWaitCondition mCallFinished;
+
+    bool mIsClosed = false;
+};
+
+#endif // UPNPDEVICEREGISTRY_H
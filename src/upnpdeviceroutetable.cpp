@@ -0,0 +1,72 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpdeviceroutetable.h"
+
+#include "upnpabstractdevice.h"
+#include "upnpabstractservice.h"
+
+#include "upnpservicedescription.h"
+
+void UpnpDeviceRouteTable::addDevice(int deviceId, UpnpAbstractDevice *device)
+{
+    removeDevice(deviceId);
+
+    const QString devicePrefix = QLatin1Char('/') + QString::number(deviceId) + QLatin1Char('/');
+
+    addRoute(devicePrefix + QStringLiteral("device.xml"), {deviceId, -1, UpnpRouteKind::DeviceDescription, device->xmlDescription()});
+
+    const auto servicesCount = device->services().count();
+    for (int serviceIndex = 0; serviceIndex < servicesCount; ++serviceIndex) {
+        const QString servicePrefix = devicePrefix + QString::number(serviceIndex) + QLatin1Char('/');
+
+        // services added only with their description have no document
+        auto *serviceObject = device->serviceByIndex(serviceIndex);
+        const auto serviceDocument = (serviceObject ? serviceObject->xmlDescription() : QByteArray{});
+
+        addRoute(servicePrefix + QStringLiteral("service.xml"), {deviceId, serviceIndex, UpnpRouteKind::ServiceDescription, serviceDocument});
+        addRoute(servicePrefix + QStringLiteral("control"), {deviceId, serviceIndex, UpnpRouteKind::Control});
+        addRoute(servicePrefix + QStringLiteral("event"), {deviceId, serviceIndex, UpnpRouteKind::Event});
+    }
+}
+
+void UpnpDeviceRouteTable::removeDevice(int deviceId)
+{
+    const auto &allPaths = mDevicePaths.take(deviceId);
+    for (const auto &onePath : allPaths) {
+        mRoutes.remove(onePath);
+        mRawRoutes.remove(onePath.toLatin1());
+    }
+}
+
+void UpnpDeviceRouteTable::clear()
+{
+    mRoutes.clear();
+    mRawRoutes.clear();
+    mDevicePaths.clear();
+}
+
+UpnpRoute UpnpDeviceRouteTable::route(const QString &path) const
+{
+    return mRoutes.value(path);
+}
+
+UpnpRoute UpnpDeviceRouteTable::route(const QByteArray &path) const
+{
+    return mRawRoutes.value(path);
+}
+
+int UpnpDeviceRouteTable::size() const
+{
+    return mRoutes.size();
+}
+
+void UpnpDeviceRouteTable::addRoute(const QString &path, const UpnpRoute &newRoute)
+{
+    mRoutes[path] = newRoute;
+    mRawRoutes[path.toLatin1()] = newRoute;
+    mDevicePaths[newRoute.mDeviceId].push_back(path);
+}
@@ -0,0 +1,105 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef UPNPDEVICEROUTETABLE_H
+#define UPNPDEVICEROUTETABLE_H
+
+#include "upnplibqt_export.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+
+class UpnpAbstractDevice;
+
+enum class UpnpRouteKind {
+    Invalid,
+    DeviceDescription,
+    ServiceDescription,
+    Control,
+    Event,
+};
+
+/**
+ * @brief The UpnpRoute class is the target of a request path served by \class UpnpDeviceSoapServer
+ *
+ * It only identifies the device by its handle: routes are read by the threads serving requests while devices can be
+ * removed and destroyed in the thread of the server.
+ */
+class UPNPLIBQT_EXPORT UpnpRoute
+{
+public:
+    /**
+     * @brief mDeviceId is the handle of the device returned by \class UpnpDeviceSoapServer::addDevice
+     */
+    int mDeviceId = -1;
+
+    /**
+     * @brief mServiceIndex is the index of the service in the device or -1 for the device description
+     */
+    int mServiceIndex = -1;
+
+    UpnpRouteKind mKind = UpnpRouteKind::Invalid;
+
+    /**
+     * @brief mDocument is the serialized description served by a description route, null if there is none
+     *
+     * It is built in the thread of the server when the table is updated and only read by the threads serving requests.
+     */
+    QByteArray mDocument;
+
+    [[nodiscard]] bool isValid() const
+    {
+        return mKind != UpnpRouteKind::Invalid;
+    }
+};
+
+/**
+ * @brief The UpnpDeviceRouteTable class maps the request paths of hosted devices to their device and service
+ *
+ * The paths of a device are computed when it is added: /<device>/device.xml for its description and
+ * /<device>/<service>/service.xml, /<device>/<service>/control and /<device>/<service>/event for each service, with
+ * <device> the stable handle of the device. Routing a request is then a single hash lookup without splitting the path
+ * or parsing indexes. Removing a device only removes its own paths.
+ *
+ * The description routes carry the documents of the device and of the services added with their object, so that
+ * they are served without using the device. addDevice must be called again when they change.
+ */
+class UPNPLIBQT_EXPORT UpnpDeviceRouteTable
+{
+public:
+    /**
+     * @brief addDevice will add or replace the routes of device, it must be called in the thread of the device
+     */
+    void addDevice(int deviceId, UpnpAbstractDevice *device);
+
+    void removeDevice(int deviceId);
+
+    void clear();
+
+    [[nodiscard]] UpnpRoute route(const QString &path) const;
+
+    /**
+     * @brief route returns the route of a path given as raw bytes like the _path header of KDSoap requests
+     */
+    [[nodiscard]] UpnpRoute route(const QByteArray &path) const;
+
+    /**
+     * @brief size is the number of known paths
+     */
+    [[nodiscard]] int size() const;
+
+private:
+    void addRoute(const QString &path, const UpnpRoute &newRoute);
+
+    QHash<QString, UpnpRoute> mRoutes;
+
+    QHash<QByteArray, UpnpRoute> mRawRoutes;
+
+    QHash<int, QList<QString>> mDevicePaths;
+};
+
+#endif // UPNPDEVICEROUTETABLE_H
@@ -6,9 +6,13 @@
 
 #include "upnpdevicesoapserver.h"
 #include "upnpabstractdevice.h"
+#include "upnpdeviceregistry.h"
 #include "upnpdevicesoapserverobject.h"
 
-#include <QList>
+#include <KDSoapServer/KDSoapThreadPool.h>
+
+#include <QHash>
+#include <QPointer>
 #include <QUrl>
 
 #include <QNetworkInterface>
@@ -16,7 +20,18 @@
 class UpnpDeviceSoapServerPrivate
 {
 public:
-    QList<UpnpAbstractDevice *> mDevices;
+    /**
+     * @brief mDevices are the served devices indexed by their handle, they are only used in the thread of the server
+     */
+    QHash<int, QPointer<UpnpAbstractDevice>> mDevices;
+
+    int mNextDeviceId = 0;
+
+    UpnpDeviceRegistry mRegistry;
+
+    std::unique_ptr<KDSoapThreadPool> mThreadPool;
+
+    int mMaximumThreadCount = 0;
 };
 
 UpnpDeviceSoapServer::UpnpDeviceSoapServer(QObject *parent)
@@ -26,22 +41,94 @@ UpnpDeviceSoapServer::UpnpDeviceSoapServer(QObject *parent)
     listen();
 }
 
-UpnpDeviceSoapServer::~UpnpDeviceSoapServer() = default;
+UpnpDeviceSoapServer::~UpnpDeviceSoapServer()
+{
+    // the threads of the pool can be waiting for this thread, they must be released before the pool is destroyed
+    d->mRegistry.close();
+}
 
 int UpnpDeviceSoapServer::addDevice(UpnpAbstractDevice *device)
 {
-    d->mDevices.push_back(device);
-    return d->mDevices.count() - 1;
+    const auto newDeviceId = d->mNextDeviceId++;
+    d->mDevices[newDeviceId] = device;
+
+    d->mRegistry.update([newDeviceId, device](UpnpDeviceRouteTable &routes) {
+        routes.addDevice(newDeviceId, device);
+    });
+
+    // the routes carry the description documents: they follow the services added later and the changes of the documents
+    connect(device, &UpnpAbstractDevice::xmlDescriptionInvalidated, this, [this, newDeviceId, device]() {
+        if (d->mDevices.value(newDeviceId) == device) {
+            d->mRegistry.update([newDeviceId, device](UpnpDeviceRouteTable &routes) {
+                routes.addDevice(newDeviceId, device);
+            });
+        }
+    });
+
+    connect(device, &QObject::destroyed, this, [this, newDeviceId]() {
+        removeDevice(newDeviceId);
+    });
+
+    return newDeviceId;
+}
+
+void UpnpDeviceSoapServer::removeDevice(int deviceId)
+{
+    const auto itDevice = d->mDevices.find(deviceId);
+    if (itDevice == d->mDevices.end()) {
+        return;
+    }
+
+    if (*itDevice) {
+        disconnect(itDevice->data(), nullptr, this, nullptr);
+    }
+
+    d->mDevices.erase(itDevice);
+
+    d->mRegistry.update([deviceId](UpnpDeviceRouteTable &routes) {
+        routes.removeDevice(deviceId);
+    });
 }
 
-void UpnpDeviceSoapServer::removeDevice(int index)
+UpnpAbstractDevice *UpnpDeviceSoapServer::device(int deviceId) const
 {
-    d->mDevices.removeAt(index);
+    return d->mDevices.value(deviceId);
 }
 
 QObject *UpnpDeviceSoapServer::createServerObject()
 {
-    return new UpnpDeviceSoapServerObject(d->mDevices);
+    // called once in each thread serving requests
+    return new UpnpDeviceSoapServerObject(this, d->mRegistry);
+}
+
+int UpnpDeviceSoapServer::maximumThreadCount() const
+{
+    return d->mMaximumThreadCount;
+}
+
+void UpnpDeviceSoapServer::setMaximumThreadCount(int value)
+{
+    if (d->mMaximumThreadCount == value || value < 0) {
+        return;
+    }
+
+    d->mMaximumThreadCount = value;
+
+    if (d->mMaximumThreadCount > 0) {
+        if (!d->mThreadPool) {
+            d->mThreadPool = std::make_unique<KDSoapThreadPool>();
+        }
+
+        d->mThreadPool->setMaxThreadCount(d->mMaximumThreadCount);
+
+        // the pool can have been detached by a previous count of 0
+        setThreadPool(d->mThreadPool.get());
+    } else if (d->mThreadPool) {
+        // the pool keeps serving the connections already accepted until it is destroyed with the server
+        setThreadPool(nullptr);
+    }
+
+    Q_EMIT maximumThreadCountChanged();
 }
 
 QUrl UpnpDeviceSoapServer::urlPrefix() const
@@ -24,19 +24,66 @@ class UpnpDeviceSoapServerPrivate;
 class UPNPLIBQT_EXPORT UpnpDeviceSoapServer : public KDSoapServer
 {
     Q_OBJECT
+
+    Q_PROPERTY(int maximumThreadCount
+            READ maximumThreadCount
+                WRITE setMaximumThreadCount
+                    NOTIFY maximumThreadCountChanged)
+
 public:
     explicit UpnpDeviceSoapServer(QObject *parent = nullptr);
 
     ~UpnpDeviceSoapServer() override;
 
+    /**
+     * @brief addDevice will serve device and its services
+     *
+     * @return the handle of the device, it is part of the URLs of the device and stays valid until the device is
+     * removed. Handles are never reused by the same server.
+     */
     int addDevice(UpnpAbstractDevice *device);
 
-    void removeDevice(int index);
+    /**
+     * @brief removeDevice will stop serving the device with handle deviceId, the URLs of other devices do not change
+     *
+     * A device destroyed while it is served is removed automatically.
+     */
+    void removeDevice(int deviceId);
+
+    /**
+     * @brief device returns the device with handle deviceId or nullptr
+     */
+    [[nodiscard]] UpnpAbstractDevice *device(int deviceId) const;
 
     QObject *createServerObject() override;
 
     [[nodiscard]] QUrl urlPrefix() const;
 
+    /**
+     * @brief maximumThreadCount is the number of threads serving requests, 0 to serve them in the thread of the server
+     *
+     * With threads, requests are parsed and routed in the worker threads with immutable snapshots of the route table
+     * (see \class UpnpDeviceRegistry). The description documents are published in the snapshots and served by the
+     * workers. Devices and services are only used in the thread of the server: the workers wait for it to run
+     * actions. Devices can be added, removed or destroyed while requests are served, the requests for a device that is
+     * gone are answered with errors.
+     */
+    [[nodiscard]] int maximumThreadCount() const;
+
+Q_SIGNALS:
+
+    void maximumThreadCountChanged();
+
+public Q_SLOTS:
+
+    /**
+     * @brief setMaximumThreadCount will serve requests with up to value worker threads
+     *
+     * Only the parsing of requests and the description documents scale with the threads: action handlers still run
+     * one at a time in the thread of the server.
+     */
+    void setMaximumThreadCount(int value);
+
 private:
     std::unique_ptr<UpnpDeviceSoapServerPrivate> d;
 };
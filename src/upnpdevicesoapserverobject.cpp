@@ -11,14 +11,18 @@
 #include "upnpabstractdevice.h"
 #include "upnpabstractservice.h"
 #include "upnpbasictypes.h"
+#include "upnpdeviceregistry.h"
+#include "upnpdevicesoapserver.h"
 #include "upnpeventsubscriber.h"
 
 #include "upnpactiondescription.h"
 #include "upnpdevicedescription.h"
 #include "upnpservicedescription.h"
 
+#include "KDSoapClient/KDSoapMessage.h"
 #include "KDSoapClient/KDSoapValue.h"
 
+#include <QBuffer>
 #include <QDateTime>
 #include <QList>
 #include <QLoggingCategory>
@@ -27,21 +31,87 @@
 #include <QSysInfo>
 #include <QVariant>
 
+namespace
+{
+
+/**
+ * @brief upnpFault builds the SOAP fault of an UPnP error with its UPnPError detail
+ *
+ * The fault code is qualified with the prefix used by KDSoap for the SOAP envelope namespace.
+ */
+KDSoapMessage upnpFault(int errorCode, const QString &errorDescription)
+{
+    auto result = KDSoapMessage::createFaultMessage(QStringLiteral("soap:Client"), QStringLiteral("UPnPError"));
+
+    KDSoapValue upnpError(QStringLiteral("UPnPError"), QVariant());
+    upnpError.setNamespaceUri(QStringLiteral("urn:schemas-upnp-org:control-1-0"));
+    upnpError.childValues().append(KDSoapValue(QStringLiteral("errorCode"), errorCode));
+    upnpError.childValues().append(KDSoapValue(QStringLiteral("errorDescription"), errorDescription));
+
+    KDSoapValue detail(QStringLiteral("detail"), QVariant());
+    detail.childValues().append(upnpError);
+    result.childValues().append(detail);
+
+    return result;
+}
+
+KDSoapMessage invalidActionFault()
+{
+    return upnpFault(401, QStringLiteral("Invalid Action"));
+}
+
+KDSoapMessage invalidArgsFault()
+{
+    return upnpFault(402, QStringLiteral("Invalid Args"));
+}
+
+KDSoapMessage actionFailedFault()
+{
+    return upnpFault(501, QStringLiteral("Action Failed"));
+}
+
+/**
+ * @brief hasValidInputArguments is true when the input arguments have the names and the order of the action description
+ */
+bool hasValidInputArguments(const UpnpActionDescription &action, const QList<QPair<QString, QString>> &inputArguments)
+{
+    qsizetype inputIndex = 0;
+
+    for (const auto &oneArgument : action.mArguments) {
+        if (oneArgument.mDirection != UpnpArgumentDirection::In) {
+            continue;
+        }
+
+        if (inputIndex >= inputArguments.size() || inputArguments[inputIndex].first != oneArgument.mName) {
+            return false;
+        }
+
+        ++inputIndex;
+    }
+
+    return inputIndex == inputArguments.size();
+}
+
+}
+
 class UpnpDeviceSoapServerObjectPrivate
 {
 public:
-    explicit UpnpDeviceSoapServerObjectPrivate(QList<UpnpAbstractDevice *> &devices)
-        : mDevices(devices)
+    UpnpDeviceSoapServerObjectPrivate(const UpnpDeviceSoapServer *server, UpnpDeviceRegistry &registry)
+        : mServer(server)
+        , mRegistry(registry)
     {
     }
 
-    QList<UpnpAbstractDevice *> &mDevices;
+    const UpnpDeviceSoapServer *mServer;
+
+    UpnpDeviceRegistry &mRegistry;
 };
 
-UpnpDeviceSoapServerObject::UpnpDeviceSoapServerObject(QList<UpnpAbstractDevice *> &devices, QObject *parent)
+UpnpDeviceSoapServerObject::UpnpDeviceSoapServerObject(const UpnpDeviceSoapServer *server, UpnpDeviceRegistry &registry, QObject *parent)
     : QObject(parent)
     , KDSoapServerObjectInterface()
-    , d(std::make_unique<UpnpDeviceSoapServerObjectPrivate>(devices))
+    , d(std::make_unique<UpnpDeviceSoapServerObjectPrivate>(server, registry))
 {
 }
 
@@ -59,65 +129,103 @@ void UpnpDeviceSoapServerObject::processRequest(const KDSoapMessage &request, KD
 
 QIODevice *UpnpDeviceSoapServerObject::processFileRequest(const QString &path, QByteArray &contentType)
 {
-    const QList<QString> &pathParts = path.split(QStringLiteral("/"));
-    if (pathParts.count() == 3 && pathParts.last() == QStringLiteral("device.xml")) {
-        const int deviceIndex = pathParts[1].toInt();
-        if (deviceIndex >= 0 && deviceIndex < d->mDevices.count()) {
-            return downloadDeviceXmlDescription(d->mDevices[deviceIndex], contentType).release();
-        }
-    } else if (pathParts.count() == 4 && pathParts.last() == QStringLiteral("service.xml")) {
-        const int deviceIndex = pathParts[1].toInt();
-        const int serviceIndex = pathParts[2].toInt();
-        if (deviceIndex >= 0 && deviceIndex < d->mDevices.count()) {
-            return downloadServiceXmlDescription(d->mDevices[deviceIndex], serviceIndex, contentType).release();
-        }
+    // only description routes have a document, it was built in the thread of the server when the route table was published
+    const auto currentRoute = d->mRegistry.snapshot()->route(path);
+    if (currentRoute.mDocument.isNull()) {
+        return nullptr;
     }
 
-    return nullptr;
+    contentType = "text/xml";
+
+    // each request gets its own read position in the thread serving it
+    auto result = std::make_unique<QBuffer>();
+    result->setData(currentRoute.mDocument);
+    result->open(QIODevice::ReadOnly);
+
+    return result.release();
 }
 
 void UpnpDeviceSoapServerObject::processRequestWithPath(const KDSoapMessage &request, KDSoapMessage &response, const QByteArray &soapAction, const QString &path)
 {
-    Q_UNUSED(request)
-    Q_UNUSED(response)
-    Q_UNUSED(soapAction)
-
     qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpDeviceSoapServerObject::processRequestWithPath" << path << request.name();
 
-    const QList<QString> &pathParts = path.split(QStringLiteral("/"));
-    if (pathParts.count() != 4 || pathParts.last() != QStringLiteral("control")) {
-        response.setFault(true);
+    const auto currentRoute = d->mRegistry.snapshot()->route(path);
+    if (currentRoute.mKind != UpnpRouteKind::Control) {
+        response = invalidActionFault();
         return;
     }
 
-    const int deviceIndex = pathParts[1].toInt();
-    const int serviceIndex = pathParts[2].toInt();
+    // service implementations do not need to be thread safe, the request waits for the thread of the server
+    const auto isServed = d->mRegistry.invoke([this, &currentRoute, &request, &response, &soapAction]() {
+        serveAction(currentRoute, request, response, soapAction);
+    });
 
-    if (deviceIndex < 0 || deviceIndex >= d->mDevices.count()) {
-        response.setFault(true);
-        return;
+    if (!isServed) {
+        response = actionFailedFault();
     }
-    UpnpAbstractDevice *currentDevice = d->mDevices[deviceIndex];
+}
 
-    if (serviceIndex < 0 || serviceIndex >= currentDevice->services().count()) {
-        response.setFault(true);
+void UpnpDeviceSoapServerObject::serveAction(const UpnpRoute &route, const KDSoapMessage &request, KDSoapMessage &response, const QByteArray &soapAction)
+{
+    auto *currentDevice = d->mServer->device(route.mDeviceId);
+    if (!currentDevice) {
+        response = invalidActionFault();
         return;
     }
+
+    const int serviceIndex = route.mServiceIndex;
+
     auto currentService = currentDevice->serviceDescriptionByIndex(serviceIndex);
 
     const QList<QByteArray> &soapActionParts = soapAction.split('#');
     if (soapActionParts.size() != 2 || soapActionParts.first() != currentService.serviceType().toLatin1()) {
-        response.setFault(true);
+        response = invalidActionFault();
         return;
     }
 
     const QByteArray &actionName = soapActionParts.last();
     const QString &actionNameString = QString::fromLatin1(actionName);
 
+    const UpnpActionDescription &currentAction = currentService.action(actionNameString);
+    if (!currentAction.mIsValid) {
+        response = invalidActionFault();
+        return;
+    }
+
     response = KDSoapValue(actionNameString + QStringLiteral("Response"), QVariant(), currentService.serviceType());
 
+    auto *serviceObject = currentDevice->serviceByIndex(serviceIndex);
+    if (serviceObject) {
+        const KDSoapValueList &requestArguments(request.arguments());
+
+        QList<QPair<QString, QString>> inputArguments;
+        inputArguments.reserve(requestArguments.size());
+        for (const auto &oneArgument : requestArguments) {
+            inputArguments.push_back({oneArgument.name(), oneArgument.value().toString()});
+        }
+
+        if (!hasValidInputArguments(currentAction, inputArguments)) {
+            response = invalidArgsFault();
+            return;
+        }
+
+        QList<QPair<QString, QString>> outputArguments;
+
+        if (!serviceObject->dispatchAction(actionNameString, inputArguments, outputArguments)) {
+            response = actionFailedFault();
+            return;
+        }
+
+        response.setFault(false);
+        response.setType(currentService.serviceType(), actionNameString + QStringLiteral("Response"));
+        for (const auto &oneValue : outputArguments) {
+            response.addArgument(oneValue.first, oneValue.second);
+        }
+
+        return;
+    }
+
     const KDSoapValueList &allArguments(request.arguments());
-    const UpnpActionDescription &currentAction = currentService.action(actionNameString);
     qCDebug(orgKdeUpnpLibQtUpnp()) << "allArguments" << allArguments << "action arguments" << currentAction.mNumberInArgument;
 
     QVector<QVariant> checkedArguments;
@@ -154,7 +262,7 @@ void UpnpDeviceSoapServerObject::processRequestWithPath(const KDSoapMessage &req
 
     if (argumentError) {
         qCDebug(orgKdeUpnpLibQtUpnp()) << "error about arguments";
-        response.setFault(true);
+        response = invalidArgsFault();
         return;
     } else {
         bool actionCallIsInError = false;
@@ -162,7 +270,7 @@ void UpnpDeviceSoapServerObject::processRequestWithPath(const KDSoapMessage &req
         //const QList<QPair<QString, QVariant> > &returnedValues(currentService.invokeAction(actionNameString, checkedArguments, actionCallIsInError));
 
         if (actionCallIsInError) {
-            response.setFault(true);
+            response = actionFailedFault();
             return;
         } else {
             response.setFault(false);
@@ -179,48 +287,32 @@ bool UpnpDeviceSoapServerObject::processCustomVerbRequest(const QByteArray &requ
     const QMap<QByteArray, QByteArray> &httpHeaders, QByteArray &customAnswer)
 {
     if (requestType == "SUBSCRIBE") {
-        const QString &path = QString::fromLatin1(httpHeaders.value("_path"));
-        const QList<QString> &pathParts = path.split(QStringLiteral("/"));
-        if (pathParts.count() == 4 && pathParts.last() == QStringLiteral("event")) {
-            const int deviceIndex = pathParts[1].toInt();
-            const int serviceIndex = pathParts[2].toInt();
-            if (deviceIndex >= 0 && deviceIndex < d->mDevices.count()) {
-                UpnpAbstractDevice *currentDevice = d->mDevices[deviceIndex];
-                if (serviceIndex >= 0 && serviceIndex < currentDevice->services().count()) {
-                    //QPointer<UpnpEventSubscriber> newSubscriber = currentDevice->serviceByIndex(serviceIndex)->subscribeToEvents(requestData, httpHeaders);
-
-                    customAnswer = "HTTP/1.1 200 OK\r\n";
-                    customAnswer += "DATE: " + QDateTime::currentDateTime().toString(QStringLiteral("ddd, d MMM yyyy HH:mm:ss t")).toLatin1() + "\r\n";
-                    //customAnswer += "SID: uuid:" + newSubscriber->uuid().toLatin1() + "\r\n";
-                    customAnswer += "SERVER: " + QSysInfo::kernelType().toLatin1() + " " + QSysInfo::kernelVersion().toLatin1() + " UPnP/1.0 test/1.0\r\n";
-                    //customAnswer += "TIMEOUT:Second-" + QByteArray::number(newSubscriber->secondTimeout()) + "\r\n";
-                    customAnswer += "\r\n";
-
-                    return true;
-                }
-            }
+        const auto &currentRoute = d->mRegistry.snapshot()->route(httpHeaders.value("_path"));
+        if (currentRoute.mKind == UpnpRouteKind::Event) {
+            //QPointer<UpnpEventSubscriber> newSubscriber = d->mServer->device(currentRoute.mDeviceId)->serviceByIndex(currentRoute.mServiceIndex)->subscribeToEvents(requestData, httpHeaders);
+
+            customAnswer = "HTTP/1.1 200 OK\r\n";
+            customAnswer += "DATE: " + QDateTime::currentDateTime().toString(QStringLiteral("ddd, d MMM yyyy HH:mm:ss t")).toLatin1() + "\r\n";
+            //customAnswer += "SID: uuid:" + newSubscriber->uuid().toLatin1() + "\r\n";
+            customAnswer += "SERVER: " + QSysInfo::kernelType().toLatin1() + " " + QSysInfo::kernelVersion().toLatin1() + " UPnP/1.0 test/1.0\r\n";
+            //customAnswer += "TIMEOUT:Second-" + QByteArray::number(newSubscriber->secondTimeout()) + "\r\n";
+            customAnswer += "\r\n";
+
+            return true;
         }
     } else if (requestType == "UNSUBSCRIBE") {
-        const QString &path = QString::fromLatin1(httpHeaders.value("_path"));
-        const QList<QString> &pathParts = path.split(QStringLiteral("/"));
-        if (pathParts.count() == 4 && pathParts.last() == QStringLiteral("event")) {
-            const int deviceIndex = pathParts[1].toInt();
-            const int serviceIndex = pathParts[2].toInt();
-            if (deviceIndex >= 0 && deviceIndex < d->mDevices.count()) {
-                UpnpAbstractDevice *currentDevice = d->mDevices[deviceIndex];
-                if (serviceIndex >= 0 && serviceIndex < currentDevice->services().count()) {
-                    //currentDevice->serviceByIndex(serviceIndex)->unsubscribeToEvents(requestData, httpHeaders);
-
-                    customAnswer = "HTTP/1.1 200 OK\r\n";
-                    customAnswer += "DATE: " + QDateTime::currentDateTime().toString(QStringLiteral("ddd, d MMM yyyy HH:mm:ss t")).toLatin1() + "\r\n";
-                    //customAnswer += "SID: uuid:" + newSubscriber->uuid().toLatin1() + "\r\n";
-                    customAnswer += "SERVER: " + QSysInfo::kernelType().toLatin1() + " " + QSysInfo::kernelVersion().toLatin1() + " UPnP/1.0 test/1.0\r\n";
-                    //customAnswer += "TIMEOUT:Second-" + QByteArray::number(newSubscriber->secondTimeout()) + "\r\n";
-                    customAnswer += "\r\n";
-
-                    return true;
-                }
-            }
+        const auto &currentRoute = d->mRegistry.snapshot()->route(httpHeaders.value("_path"));
+        if (currentRoute.mKind == UpnpRouteKind::Event) {
+            //d->mServer->device(currentRoute.mDeviceId)->serviceByIndex(currentRoute.mServiceIndex)->unsubscribeToEvents(requestData, httpHeaders);
+
+            customAnswer = "HTTP/1.1 200 OK\r\n";
+            customAnswer += "DATE: " + QDateTime::currentDateTime().toString(QStringLiteral("ddd, d MMM yyyy HH:mm:ss t")).toLatin1() + "\r\n";
+            //customAnswer += "SID: uuid:" + newSubscriber->uuid().toLatin1() + "\r\n";
+            customAnswer += "SERVER: " + QSysInfo::kernelType().toLatin1() + " " + QSysInfo::kernelVersion().toLatin1() + " UPnP/1.0 test/1.0\r\n";
+            //customAnswer += "TIMEOUT:Second-" + QByteArray::number(newSubscriber->secondTimeout()) + "\r\n";
+            customAnswer += "\r\n";
+
+            return true;
         }
     } else {
         qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpDeviceSoapServerObject::processCustomVerbRequest" << requestData << httpHeaders;
@@ -229,22 +321,4 @@ bool UpnpDeviceSoapServerObject::processCustomVerbRequest(const QByteArray &requ
     return false;
 }
 
-std::unique_ptr<QIODevice> UpnpDeviceSoapServerObject::downloadDeviceXmlDescription(UpnpAbstractDevice *device, QByteArray &contentType)
-{
-    qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpDeviceSoapServerObject::downloadDeviceXmlDescription" << device->description().UDN();
-
-    contentType = "text/xml";
-
-    return device->buildAndGetXmlDescription();
-}
-
-std::unique_ptr<QIODevice> UpnpDeviceSoapServerObject::downloadServiceXmlDescription(UpnpAbstractDevice *device, const int serviceIndex, QByteArray &contentType)
-{
-    qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpDeviceSoapServerObject::downloadServiceXmlDescription" << device->description().UDN() << serviceIndex;
-
-    contentType = "text/xml";
-
-    return {}/*device->serviceByIndex(serviceIndex)->buildAndGetXmlDescription()*/;
-}
-
 #include "moc_upnpdevicesoapserverobject.cpp"
@@ -17,8 +17,10 @@
 
 #include <memory>
 
-class UpnpAbstractDevice;
+class UpnpDeviceRegistry;
+class UpnpDeviceSoapServer;
 class UpnpDeviceSoapServerObjectPrivate;
+class UpnpRoute;
 
 /**
  * @brief The UpnpDeviceSoapServerObject class is needed to handle incoming request made to an UPnP device or service
@@ -30,7 +32,11 @@ class UpnpDeviceSoapServerObject : public QObject, public KDSoapServerObjectInte
     Q_INTERFACES(KDSoapServerObjectInterface KDSoapServerCustomVerbRequestInterface)
 
 public:
-    explicit UpnpDeviceSoapServerObject(QList<UpnpAbstractDevice *> &devices, QObject *parent = nullptr);
+    /**
+     * @param server owns the devices, they are only looked up in its thread
+     * @param registry publishes the route table of the server, it is used to find the device and service of each request
+     */
+    UpnpDeviceSoapServerObject(const UpnpDeviceSoapServer *server, UpnpDeviceRegistry &registry, QObject *parent = nullptr);
 
     ~UpnpDeviceSoapServerObject() override;
 
@@ -52,9 +58,10 @@ public:
         const QMap<QByteArray, QByteArray> &httpHeaders, QByteArray &customAnswer) override;
 
 private:
-    std::unique_ptr<QIODevice> downloadDeviceXmlDescription(UpnpAbstractDevice *device, QByteArray &contentType);
-
-    std::unique_ptr<QIODevice> downloadServiceXmlDescription(UpnpAbstractDevice *device, const int serviceIndex, QByteArray &contentType);
+    /**
+     * @brief serveAction will run the action of a control request, it must be called in the thread of the server
+     */
+    void serveAction(const UpnpRoute &route, const KDSoapMessage &request, KDSoapMessage &response, const QByteArray &soapAction);
 
     std::unique_ptr<UpnpDeviceSoapServerObjectPrivate> d;
 };
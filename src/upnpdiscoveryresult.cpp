@@ -54,6 +54,11 @@ public:
      * @brief mCacheDuration duration of validity of the announce in seconds
      */
     int mCacheDuration = 1800;
+
+    /**
+     * @brief mConfigId contains the header CONFIGID.UPNP.ORG sent in an ssdp message or -1 if it was absent
+     */
+    int mConfigId = -1;
 };
 
 UpnpDiscoveryResult::UpnpDiscoveryResult()
@@ -192,6 +197,16 @@ QDateTime UpnpDiscoveryResult::validityTimestamp() const
     return d->mValidityTimestamp;
 }
 
+void UpnpDiscoveryResult::setConfigId(int value)
+{
+    d->mConfigId = value;
+}
+
+int UpnpDiscoveryResult::configId() const
+{
+    return d->mConfigId;
+}
+
 UPNPLIBQT_EXPORT QDebug operator<<(QDebug stream, const UpnpDiscoveryResult &data)
 {
     stream << data.location() << "usn" << data.usn() << "nt" << data.nt() << "nts" << data.nts() << "announce date" << data.announceDate() << "cache" << data.cacheDuration() << "valid until" << data.validityTimestamp();
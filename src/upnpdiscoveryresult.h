@@ -71,6 +71,17 @@ public:
 
     [[nodiscard]] QDateTime validityTimestamp() const;
 
+    /**
+     * @brief setConfigId will set the value of the CONFIGID.UPNP.ORG header
+     *
+     * The configuration number changes each time the device or service descriptions of the device change.
+     *
+     * @param value is the configuration number or -1 if the device did not send one
+     */
+    void setConfigId(int value);
+
+    [[nodiscard]] int configId() const;
+
 private:
     std::unique_ptr<UpnpDiscoveryResultPrivate> d;
 };
@@ -0,0 +1,88 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpeventpropertysetparser.h"
+
+bool UpnpEventPropertySetParser::parse(const QByteArray &content, const PropertyHandler &handler)
+{
+    mReader.clear();
+    mReader.addData(content);
+    mErrorString.clear();
+
+    if (!mReader.readNextStartElement() || mReader.name() != QLatin1String("propertyset")) {
+        mErrorString = mReader.hasError() ? mReader.errorString() : QStringLiteral("event notification is not a propertyset");
+        return false;
+    }
+
+    while (mReader.readNextStartElement()) {
+        if (mReader.name() != QLatin1String("property")) {
+            mReader.skipCurrentElement();
+            continue;
+        }
+
+        if (!readProperty(handler)) {
+            break;
+        }
+    }
+
+    if (mReader.hasError()) {
+        mErrorString = mReader.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+QString UpnpEventPropertySetParser::errorString() const
+{
+    return mErrorString;
+}
+
+bool UpnpEventPropertySetParser::readProperty(const PropertyHandler &handler)
+{
+    while (mReader.readNextStartElement()) {
+        // the views given by the reader are invalidated by the next token, resize keeps the allocated capacity
+        mVariableName.resize(0);
+        mVariableName.append(mReader.name());
+
+        if (!readVariableValue()) {
+            return false;
+        }
+
+        handler(mVariableName, mVariableValue);
+    }
+
+    return !mReader.hasError();
+}
+
+bool UpnpEventPropertySetParser::readVariableValue()
+{
+    mVariableValue.resize(0);
+
+    // the text of nested elements is kept like QDomElement::text does for devices sending unescaped XML values
+    int depth = 0;
+    while (!mReader.atEnd()) {
+        switch (mReader.readNext()) {
+        case QXmlStreamReader::Characters:
+        case QXmlStreamReader::EntityReference:
+            mVariableValue.append(mReader.text());
+            break;
+        case QXmlStreamReader::StartElement:
+            ++depth;
+            break;
+        case QXmlStreamReader::EndElement:
+            if (depth == 0) {
+                return true;
+            }
+            --depth;
+            break;
+        default:
+            break;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,60 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef UPNPEVENTPROPERTYSETPARSER_H
+#define UPNPEVENTPROPERTYSETPARSER_H
+
+#include "upnplibqt_export.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QStringView>
+#include <QXmlStreamReader>
+
+#include <functional>
+
+/**
+ * @brief The UpnpEventPropertySetParser class parses the body of GENA event notifications
+ *
+ * The propertyset is read with a streaming reader: no DOM is built and the text is decoded with the encoding
+ * declared by the document (UTF-8 by default). One parser can be used for many notifications, its buffers are
+ * reused.
+ */
+class UPNPLIBQT_EXPORT UpnpEventPropertySetParser
+{
+public:
+    /**
+     * @brief PropertyHandler is called for each state variable of the propertyset
+     *
+     * The views are only valid during the call.
+     */
+    using PropertyHandler = std::function<void(QStringView variableName, QStringView variableValue)>;
+
+    /**
+     * @brief parse reads every property of a propertyset in document order and gives each state variable to handler
+     *
+     * @return false if the document is not a well formed propertyset, the properties read before the error have
+     * already been given to handler
+     */
+    [[nodiscard]] bool parse(const QByteArray &content, const PropertyHandler &handler);
+
+    [[nodiscard]] QString errorString() const;
+
+private:
+    [[nodiscard]] bool readProperty(const PropertyHandler &handler);
+
+    [[nodiscard]] bool readVariableValue();
+
+    QXmlStreamReader mReader;
+
+    QString mVariableName;
+
+    QString mVariableValue;
+
+    QString mErrorString;
+};
+
+#endif // UPNPEVENTPROPERTYSETPARSER_H
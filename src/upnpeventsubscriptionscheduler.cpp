@@ -0,0 +1,269 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpeventsubscriptionscheduler.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QRandomGenerator>
+#include <QTimer>
+
+#include <array>
+#include <limits>
+#include <utility>
+
+class UpnpScheduledRenewal
+{
+public:
+    QPointer<QObject> mReceiver;
+
+    std::function<void()> mCallback;
+
+    /**
+     * @brief mDueTick is the tick of the wheel when the renewal is due, it can be more than one turn ahead
+     */
+    qint64 mDueTick = 0;
+};
+
+class UpnpEventSubscriptionSchedulerPrivate
+{
+public:
+    static constexpr qint64 TickDuration = 1000;
+
+    static constexpr int WheelSize = 256;
+
+    QHash<quint64, UpnpScheduledRenewal> mRenewals;
+
+    /**
+     * @brief mWheel are the identifiers of the renewals indexed by their due tick modulo WheelSize
+     *
+     * Cancelled renewals are only removed from mRenewals, their identifiers are dropped when their slot is visited.
+     */
+    std::array<QList<quint64>, WheelSize> mWheel;
+
+    QTimer mTimer;
+
+    QElapsedTimer mClock;
+
+    /**
+     * @brief mCurrentTick is the last tick whose slot has been visited
+     */
+    qint64 mCurrentTick = 0;
+
+    /**
+     * @brief mNextDueTick is the tick for which mTimer is armed
+     */
+    qint64 mNextDueTick = 0;
+
+    quint64 mNextRenewalId = 1;
+
+    int mRenewalMargin = 60;
+
+    int mJitter = 10;
+
+    void stopWhenEmpty()
+    {
+        if (!mRenewals.isEmpty()) {
+            return;
+        }
+
+        mTimer.stop();
+
+        for (auto &oneSlot : mWheel) {
+            oneSlot.clear();
+        }
+    }
+
+    void armTimer(qint64 dueTick)
+    {
+        mNextDueTick = dueTick;
+
+        const auto delay = qMax<qint64>(0, dueTick * TickDuration - mClock.elapsed());
+        mTimer.start(static_cast<int>(qMin<qint64>(delay, std::numeric_limits<int>::max())));
+    }
+
+    /**
+     * @brief armTimerForNextRenewal walks the slots of the next turn of the wheel to find the next due renewal
+     *
+     * The first slot holding a renewal due at its tick gives the next due renewal. When no renewal is due in the next
+     * turn, the timer wakes up at the end of the turn to walk the following one.
+     */
+    void armTimerForNextRenewal()
+    {
+        stopWhenEmpty();
+        if (mRenewals.isEmpty()) {
+            return;
+        }
+
+        for (auto tick = mCurrentTick + 1; tick <= mCurrentTick + WheelSize; ++tick) {
+            auto &oneSlot = mWheel[tick % WheelSize];
+
+            for (auto itId = oneSlot.begin(); itId != oneSlot.end();) {
+                const auto itRenewal = mRenewals.constFind(*itId);
+                if (itRenewal == mRenewals.constEnd()) {
+                    itId = oneSlot.erase(itId);
+                    continue;
+                }
+
+                if (itRenewal->mDueTick <= tick) {
+                    armTimer(tick);
+                    return;
+                }
+
+                ++itId;
+            }
+        }
+
+        armTimer(mCurrentTick + WheelSize);
+    }
+};
+
+UpnpEventSubscriptionScheduler::UpnpEventSubscriptionScheduler(QObject *parent)
+    : QObject(parent)
+    , d(std::make_unique<UpnpEventSubscriptionSchedulerPrivate>())
+{
+    d->mTimer.setSingleShot(true);
+    d->mClock.start();
+
+    connect(&d->mTimer, &QTimer::timeout, this, &UpnpEventSubscriptionScheduler::advanceWheel);
+}
+
+UpnpEventSubscriptionScheduler::~UpnpEventSubscriptionScheduler() = default;
+
+UpnpEventSubscriptionScheduler *UpnpEventSubscriptionScheduler::instance()
+{
+    static QPointer<UpnpEventSubscriptionScheduler> sharedScheduler;
+
+    if (!sharedScheduler) {
+        sharedScheduler = new UpnpEventSubscriptionScheduler(QCoreApplication::instance());
+    }
+
+    return sharedScheduler;
+}
+
+int UpnpEventSubscriptionScheduler::renewalMargin() const
+{
+    return d->mRenewalMargin;
+}
+
+int UpnpEventSubscriptionScheduler::jitter() const
+{
+    return d->mJitter;
+}
+
+qint64 UpnpEventSubscriptionScheduler::renewalDelay(int subscriptionTimeout) const
+{
+    const auto margin = qMin(d->mRenewalMargin, subscriptionTimeout / 2);
+    const auto delay = 1000 * static_cast<qint64>(qMax(subscriptionTimeout - margin, 1));
+
+    if (d->mJitter == 0) {
+        return delay;
+    }
+
+    return delay - QRandomGenerator::global()->bounded(delay * d->mJitter / 100 + 1);
+}
+
+quint64 UpnpEventSubscriptionScheduler::scheduleRenewal(int subscriptionTimeout, QObject *receiver, std::function<void()> callback)
+{
+    return schedule(renewalDelay(subscriptionTimeout), receiver, std::move(callback));
+}
+
+quint64 UpnpEventSubscriptionScheduler::schedule(qint64 delay, QObject *receiver, std::function<void()> callback)
+{
+    if (d->mRenewals.isEmpty()) {
+        // the wheel did not move while it was empty
+        d->mCurrentTick = d->mClock.elapsed() / UpnpEventSubscriptionSchedulerPrivate::TickDuration;
+    }
+
+    const auto renewalId = d->mNextRenewalId++;
+    const auto dueTick = d->mCurrentTick
+        + qMax<qint64>(1, (delay + UpnpEventSubscriptionSchedulerPrivate::TickDuration - 1) / UpnpEventSubscriptionSchedulerPrivate::TickDuration);
+
+    d->mRenewals[renewalId] = {receiver, std::move(callback), dueTick};
+    d->mWheel[dueTick % UpnpEventSubscriptionSchedulerPrivate::WheelSize].push_back(renewalId);
+
+    // the timer only wakes up for the next renewal, a cancelled one only gives a spurious wake up
+    if (!d->mTimer.isActive() || dueTick < d->mNextDueTick) {
+        d->armTimer(dueTick);
+    }
+
+    return renewalId;
+}
+
+void UpnpEventSubscriptionScheduler::cancel(quint64 renewalId)
+{
+    d->mRenewals.remove(renewalId);
+    d->stopWhenEmpty();
+}
+
+int UpnpEventSubscriptionScheduler::scheduledRenewals() const
+{
+    return d->mRenewals.size();
+}
+
+void UpnpEventSubscriptionScheduler::setRenewalMargin(int value)
+{
+    if (d->mRenewalMargin == value || value < 0) {
+        return;
+    }
+
+    d->mRenewalMargin = value;
+    Q_EMIT renewalMarginChanged();
+}
+
+void UpnpEventSubscriptionScheduler::setJitter(int value)
+{
+    if (d->mJitter == value || value < 0 || value > 100) {
+        return;
+    }
+
+    d->mJitter = value;
+    Q_EMIT jitterChanged();
+}
+
+void UpnpEventSubscriptionScheduler::advanceWheel()
+{
+    // catch up with the ticks missed while the event loop was busy
+    const auto targetTick = d->mClock.elapsed() / UpnpEventSubscriptionSchedulerPrivate::TickDuration;
+
+    // each slot is visited at most once, at its last tick not after targetTick, when all its due renewals are found
+    d->mCurrentTick = qMax(d->mCurrentTick, targetTick - UpnpEventSubscriptionSchedulerPrivate::WheelSize);
+
+    QList<quint64> dueRenewals;
+
+    while (d->mCurrentTick < targetTick) {
+        ++d->mCurrentTick;
+
+        auto &currentSlot = d->mWheel[d->mCurrentTick % UpnpEventSubscriptionSchedulerPrivate::WheelSize];
+
+        for (auto itId = currentSlot.begin(); itId != currentSlot.end();) {
+            const auto itRenewal = d->mRenewals.constFind(*itId);
+            if (itRenewal == d->mRenewals.constEnd()) {
+                itId = currentSlot.erase(itId);
+            } else if (itRenewal->mDueTick <= d->mCurrentTick) {
+                dueRenewals.push_back(*itId);
+                itId = currentSlot.erase(itId);
+            } else {
+                ++itId;
+            }
+        }
+    }
+
+    // a callback can cancel a renewal that is also due, it is only taken just before being called
+    for (const auto renewalId : std::as_const(dueRenewals)) {
+        const auto oneRenewal = d->mRenewals.take(renewalId);
+        if (oneRenewal.mReceiver) {
+            oneRenewal.mCallback();
+        }
+    }
+
+    d->armTimerForNextRenewal();
+}
+
+#include "moc_upnpeventsubscriptionscheduler.cpp"
@@ -0,0 +1,114 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef UPNPEVENTSUBSCRIPTIONSCHEDULER_H
+#define UPNPEVENTSUBSCRIPTIONSCHEDULER_H
+
+#include "upnplibqt_export.h"
+
+#include <QObject>
+
+#include <functional>
+#include <memory>
+
+class UpnpEventSubscriptionSchedulerPrivate;
+
+/**
+ * @brief The UpnpEventSubscriptionScheduler class schedules the renewals of the event subscriptions of all services
+ *
+ * One scheduler is shared by all instances of \class UpnpControlAbstractService of the process (see instance).
+ * Instead of one timer per subscription, the renewals are stored in a timing wheel with a resolution of one second
+ * driven by a single timer that is armed for the next due renewal.
+ *
+ * Each renewal is scheduled before the end of the subscription minus renewalMargin. A random part of the delay
+ * (see jitter) is removed so that subscriptions made at the same time are not renewed in the same second forever.
+ */
+class UPNPLIBQT_EXPORT UpnpEventSubscriptionScheduler : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int renewalMargin
+            READ renewalMargin
+                WRITE setRenewalMargin
+                    NOTIFY renewalMarginChanged)
+
+    Q_PROPERTY(int jitter
+            READ jitter
+                WRITE setJitter
+                    NOTIFY jitterChanged)
+
+public:
+    explicit UpnpEventSubscriptionScheduler(QObject *parent = nullptr);
+
+    ~UpnpEventSubscriptionScheduler() override;
+
+    /**
+     * @brief instance returns the scheduler shared by all services of the process
+     *
+     * It is created on first use as a child of the application object.
+     */
+    [[nodiscard]] static UpnpEventSubscriptionScheduler *instance();
+
+    /**
+     * @brief renewalMargin is the time in seconds left before the end of a subscription when it is renewed
+     *
+     * It is reduced to half of the subscription duration for short subscriptions.
+     */
+    [[nodiscard]] int renewalMargin() const;
+
+    /**
+     * @brief jitter is the maximum percentage of the renewal delay that is randomly removed
+     */
+    [[nodiscard]] int jitter() const;
+
+    /**
+     * @brief renewalDelay returns a delay in milliseconds, including jitter, to renew a subscription
+     *
+     * @param subscriptionTimeout is the duration of the subscription in seconds given by the TIMEOUT header
+     */
+    [[nodiscard]] qint64 renewalDelay(int subscriptionTimeout) const;
+
+    /**
+     * @brief scheduleRenewal will call callback when a subscription of subscriptionTimeout seconds should be renewed
+     *
+     * @return an identifier that can be given to cancel
+     */
+    quint64 scheduleRenewal(int subscriptionTimeout, QObject *receiver, std::function<void()> callback);
+
+    /**
+     * @brief schedule will call callback after delay milliseconds, rounded up to the resolution of the scheduler
+     *
+     * callback is not called if receiver has been destroyed or if it has been cancelled.
+     *
+     * @return an identifier that can be given to cancel
+     */
+    quint64 schedule(qint64 delay, QObject *receiver, std::function<void()> callback);
+
+    void cancel(quint64 renewalId);
+
+    [[nodiscard]] int scheduledRenewals() const;
+
+Q_SIGNALS:
+
+    void renewalMarginChanged();
+
+    void jitterChanged();
+
+public Q_SLOTS:
+
+    void setRenewalMargin(int value);
+
+    void setJitter(int value);
+
+private Q_SLOTS:
+
+    void advanceWheel();
+
+private:
+    std::unique_ptr<UpnpEventSubscriptionSchedulerPrivate> d;
+};
+
+#endif // UPNPEVENTSUBSCRIPTIONSCHEDULER_H
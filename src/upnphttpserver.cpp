@@ -8,31 +8,125 @@
 #include "upnpcontrolabstractservice.h"
 #include "upnpservereventobject.h"
 
+#include <QCoreApplication>
+#include <QHash>
+#include <QHostAddress>
+#include <QNetworkInterface>
+#include <QPointer>
+
 class UpnpHttpServerPrivate
 {
 public:
-    UpnpControlAbstractService *mService;
+    QHash<QString, QPointer<UpnpControlAbstractService>> mServicesByPath;
+
+    QHash<QString, QString> mPathsBySubscriptionId;
+
+    QHash<QString, QString> mSubscriptionIdsByPath;
+
+    QHostAddress mPublicAddress;
+
+    quint64 mNextServiceId = 1;
 };
 
 UpnpHttpServer::UpnpHttpServer(QObject *parent)
     : KDSoapServer(parent)
     , d(std::make_unique<UpnpHttpServerPrivate>())
 {
-    d->mService = nullptr;
+    const QList<QHostAddress> &list = QNetworkInterface::allAddresses();
+    for (const auto &address : list) {
+        if (!address.isLoopback()) {
+            if (address.protocol() == QAbstractSocket::IPv4Protocol) {
+                d->mPublicAddress = address;
+                break;
+            }
+        }
+    }
 }
 
 UpnpHttpServer::~UpnpHttpServer() = default;
 
+UpnpHttpServer *UpnpHttpServer::eventServer()
+{
+    static QPointer<UpnpHttpServer> sharedServer;
+
+    if (!sharedServer) {
+        sharedServer = new UpnpHttpServer(QCoreApplication::instance());
+    }
+
+    return sharedServer;
+}
+
 QObject *UpnpHttpServer::createServerObject()
 {
     auto newObject = std::make_unique<UpnpServerEventObject>();
-    newObject->setService(d->mService);
+    newObject->setServer(this);
     return newObject.release();
 }
 
-void UpnpHttpServer::setService(UpnpControlAbstractService *service)
+QString UpnpHttpServer::registerService(UpnpControlAbstractService *service)
+{
+    if (!isListening()) {
+        listen(QHostAddress::Any);
+    }
+
+    const QString callbackPath = QStringLiteral("/event/") + QString::number(d->mNextServiceId++);
+
+    d->mServicesByPath[callbackPath] = service;
+
+    return callbackPath;
+}
+
+void UpnpHttpServer::unregisterService(const QString &callbackPath)
+{
+    d->mServicesByPath.remove(callbackPath);
+
+    const auto subscriptionId = d->mSubscriptionIdsByPath.take(callbackPath);
+    if (!subscriptionId.isEmpty()) {
+        d->mPathsBySubscriptionId.remove(subscriptionId);
+    }
+}
+
+void UpnpHttpServer::setSubscriptionId(const QString &callbackPath, const QString &subscriptionId)
+{
+    if (!d->mServicesByPath.contains(callbackPath)) {
+        return;
+    }
+
+    const auto oldSubscriptionId = d->mSubscriptionIdsByPath.value(callbackPath);
+    if (!oldSubscriptionId.isEmpty()) {
+        d->mPathsBySubscriptionId.remove(oldSubscriptionId);
+    }
+
+    d->mSubscriptionIdsByPath[callbackPath] = subscriptionId;
+    d->mPathsBySubscriptionId[subscriptionId] = callbackPath;
+}
+
+QString UpnpHttpServer::callbackUrl(const QString &callbackPath) const
+{
+    QString result(QStringLiteral("http://"));
+
+    if (!d->mPublicAddress.isNull()) {
+        result += d->mPublicAddress.toString();
+    } else {
+        result += QStringLiteral("127.0.0.1");
+    }
+
+    result += QStringLiteral(":") + QString::number(serverPort()) + callbackPath;
+
+    return result;
+}
+
+UpnpControlAbstractService *UpnpHttpServer::service(const QString &subscriptionId, const QString &callbackPath) const
+{
+    auto itPath = d->mPathsBySubscriptionId.constFind(subscriptionId);
+    const auto &servicePath = (itPath != d->mPathsBySubscriptionId.constEnd() ? *itPath : callbackPath);
+
+    return d->mServicesByPath.value(servicePath);
+}
+
+int UpnpHttpServer::registeredServicesCount() const
 {
-    d->mService = service;
+    return d->mServicesByPath.size();
 }
 
 #include "moc_upnphttpserver.cpp"
@@ -12,13 +12,21 @@
 #include <KDSoapServer/KDSoapServer.h>
 
 #include <QObject>
+#include <QString>
 
 #include <memory>
 
 class UpnpControlAbstractService;
 class UpnpHttpServerPrivate;
 
-class UpnpHttpServer : public KDSoapServer
+/**
+ * @brief The UpnpHttpServer class receives the event notifications (GENA NOTIFY requests) of all controlled services
+ *
+ * One server is shared by all instances of \class UpnpControlAbstractService of the process (see eventServer). Each
+ * service registers itself and gets its own callback path. Notifications are routed to the service by their SID
+ * header or, before the SID of a subscription is known, by the path of the request.
+ */
+class UPNPLIBQT_EXPORT UpnpHttpServer : public KDSoapServer
 {
     Q_OBJECT
 public:
@@ -26,9 +34,46 @@ public:
 
     ~UpnpHttpServer() override;
 
+    /**
+     * @brief eventServer returns the server shared by all services of the process
+     *
+     * It is created on first use as a child of the application object.
+     */
+    [[nodiscard]] static UpnpHttpServer *eventServer();
+
     QObject *createServerObject() override;
 
-    void setService(UpnpControlAbstractService *service);
+    /**
+     * @brief registerService will route the notifications sent to a new callback path to service
+     *
+     * The server starts listening on the first registration.
+     *
+     * @return the callback path to use in the CALLBACK header of the subscription
+     */
+    [[nodiscard]] QString registerService(UpnpControlAbstractService *service);
+
+    void unregisterService(const QString &callbackPath);
+
+    /**
+     * @brief setSubscriptionId will route the notifications with subscriptionId to the service registered with callbackPath
+     */
+    void setSubscriptionId(const QString &callbackPath, const QString &subscriptionId);
+
+    /**
+     * @brief callbackUrl returns the full url to use in the CALLBACK header of a subscription
+     */
+    [[nodiscard]] QString callbackUrl(const QString &callbackPath) const;
+
+    /**
+     * @brief service returns the service that should receive a notification
+     *
+     * @param subscriptionId is the value of the SID header of the notification
+     * @param callbackPath is the path of the notification request
+     * @return the service or nullptr if no registered service matches
+     */
+    [[nodiscard]] UpnpControlAbstractService *service(const QString &subscriptionId, const QString &callbackPath) const;
+
+    [[nodiscard]] int registeredServicesCount() const;
 
 private:
     std::unique_ptr<UpnpHttpServerPrivate> d;
@@ -0,0 +1,112 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnplastchangedecoder.h"
+
+bool UpnpLastChangeDecoder::decode(const QString &lastChange, const ChangeHandler &handler)
+{
+    mReader.clear();
+    mReader.addData(lastChange);
+    mErrorString.clear();
+
+    if (!mReader.readNextStartElement() || mReader.name() != QLatin1String("Event")) {
+        mErrorString = mReader.hasError() ? mReader.errorString() : QStringLiteral("LastChange value is not an Event");
+        return false;
+    }
+
+    while (mReader.readNextStartElement()) {
+        if (mReader.name() != QLatin1String("InstanceID")) {
+            mReader.skipCurrentElement();
+            continue;
+        }
+
+        if (!readInstance(handler)) {
+            break;
+        }
+    }
+
+    if (mReader.hasError()) {
+        mErrorString = mReader.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+QString UpnpLastChangeDecoder::value(quint32 instanceId, const QString &variableName, const QString &channel) const
+{
+    const auto itInstance = mInstances.constFind(instanceId);
+    if (itInstance == mInstances.constEnd()) {
+        return {};
+    }
+
+    if (channel.isEmpty()) {
+        return itInstance->value(variableName);
+    }
+
+    return itInstance->value(variableName + QLatin1Char('/') + channel);
+}
+
+QList<quint32> UpnpLastChangeDecoder::instanceIds() const
+{
+    return mInstances.keys();
+}
+
+QString UpnpLastChangeDecoder::errorString() const
+{
+    return mErrorString;
+}
+
+void UpnpLastChangeDecoder::clear()
+{
+    mInstances.clear();
+}
+
+bool UpnpLastChangeDecoder::readInstance(const ChangeHandler &handler)
+{
+    bool isValidId = false;
+    const auto instanceId = mReader.attributes().value(QLatin1String("val")).toUInt(&isValidId);
+    if (!isValidId) {
+        mReader.skipCurrentElement();
+        return !mReader.hasError();
+    }
+
+    auto &instanceValues = mInstances[instanceId];
+
+    while (mReader.readNextStartElement()) {
+        // the views on the attributes are valid as long as this copy is alive
+        const auto attributes = mReader.attributes();
+        const auto variableName = mReader.name();
+        const auto channel = attributes.value(QLatin1String("channel"));
+        const auto newValue = attributes.value(QLatin1String("val"));
+
+        updateVariableKey(variableName, channel);
+
+        auto itValue = instanceValues.find(mVariableKey);
+        if (itValue == instanceValues.end()) {
+            instanceValues.insert(mVariableKey, newValue.toString());
+            handler(instanceId, variableName, channel, newValue);
+        } else if (*itValue != newValue) {
+            *itValue = newValue.toString();
+            handler(instanceId, variableName, channel, newValue);
+        }
+
+        mReader.skipCurrentElement();
+    }
+
+    return !mReader.hasError();
+}
+
+void UpnpLastChangeDecoder::updateVariableKey(QStringView variableName, QStringView channel)
+{
+    // resize keeps the allocated capacity when the key is not shared with a stored one
+    mVariableKey.resize(0);
+    mVariableKey.append(variableName);
+    if (!channel.isEmpty()) {
+        mVariableKey.append(QLatin1Char('/'));
+        mVariableKey.append(channel);
+    }
+}
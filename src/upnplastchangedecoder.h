@@ -0,0 +1,79 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef UPNPLASTCHANGEDECODER_H
+#define UPNPLASTCHANGEDECODER_H
+
+#include "upnplibqt_export.h"
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringView>
+#include <QXmlStreamReader>
+
+#include <functional>
+
+/**
+ * @brief The UpnpLastChangeDecoder class decodes the LastChange state variable of AV services
+ *
+ * AVTransport and RenderingControl send their state as an XML document in the value of LastChange:
+ * an Event element with one InstanceID element per virtual instance, each containing one element per state
+ * variable with the value in its val attribute (and a channel attribute for RenderingControl).
+ *
+ * The decoder reads this document with a streaming reader and remembers the values of each instance, so that only
+ * the variables with a new value are reported.
+ */
+class UPNPLIBQT_EXPORT UpnpLastChangeDecoder
+{
+public:
+    /**
+     * @brief ChangeHandler is called for each variable with a new value, the views are only valid during the call
+     *
+     * channel is empty for variables without channel attribute.
+     */
+    using ChangeHandler = std::function<void(quint32 instanceId, QStringView variableName, QStringView channel, QStringView value)>;
+
+    /**
+     * @brief decode reads one LastChange document and reports the variables whose value changed since the previous one
+     *
+     * @return false if the document is not a well formed LastChange event, the changes read before the error have
+     * already been reported
+     */
+    [[nodiscard]] bool decode(const QString &lastChange, const ChangeHandler &handler);
+
+    /**
+     * @brief value returns the last known value of a variable of an instance or a null string if it is unknown
+     */
+    [[nodiscard]] QString value(quint32 instanceId, const QString &variableName, const QString &channel = {}) const;
+
+    [[nodiscard]] QList<quint32> instanceIds() const;
+
+    [[nodiscard]] QString errorString() const;
+
+    /**
+     * @brief clear forgets all known values, the next decoded document reports all its variables
+     */
+    void clear();
+
+private:
+    [[nodiscard]] bool readInstance(const ChangeHandler &handler);
+
+    void updateVariableKey(QStringView variableName, QStringView channel);
+
+    QXmlStreamReader mReader;
+
+    /**
+     * @brief mInstances are the known values indexed by InstanceID then by variable name and channel
+     */
+    QHash<quint32, QHash<QString, QString>> mInstances;
+
+    QString mVariableKey;
+
+    QString mErrorString;
+};
+
+#endif // UPNPLASTCHANGEDECODER_H
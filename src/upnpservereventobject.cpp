@@ -7,13 +7,14 @@
 #include "upnpservereventobject.h"
 
 #include "upnpcontrolabstractservice.h"
+#include "upnphttpserver.h"
 
 #include <QDebug>
 
 class UpnpServerEventObjectPrivate
 {
 public:
-    UpnpControlAbstractService *mService;
+    UpnpHttpServer *mServer;
 };
 
 UpnpServerEventObject::UpnpServerEventObject(QObject *parent)
@@ -21,7 +22,7 @@ UpnpServerEventObject::UpnpServerEventObject(QObject *parent)
     , KDSoapServerCustomVerbRequestInterface()
     , d(std::make_unique<UpnpServerEventObjectPrivate>())
 {
-    d->mService = nullptr;
+    d->mServer = nullptr;
 }
 
 UpnpServerEventObject::~UpnpServerEventObject() = default;
@@ -31,20 +32,27 @@ bool UpnpServerEventObject::processCustomVerbRequest(const QByteArray &requestTy
 {
     Q_UNUSED(requestType)
 
-    if (!d->mService) {
+    if (!d->mServer) {
         return false;
     }
 
-    d->mService->handleEventNotification(requestData, httpHeaders);
+    auto *service = d->mServer->service(QString::fromLatin1(httpHeaders.value("sid")), QString::fromLatin1(httpHeaders.value("_path")));
+    if (!service) {
+        customAnswer = "HTTP/1.1 412 Precondition Failed\r\nContent-Length: 0\r\n\r\n";
+
+        return true;
+    }
+
+    service->handleEventNotification(requestData, httpHeaders);
 
     customAnswer = "HTTP/1.1 200 OK\r\nContent-Length: 0\r\nContent-Type: text/html\r\n\r\n";
 
     return true;
 }
 
-void UpnpServerEventObject::setService(UpnpControlAbstractService *service)
+void UpnpServerEventObject::setServer(UpnpHttpServer *server)
 {
-    d->mService = service;
+    d->mServer = server;
 }
 
 #include "moc_upnpservereventobject.cpp"
@@ -16,7 +16,7 @@
 
 #include <memory>
 
-class UpnpControlAbstractService;
+class UpnpHttpServer;
 class UpnpServerEventObjectPrivate;
 
 class UpnpServerEventObject : public QObject, public KDSoapServerCustomVerbRequestInterface
@@ -41,7 +41,7 @@ public:
     bool processCustomVerbRequest(const QByteArray &requestType, const QByteArray &requestData,
         const QMap<QByteArray, QByteArray> &httpHeaders, QByteArray &customAnswer) override;
 
-    void setService(UpnpControlAbstractService *service);
+    void setServer(UpnpHttpServer *server);
 
 private:
     std::unique_ptr<UpnpServerEventObjectPrivate> d;
@@ -10,6 +10,7 @@
 #include "upnpstatevariabledescription.h"
 
 #include <QBuffer>
+#include <QDataStream>
 #include <QIODevice>
 #include <QMetaObject>
 #include <QMetaProperty>
@@ -43,6 +44,10 @@ public:
     QVector<QPointer<UpnpEventSubscriber>> mSubscribers;
 
     int mMaximumSubscriptionDuration = 3600;
+
+    QByteArray mSCPDHash;
+
+    bool mSCPDLoaded = false;
 };
 
 UpnpServiceDescription::UpnpServiceDescription()
@@ -122,6 +127,26 @@ const QUrl &UpnpServiceDescription::SCPDURL() const
     return d->mSCPDURL;
 }
 
+void UpnpServiceDescription::setSCPDLoaded(bool value)
+{
+    d->mSCPDLoaded = value;
+}
+
+bool UpnpServiceDescription::isSCPDLoaded() const
+{
+    return d->mSCPDLoaded;
+}
+
+void UpnpServiceDescription::setSCPDHash(const QByteArray &hash)
+{
+    d->mSCPDHash = hash;
+}
+
+const QByteArray &UpnpServiceDescription::SCPDHash() const
+{
+    return d->mSCPDHash;
+}
+
 void UpnpServiceDescription::setControlURL(const QUrl &newControlURL)
 {
     d->mControlURL = newControlURL;
@@ -191,3 +216,41 @@ const QMap<QString, UpnpStateVariableDescription> &UpnpServiceDescription::state
 {
     return d->mStateVariables;
 }
+
+QDataStream &operator<<(QDataStream &stream, const UpnpServiceDescription &data)
+{
+    stream << data.baseURL() << data.serviceType() << data.serviceId() << data.SCPDURL() << data.controlURL() << data.eventURL()
+           << static_cast<qint32>(data.maximumSubscriptionDuration()) << data.isSCPDLoaded() << data.SCPDHash()
+           << data.actions() << data.stateVariables();
+
+    return stream;
+}
+
+QDataStream &operator>>(QDataStream &stream, UpnpServiceDescription &data)
+{
+    QString baseURL;
+    QString serviceType;
+    QString serviceId;
+    QUrl SCPDURL;
+    QUrl controlURL;
+    QUrl eventURL;
+    qint32 maximumSubscriptionDuration = 0;
+    bool SCPDLoaded = false;
+    QByteArray SCPDHash;
+
+    stream >> baseURL >> serviceType >> serviceId >> SCPDURL >> controlURL >> eventURL
+        >> maximumSubscriptionDuration >> SCPDLoaded >> SCPDHash
+        >> data.actions() >> data.stateVariables();
+
+    data.setBaseURL(baseURL);
+    data.setServiceType(serviceType);
+    data.setServiceId(serviceId);
+    data.setSCPDURL(SCPDURL);
+    data.setControlURL(controlURL);
+    data.setEventURL(eventURL);
+    data.setMaximumSubscriptionDuration(maximumSubscriptionDuration);
+    data.setSCPDLoaded(SCPDLoaded);
+    data.setSCPDHash(SCPDHash);
+
+    return stream;
+}
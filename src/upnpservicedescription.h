@@ -9,6 +9,7 @@
 
 #include "upnplibqt_export.h"
 
+#include <QByteArray>
 #include <QList>
 #include <QPair>
 #include <QString>
@@ -22,6 +23,7 @@ class UpnpActionDescription;
 class UpnpStateVariableDescription;
 class UpnpEventSubscriber;
 class UpnpDeviceDescription;
+class QDataStream;
 
 /**
  * @brief The UpnpServiceDescription class is used to get all data about an UPnP service
@@ -58,6 +60,28 @@ public:
 
     [[nodiscard]] const QUrl &SCPDURL() const;
 
+    /**
+     * @brief setSCPDLoaded will record that actions and state variables have been read from the SCPD document
+     *
+     * Device descriptions parsed in lazy mode contain services whose SCPD has not been downloaded yet.
+     *
+     * @param value is true when the SCPD document has been parsed
+     */
+    void setSCPDLoaded(bool value);
+
+    [[nodiscard]] bool isSCPDLoaded() const;
+
+    /**
+     * @brief setSCPDHash will record the hash of the SCPD document the actions and state variables come from
+     *
+     * See \class UpnpServiceDescriptionStore.
+     *
+     * @param hash is the hash of the SCPD document
+     */
+    void setSCPDHash(const QByteArray &hash);
+
+    [[nodiscard]] const QByteArray &SCPDHash() const;
+
     void setControlURL(const QUrl &newControlURL);
 
     [[nodiscard]] const QUrl &controlURL() const;
@@ -90,6 +114,10 @@ private:
     std::unique_ptr<UpnpServiceDescriptionPrivate> d;
 };
 
+UPNPLIBQT_EXPORT QDataStream &operator<<(QDataStream &stream, const UpnpServiceDescription &data);
+
+UPNPLIBQT_EXPORT QDataStream &operator>>(QDataStream &stream, UpnpServiceDescription &data);
+
 Q_DECLARE_METATYPE(UpnpServiceDescription)
 
 #endif // UpnpServiceDescription_H
@@ -9,7 +9,11 @@
 #include "upnplogging.h"
 
 #include "upnpactiondescription.h"
+#include "upnpdescriptionfetchscheduler.h"
+#include "upnpdescriptionparsingpool.h"
 #include "upnpservicedescription.h"
+#include "upnpservicedescriptionstore.h"
+#include "upnpstatevariabledescription.h"
 
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
@@ -17,6 +21,8 @@
 
 #include <QDomDocument>
 
+#include <QPointer>
+
 #include <QLoggingCategory>
 
 class UpnpServiceDescriptionParserPrivate
@@ -34,6 +40,12 @@ public:
     UpnpServiceDescription &mServiceDescription;
 
     QUrl mServiceURL;
+
+    UpnpDescriptionParsingPool *mParsingPool = nullptr;
+
+    QPointer<UpnpDescriptionFetchScheduler> mFetchScheduler;
+
+    quint64 mFetchId = 0;
 };
 
 UpnpServiceDescriptionParser::UpnpServiceDescriptionParser(QNetworkAccessManager *aNetworkAccess, UpnpServiceDescription &deviceDescription, QObject *parent)
@@ -42,11 +54,35 @@ UpnpServiceDescriptionParser::UpnpServiceDescriptionParser(QNetworkAccessManager
 {
 }
 
-UpnpServiceDescriptionParser::~UpnpServiceDescriptionParser() = default;
+UpnpServiceDescriptionParser::~UpnpServiceDescriptionParser()
+{
+    if (d->mFetchScheduler && d->mFetchId) {
+        d->mFetchScheduler->cancel(d->mFetchId);
+    }
+}
+
+void UpnpServiceDescriptionParser::setParsingPool(UpnpDescriptionParsingPool *pool)
+{
+    d->mParsingPool = pool;
+}
+
+void UpnpServiceDescriptionParser::setFetchScheduler(UpnpDescriptionFetchScheduler *scheduler)
+{
+    d->mFetchScheduler = scheduler;
+}
 
 void UpnpServiceDescriptionParser::downloadServiceDescription(const QUrl &serviceUrl)
 {
     d->mServiceURL = serviceUrl;
+
+    if (d->mFetchScheduler) {
+        d->mFetchId = d->mFetchScheduler->fetch(serviceUrl, d->mServiceDescription.serviceType(), this, [this](QNetworkReply *reply) {
+            d->mFetchId = 0;
+            finishedDownload(reply);
+        });
+        return;
+    }
+
     d->mNetworkAccess->get(QNetworkRequest(serviceUrl));
 }
 
@@ -54,7 +90,7 @@ void UpnpServiceDescriptionParser::finishedDownload(QNetworkReply *reply)
 {
     if (reply->url() == d->mServiceURL) {
         if (reply->isFinished() && reply->error() == QNetworkReply::NoError) {
-            parseServiceDescription(reply);
+            parseServiceDescription(reply->readAll());
         } else if (reply->isFinished()) {
             qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpAbstractServiceDescription::finishedDownload"
                                            << "error";
@@ -62,10 +98,57 @@ void UpnpServiceDescriptionParser::finishedDownload(QNetworkReply *reply)
     }
 }
 
-void UpnpServiceDescriptionParser::parseServiceDescription(QIODevice *serviceDescriptionContent)
+void UpnpServiceDescriptionParser::parseServiceDescription(const QByteArray &serviceDescriptionContent)
+{
+    if (!d->mParsingPool) {
+        serviceDescriptionContentParsed(parseServiceDescriptionContent(serviceDescriptionContent));
+        return;
+    }
+
+    auto parsedDescription = std::make_shared<UpnpServiceDescription>();
+
+    d->mParsingPool->run(
+        this,
+        [parsedDescription, serviceDescriptionContent]() {
+            *parsedDescription = parseServiceDescriptionContent(serviceDescriptionContent);
+        },
+        [this, parsedDescription]() {
+            serviceDescriptionContentParsed(*parsedDescription);
+        });
+}
+
+void UpnpServiceDescriptionParser::serviceDescriptionContentParsed(const UpnpServiceDescription &parsedDescription)
+{
+    d->mServiceDescription.actions() = parsedDescription.actions();
+    d->mServiceDescription.stateVariables() = parsedDescription.stateVariables();
+    d->mServiceDescription.setSCPDHash(parsedDescription.SCPDHash());
+    d->mServiceDescription.setSCPDLoaded(true);
+
+    Q_EMIT descriptionParsed(d->mServiceDescription.serviceId());
+}
+
+UpnpServiceDescription UpnpServiceDescriptionParser::parseServiceDescriptionContent(const QByteArray &content)
 {
+    auto result = UpnpServiceDescription {};
+
+    const auto &contentHash = UpnpServiceDescriptionStore::contentHash(content);
+    if (UpnpServiceDescriptionStore::find(contentHash, result)) {
+        return result;
+    }
+
+    result = parseServiceDescriptionDocument(content);
+
+    UpnpServiceDescriptionStore::insert(contentHash, result);
+
+    return result;
+}
+
+UpnpServiceDescription UpnpServiceDescriptionParser::parseServiceDescriptionDocument(const QByteArray &content)
+{
+    auto result = UpnpServiceDescription {};
+
     QDomDocument serviceDescriptionDocument;
-    serviceDescriptionDocument.setContent(serviceDescriptionContent);
+    serviceDescriptionDocument.setContent(content);
 
     const QDomElement &scpdRoot = serviceDescriptionDocument.documentElement();
 
@@ -82,6 +165,7 @@ void UpnpServiceDescriptionParser::parseServiceDescription(QIODevice *serviceDes
         UpnpActionDescription newAction;
 
         newAction.mName = actionName;
+        newAction.mIsValid = !actionName.isEmpty();
 
         const QDomNode &argumentListNode = currentChild.firstChildElement(QStringLiteral("argumentList"));
         QDomNode argumentNode = argumentListNode.firstChild();
@@ -92,35 +176,73 @@ void UpnpServiceDescriptionParser::parseServiceDescription(QIODevice *serviceDes
             const QDomNode &argumentRelatedStateVariableNode = argumentNode.firstChildElement(QStringLiteral("relatedStateVariable"));
 
             UpnpActionArgumentDescription newArgument;
+            newArgument.mIsValid = true;
             newArgument.mName = argumentNameNode.toElement().text();
             newArgument.mDirection = (argumentDirectionNode.toElement().text() == QStringLiteral("in") ? UpnpArgumentDirection::In : UpnpArgumentDirection::Out);
             newArgument.mIsReturnValue = !argumentRetvalNode.isNull();
             newArgument.mRelatedStateVariable = argumentRelatedStateVariableNode.toElement().text();
 
-            newAction.mArguments.push_back(newArgument);
+            if (newArgument.mDirection == UpnpArgumentDirection::In) {
+                ++newAction.mNumberInArgument;
+            } else {
+                ++newAction.mNumberOutArgument;
+            }
 
-            d->mServiceDescription.addAction(newAction);
+            newAction.mArguments.push_back(newArgument);
 
             argumentNode = argumentNode.nextSibling();
         }
 
+        if (currentChild.isElement()) {
+            result.addAction(newAction);
+        }
+
         currentChild = currentChild.nextSibling();
     }
 
-#if 0
     const QDomElement &serviceStateTableRoot = scpdRoot.firstChildElement(QStringLiteral("serviceStateTable"));
-    currentChild = serviceStateTableRoot.firstChild();
-    while (!currentChild.isNull()) {
-        const QDomNode &nameNode = currentChild.firstChildElement(QStringLiteral("name"));
-        if (!nameNode.isNull()) {
-            qCDebug(orgKdeUpnpLibQtUpnp()) << "state variable name" << nameNode.toElement().text();
+    QDomElement stateVariableNode = serviceStateTableRoot.firstChildElement(QStringLiteral("stateVariable"));
+    while (!stateVariableNode.isNull()) {
+        UpnpStateVariableDescription newStateVariable;
+
+        newStateVariable.mUpnpName = stateVariableNode.firstChildElement(QStringLiteral("name")).text();
+        newStateVariable.mIsValid = !newStateVariable.mUpnpName.isEmpty();
+        newStateVariable.mEvented = stateVariableNode.attribute(QStringLiteral("sendEvents"), QStringLiteral("yes")) == QStringLiteral("yes");
+        newStateVariable.mDataType = stateVariableNode.firstChildElement(QStringLiteral("dataType")).text();
+        newStateVariable.mType = UpnpStateVariableDescription::typeFromDataType(newStateVariable.mDataType);
+
+        const QDomElement &defaultValueNode = stateVariableNode.firstChildElement(QStringLiteral("defaultValue"));
+        if (!defaultValueNode.isNull()) {
+            newStateVariable.mDefaultValue = defaultValueNode.text();
         }
 
-        currentChild = currentChild.nextSibling();
+        const QDomElement &allowedValueListNode = stateVariableNode.firstChildElement(QStringLiteral("allowedValueList"));
+        QDomElement allowedValueNode = allowedValueListNode.firstChildElement(QStringLiteral("allowedValue"));
+        while (!allowedValueNode.isNull()) {
+            newStateVariable.mValueList.push_back(allowedValueNode.text());
+
+            allowedValueNode = allowedValueNode.nextSiblingElement(QStringLiteral("allowedValue"));
+        }
+
+        const QDomElement &allowedValueRangeNode = stateVariableNode.firstChildElement(QStringLiteral("allowedValueRange"));
+        if (!allowedValueRangeNode.isNull()) {
+            newStateVariable.mMinimumValue = allowedValueRangeNode.firstChildElement(QStringLiteral("minimum")).text();
+            newStateVariable.mMaximumValue = allowedValueRangeNode.firstChildElement(QStringLiteral("maximum")).text();
+
+            const QDomElement &stepNode = allowedValueRangeNode.firstChildElement(QStringLiteral("step"));
+            if (!stepNode.isNull()) {
+                newStateVariable.mStep = stepNode.text();
+            }
+        }
+
+        if (newStateVariable.mIsValid) {
+            result.addStateVariable(newStateVariable);
+        }
+
+        stateVariableNode = stateVariableNode.nextSiblingElement(QStringLiteral("stateVariable"));
     }
-#endif
 
-    Q_EMIT descriptionParsed(d->mServiceDescription.serviceId());
+    return result;
 }
 
 #include "moc_upnpservicedescriptionparser.cpp"
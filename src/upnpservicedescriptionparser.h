@@ -19,6 +19,8 @@ class QIODevice;
 class QNetworkAccessManager;
 
 class UpnpServiceDescription;
+class UpnpDescriptionParsingPool;
+class UpnpDescriptionFetchScheduler;
 
 class UpnpServiceDescriptionParserPrivate;
 
@@ -35,6 +37,32 @@ public:
 
     ~UpnpServiceDescriptionParser() override;
 
+    /**
+     * @brief setParsingPool will move the parsing of the downloaded description to pool
+     *
+     * If no pool is set, the description is parsed synchronously when the download is finished.
+     */
+    void setParsingPool(UpnpDescriptionParsingPool *pool);
+
+    /**
+     * @brief setFetchScheduler will make the download of the description go through scheduler
+     *
+     * If no scheduler is set, the download is started immediately and finishedDownload must be connected to
+     * the QNetworkAccessManager::finished signal.
+     */
+    void setFetchScheduler(UpnpDescriptionFetchScheduler *scheduler);
+
+    /**
+     * @brief parseServiceDescriptionContent parses a service description (SCPD) document
+     *
+     * It can be called from any thread. Documents already parsed in this process are not parsed again, their
+     * actions and state variables are shared through \class UpnpServiceDescriptionStore.
+     *
+     * @param content is the SCPD XML document
+     * @return a service description with only actions and state variables set
+     */
+    [[nodiscard]] static UpnpServiceDescription parseServiceDescriptionContent(const QByteArray &content);
+
 Q_SIGNALS:
 
     void descriptionParsed(const QString &upnpServiceId);
@@ -48,7 +76,11 @@ public Q_SLOTS:
     void downloadServiceDescription(const QUrl &serviceUrl);
 
 private:
-    void parseServiceDescription(QIODevice *serviceDescriptionContent);
+    [[nodiscard]] static UpnpServiceDescription parseServiceDescriptionDocument(const QByteArray &content);
+
+    void parseServiceDescription(const QByteArray &serviceDescriptionContent);
+
+    void serviceDescriptionContentParsed(const UpnpServiceDescription &parsedDescription);
 
     std::unique_ptr<UpnpServiceDescriptionParserPrivate> d;
 };
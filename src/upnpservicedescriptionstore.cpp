@@ -0,0 +1,142 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpservicedescriptionstore.h"
+
+#include "upnpactiondescription.h"
+#include "upnpservicedescription.h"
+#include "upnpstatevariabledescription.h"
+
+#include <QCache>
+#include <QCryptographicHash>
+#include <QGlobalStatic>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+
+class UpnpStoredServiceDescription
+{
+public:
+    QMap<QString, UpnpActionDescription> mActions;
+
+    QMap<QString, UpnpStateVariableDescription> mStateVariables;
+};
+
+class UpnpServiceDescriptionStorePrivate
+{
+public:
+    UpnpServiceDescriptionStorePrivate()
+        : mDescriptions(256)
+    {
+    }
+
+    QMutex mMutex;
+
+    /**
+     * @brief mDescriptions has a cost of 1 per document, lookups move the document to the most recently used
+     */
+    QCache<QByteArray, UpnpStoredServiceDescription> mDescriptions;
+
+    quint64 mHitCount = 0;
+
+    quint64 mMissCount = 0;
+};
+
+Q_GLOBAL_STATIC(UpnpServiceDescriptionStorePrivate, serviceDescriptionStore)
+
+QByteArray UpnpServiceDescriptionStore::contentHash(const QByteArray &content)
+{
+    return QCryptographicHash::hash(content, QCryptographicHash::Sha256);
+}
+
+bool UpnpServiceDescriptionStore::find(const QByteArray &hash, UpnpServiceDescription &description)
+{
+    auto *store = serviceDescriptionStore();
+    QMutexLocker locker(&store->mMutex);
+
+    const auto *storedDescription = store->mDescriptions.object(hash);
+    if (!storedDescription) {
+        ++store->mMissCount;
+        return false;
+    }
+
+    ++store->mHitCount;
+
+    description.actions() = storedDescription->mActions;
+    description.stateVariables() = storedDescription->mStateVariables;
+    description.setSCPDHash(hash);
+
+    return true;
+}
+
+void UpnpServiceDescriptionStore::insert(const QByteArray &hash, UpnpServiceDescription &description)
+{
+    auto *store = serviceDescriptionStore();
+    QMutexLocker locker(&store->mMutex);
+
+    description.setSCPDHash(hash);
+
+    const auto *storedDescription = store->mDescriptions.object(hash);
+    if (storedDescription) {
+        description.actions() = storedDescription->mActions;
+        description.stateVariables() = storedDescription->mStateVariables;
+        return;
+    }
+
+    store->mDescriptions.insert(hash, new UpnpStoredServiceDescription{description.actions(), description.stateVariables()});
+}
+
+int UpnpServiceDescriptionStore::size()
+{
+    auto *store = serviceDescriptionStore();
+    QMutexLocker locker(&store->mMutex);
+
+    return static_cast<int>(store->mDescriptions.size());
+}
+
+int UpnpServiceDescriptionStore::maximumSize()
+{
+    auto *store = serviceDescriptionStore();
+    QMutexLocker locker(&store->mMutex);
+
+    return static_cast<int>(store->mDescriptions.maxCost());
+}
+
+void UpnpServiceDescriptionStore::setMaximumSize(int value)
+{
+    if (value < 0) {
+        return;
+    }
+
+    auto *store = serviceDescriptionStore();
+    QMutexLocker locker(&store->mMutex);
+
+    store->mDescriptions.setMaxCost(value);
+}
+
+quint64 UpnpServiceDescriptionStore::hitCount()
+{
+    auto *store = serviceDescriptionStore();
+    QMutexLocker locker(&store->mMutex);
+
+    return store->mHitCount;
+}
+
+quint64 UpnpServiceDescriptionStore::missCount()
+{
+    auto *store = serviceDescriptionStore();
+    QMutexLocker locker(&store->mMutex);
+
+    return store->mMissCount;
+}
+
+void UpnpServiceDescriptionStore::clear()
+{
+    auto *store = serviceDescriptionStore();
+    QMutexLocker locker(&store->mMutex);
+
+    store->mDescriptions.clear();
+}
@@ -0,0 +1,76 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef UPNPSERVICEDESCRIPTIONSTORE_H
+#define UPNPSERVICEDESCRIPTIONSTORE_H
+
+#include "upnplibqt_export.h"
+
+#include <QByteArray>
+
+class UpnpServiceDescription;
+
+/**
+ * @brief The UpnpServiceDescriptionStore class is a process-wide store of parsed service descriptions (SCPD)
+ *
+ * Devices of the same model usually publish byte-identical SCPD documents. The store indexes parsed actions and
+ * state variables by a hash of the downloaded document. All \class UpnpServiceDescription built from the same
+ * document share the same implicitly shared action and state variable maps, so the document is parsed once and
+ * kept once in memory.
+ *
+ * The store keeps at most maximumSize documents and forgets the least recently used ones first.
+ *
+ * All methods are thread-safe.
+ */
+class UPNPLIBQT_EXPORT UpnpServiceDescriptionStore
+{
+public:
+    /**
+     * @brief contentHash computes the key of a SCPD document in the store
+     */
+    [[nodiscard]] static QByteArray contentHash(const QByteArray &content);
+
+    /**
+     * @brief find will copy the shared actions and state variables stored for hash into description
+     *
+     * @param hash is the result of contentHash for the SCPD document
+     * @param description receives the actions, state variables and hash
+     * @return true if the document was found in the store
+     */
+    [[nodiscard]] static bool find(const QByteArray &hash, UpnpServiceDescription &description);
+
+    /**
+     * @brief insert will store the actions and state variables of description for hash
+     *
+     * If another thread already stored the same document, the stored version is kept and copied into description.
+     */
+    static void insert(const QByteArray &hash, UpnpServiceDescription &description);
+
+    [[nodiscard]] static int size();
+
+    /**
+     * @brief maximumSize is the number of documents kept in the store, 256 by default
+     */
+    [[nodiscard]] static int maximumSize();
+
+    /**
+     * @brief setMaximumSize will change the number of documents kept, removing the least recently used ones if needed
+     */
+    static void setMaximumSize(int value);
+
+    [[nodiscard]] static quint64 hitCount();
+
+    [[nodiscard]] static quint64 missCount();
+
+    /**
+     * @brief clear will remove all stored documents
+     *
+     * Descriptions already built from the store keep their copy of the data.
+     */
+    static void clear();
+};
+
+#endif // UPNPSERVICEDESCRIPTIONSTORE_H
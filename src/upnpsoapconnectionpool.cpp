@@ -0,0 +1,441 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpsoapconnectionpool.h"
+
+#include "upnplogging.h"
+
+#include "upnpactionresult.h"
+
+#include <KDSoapClient/KDSoapClientInterface.h>
+#include <KDSoapClient/KDSoapMessage.h>
+#include <KDSoapClient/KDSoapPendingCall.h>
+#include <KDSoapClient/KDSoapPendingCallWatcher.h>
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QTimer>
+
+#include <QLoggingCategory>
+
+#include <unordered_map>
+#include <utility>
+
+class UpnpSoapPendingInvocation
+{
+public:
+    quint64 mCallId = 0;
+
+    UpnpActionCompletion mCompletion;
+
+    QUrl mControlUrl;
+
+    QString mServiceType;
+
+    QString mActionName;
+
+    KDSoapMessage mMessage;
+
+    QString mSoapAction;
+};
+
+class UpnpSoapHostConnections
+{
+public:
+    std::unique_ptr<KDSoapClientInterface> mInterface;
+
+    QList<UpnpSoapPendingInvocation> mPendingCalls;
+
+    QElapsedTimer mLastActivity;
+
+    QHash<quint64, KDSoapPendingCallWatcher *> mRunningCalls;
+
+    /**
+     * @brief mAbortedCalls are the requests of aborted calls still running, they keep their connection busy
+     */
+    QList<KDSoapPendingCallWatcher *> mAbortedCalls;
+};
+
+class UpnpSoapConnectionPoolPrivate
+{
+public:
+    std::unordered_map<QString, UpnpSoapHostConnections> mHosts;
+
+    /**
+     * @brief mCallHosts gives the host of each pending or running call, used by abort
+     */
+    QHash<quint64, QString> mCallHosts;
+
+    quint64 mNextCallId = 1;
+
+    QTimer mIdleTimer;
+
+    int mMaximumConnectionsPerHost = 2;
+
+    int mIdleTimeout = 30000;
+
+    quint64 mTotalCalls = 0;
+
+    quint64 mReusedCalls = 0;
+
+    quint64 mCreatedInterfaces = 0;
+
+    quint64 mAbortedCalls = 0;
+
+    qint64 mCreatedInterfaceLatencySum = 0;
+
+    quint64 mCreatedInterfaceLatencyCount = 0;
+
+    qint64 mReusedLatencySum = 0;
+
+    quint64 mReusedLatencyCount = 0;
+};
+
+UpnpSoapConnectionPool::UpnpSoapConnectionPool(QObject *parent)
+    : QObject(parent)
+    , d(std::make_unique<UpnpSoapConnectionPoolPrivate>())
+{
+    d->mIdleTimer.setInterval(d->mIdleTimeout / 2);
+    connect(&d->mIdleTimer, &QTimer::timeout, this, &UpnpSoapConnectionPool::closeIdleConnections);
+}
+
+UpnpSoapConnectionPool::~UpnpSoapConnectionPool() = default;
+
+int UpnpSoapConnectionPool::maximumConnectionsPerHost() const
+{
+    return d->mMaximumConnectionsPerHost;
+}
+
+int UpnpSoapConnectionPool::idleTimeout() const
+{
+    return d->mIdleTimeout;
+}
+
+quint64 UpnpSoapConnectionPool::call(const UpnpActionCompletion &completion, const QUrl &controlUrl, const QString &serviceType,
+                                     const QString &actionName, const KDSoapMessage &message, const QString &soapAction)
+{
+    const QString hostKey = controlUrl.host() + QLatin1Char(':') + QString::number(controlUrl.port(controlUrl.scheme() == QLatin1String("https") ? 443 : 80));
+    const auto callId = d->mNextCallId++;
+
+    d->mCallHosts[callId] = hostKey;
+    d->mHosts[hostKey].mPendingCalls.push_back({callId, completion, controlUrl, serviceType, actionName, message, soapAction});
+
+    startPendingCalls(hostKey);
+
+    if (d->mIdleTimeout > 0 && !d->mIdleTimer.isActive()) {
+        d->mIdleTimer.start();
+    }
+
+    return callId;
+}
+
+void UpnpSoapConnectionPool::abort(quint64 callId)
+{
+    const auto itCallHost = d->mCallHosts.constFind(callId);
+    if (itCallHost == d->mCallHosts.constEnd()) {
+        return;
+    }
+
+    const auto hostKey = *itCallHost;
+    d->mCallHosts.erase(itCallHost);
+
+    auto itHost = d->mHosts.find(hostKey);
+    if (itHost == d->mHosts.end()) {
+        return;
+    }
+
+    auto &host = itHost->second;
+
+    ++d->mAbortedCalls;
+
+    auto *callWatcher = host.mRunningCalls.take(callId);
+    if (!callWatcher) {
+        host.mPendingCalls.removeIf([callId](const UpnpSoapPendingInvocation &oneInvocation) {
+            return oneInvocation.mCallId == callId;
+        });
+
+        return;
+    }
+
+    qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpSoapConnectionPool::abort" << hostKey << callId;
+
+    callWatcher->disconnect(this);
+
+    // the request is still counted for its host until its answer or until the client is destroyed
+    host.mAbortedCalls.push_back(callWatcher);
+    connect(callWatcher, &KDSoapPendingCallWatcher::finished, this, [this, hostKey](KDSoapPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+
+        auto itAbortedHost = d->mHosts.find(hostKey);
+        if (itAbortedHost != d->mHosts.end()) {
+            itAbortedHost->second.mAbortedCalls.removeOne(watcher);
+        }
+
+        startPendingCalls(hostKey);
+    });
+
+    closeAbortedCalls(hostKey);
+    startPendingCalls(hostKey);
+}
+
+int UpnpSoapConnectionPool::openedHostsCount() const
+{
+    int result = 0;
+
+    for (const auto &oneHost : d->mHosts) {
+        if (oneHost.second.mInterface) {
+            ++result;
+        }
+    }
+
+    return result;
+}
+
+int UpnpSoapConnectionPool::runningCalls() const
+{
+    int result = 0;
+
+    for (const auto &oneHost : d->mHosts) {
+        result += oneHost.second.mRunningCalls.size();
+    }
+
+    return result;
+}
+
+int UpnpSoapConnectionPool::pendingCalls() const
+{
+    int result = 0;
+
+    for (const auto &oneHost : d->mHosts) {
+        result += oneHost.second.mPendingCalls.size();
+    }
+
+    return result;
+}
+
+quint64 UpnpSoapConnectionPool::totalCalls() const
+{
+    return d->mTotalCalls;
+}
+
+quint64 UpnpSoapConnectionPool::reusedCalls() const
+{
+    return d->mReusedCalls;
+}
+
+quint64 UpnpSoapConnectionPool::createdInterfaces() const
+{
+    return d->mCreatedInterfaces;
+}
+
+quint64 UpnpSoapConnectionPool::abortedCalls() const
+{
+    return d->mAbortedCalls;
+}
+
+double UpnpSoapConnectionPool::reuseRate() const
+{
+    if (!d->mTotalCalls) {
+        return 0.;
+    }
+
+    return static_cast<double>(d->mReusedCalls) / static_cast<double>(d->mTotalCalls);
+}
+
+double UpnpSoapConnectionPool::averageCreatedInterfaceCallLatency() const
+{
+    if (!d->mCreatedInterfaceLatencyCount) {
+        return 0.;
+    }
+
+    return static_cast<double>(d->mCreatedInterfaceLatencySum) / static_cast<double>(d->mCreatedInterfaceLatencyCount);
+}
+
+double UpnpSoapConnectionPool::averageReusedCallLatency() const
+{
+    if (!d->mReusedLatencyCount) {
+        return 0.;
+    }
+
+    return static_cast<double>(d->mReusedLatencySum) / static_cast<double>(d->mReusedLatencyCount);
+}
+
+void UpnpSoapConnectionPool::resetStatistics()
+{
+    d->mTotalCalls = 0;
+    d->mReusedCalls = 0;
+    d->mCreatedInterfaces = 0;
+    d->mAbortedCalls = 0;
+    d->mCreatedInterfaceLatencySum = 0;
+    d->mCreatedInterfaceLatencyCount = 0;
+    d->mReusedLatencySum = 0;
+    d->mReusedLatencyCount = 0;
+}
+
+void UpnpSoapConnectionPool::setMaximumConnectionsPerHost(int value)
+{
+    if (d->mMaximumConnectionsPerHost == value || value < 1) {
+        return;
+    }
+
+    d->mMaximumConnectionsPerHost = value;
+    Q_EMIT maximumConnectionsPerHostChanged();
+
+    for (const auto &oneHost : d->mHosts) {
+        startPendingCalls(oneHost.first);
+    }
+}
+
+void UpnpSoapConnectionPool::setIdleTimeout(int value)
+{
+    if (d->mIdleTimeout == value || value < 0) {
+        return;
+    }
+
+    d->mIdleTimeout = value;
+    if (d->mIdleTimeout > 0) {
+        d->mIdleTimer.setInterval(qMax(d->mIdleTimeout / 2, 1));
+        if (!d->mHosts.empty()) {
+            d->mIdleTimer.start();
+        }
+    } else {
+        d->mIdleTimer.stop();
+    }
+    Q_EMIT idleTimeoutChanged();
+}
+
+void UpnpSoapConnectionPool::closeIdleConnections()
+{
+    for (auto itHost = d->mHosts.begin(); itHost != d->mHosts.end();) {
+        const auto &oneHost = itHost->second;
+
+        if (oneHost.mRunningCalls.isEmpty() && oneHost.mAbortedCalls.isEmpty() && oneHost.mPendingCalls.isEmpty() &&
+                (!oneHost.mLastActivity.isValid() || oneHost.mLastActivity.elapsed() >= d->mIdleTimeout)) {
+            qCDebug(orgKdeUpnpLibQtUpnp()) << "UpnpSoapConnectionPool::closeIdleConnections" << itHost->first;
+
+            itHost = d->mHosts.erase(itHost);
+        } else {
+            ++itHost;
+        }
+    }
+
+    if (d->mHosts.empty()) {
+        d->mIdleTimer.stop();
+    }
+}
+
+void UpnpSoapConnectionPool::startPendingCalls(const QString &hostKey)
+{
+    auto itHost = d->mHosts.find(hostKey);
+    if (itHost == d->mHosts.end()) {
+        return;
+    }
+
+    auto &host = itHost->second;
+
+    while (host.mRunningCalls.size() + host.mAbortedCalls.size() < d->mMaximumConnectionsPerHost && !host.mPendingCalls.isEmpty()) {
+        auto oneInvocation = host.mPendingCalls.takeFirst();
+        if (oneInvocation.mCompletion.isCanceled()) {
+            d->mCallHosts.remove(oneInvocation.mCallId);
+            continue;
+        }
+
+        const bool isNewConnection = !host.mInterface;
+        if (isNewConnection) {
+            host.mInterface = std::make_unique<KDSoapClientInterface>(oneInvocation.mControlUrl.toString(), oneInvocation.mServiceType);
+            host.mInterface->setSoapVersion(KDSoapClientInterface::SOAP1_1);
+            host.mInterface->setStyle(KDSoapClientInterface::RPCStyle);
+
+            ++d->mCreatedInterfaces;
+        } else {
+            host.mInterface->setEndPoint(oneInvocation.mControlUrl.toString());
+
+            ++d->mReusedCalls;
+        }
+
+        ++d->mTotalCalls;
+        host.mLastActivity.start();
+
+        oneInvocation.mMessage.setNamespaceUri(oneInvocation.mServiceType);
+
+        const auto pendingCall = host.mInterface->asyncCall(oneInvocation.mActionName, oneInvocation.mMessage, oneInvocation.mSoapAction);
+
+        QElapsedTimer callDuration;
+        callDuration.start();
+
+        auto *callWatcher = new KDSoapPendingCallWatcher(pendingCall, this);
+        host.mRunningCalls[oneInvocation.mCallId] = callWatcher;
+
+        connect(callWatcher,
+                &KDSoapPendingCallWatcher::finished,
+                this,
+                [this, hostKey, isNewConnection, callDuration, callId = oneInvocation.mCallId, completion = oneInvocation.mCompletion](KDSoapPendingCallWatcher *watcher) {
+            if (isNewConnection) {
+                d->mCreatedInterfaceLatencySum += callDuration.elapsed();
+                ++d->mCreatedInterfaceLatencyCount;
+            } else {
+                d->mReusedLatencySum += callDuration.elapsed();
+                ++d->mReusedLatencyCount;
+            }
+
+            watcher->deleteLater();
+
+            d->mCallHosts.remove(callId);
+
+            auto hasOnlyAbortedCalls = false;
+
+            auto itFinishedHost = d->mHosts.find(hostKey);
+            if (itFinishedHost != d->mHosts.end()) {
+                itFinishedHost->second.mRunningCalls.remove(callId);
+                itFinishedHost->second.mLastActivity.start();
+
+                hasOnlyAbortedCalls = itFinishedHost->second.mRunningCalls.isEmpty() && !itFinishedHost->second.mAbortedCalls.isEmpty();
+            }
+
+            completion.finish(UpnpActionResult::fromPendingCall(*watcher));
+
+            if (hasOnlyAbortedCalls) {
+                // the client cannot be destroyed while it delivers an answer
+                QMetaObject::invokeMethod(
+                    this,
+                    [this, hostKey]() {
+                        closeAbortedCalls(hostKey);
+                        startPendingCalls(hostKey);
+                    },
+                    Qt::QueuedConnection);
+
+                return;
+            }
+
+            startPendingCalls(hostKey);
+        });
+    }
+}
+
+void UpnpSoapConnectionPool::closeAbortedCalls(const QString &hostKey)
+{
+    auto itHost = d->mHosts.find(hostKey);
+    if (itHost == d->mHosts.end()) {
+        return;
+    }
+
+    auto &host = itHost->second;
+    if (!host.mRunningCalls.isEmpty() || host.mAbortedCalls.isEmpty()) {
+        return;
+    }
+
+    for (auto *oneWatcher : std::as_const(host.mAbortedCalls)) {
+        oneWatcher->disconnect(this);
+        oneWatcher->deleteLater();
+    }
+    host.mAbortedCalls.clear();
+
+    // destroying the client closes its connections, the only way to stop a request that does not answer
+    host.mInterface.reset();
+}
+
+#include "moc_upnpsoapconnectionpool.cpp"
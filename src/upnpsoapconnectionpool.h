@@ -0,0 +1,154 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef UPNPSOAPCONNECTIONPOOL_H
+#define UPNPSOAPCONNECTIONPOOL_H
+
+#include "upnplibqt_export.h"
+
+#include <QObject>
+#include <QString>
+#include <QUrl>
+
+#include <memory>
+
+class KDSoapMessage;
+class UpnpActionCompletion;
+class UpnpSoapConnectionPoolPrivate;
+
+/**
+ * @brief The UpnpSoapConnectionPool class shares the SOAP connections used to call actions on the services of one device
+ *
+ * All services of a \class UpnpControlAbstractDevice send their action calls through the pool of the device. The
+ * pool keeps one SOAP client per host, whose HTTP connections are kept alive between calls. At most
+ * maximumConnectionsPerHost calls are running at the same time for one host, other calls are queued. The client of
+ * a host is destroyed, and its connections closed, when no call was made during idleTimeout.
+ *
+ * The pool also measures how often calls reuse an existing client (reuseRate) and the duration of calls that
+ * had to create a new client compared to the other calls.
+ */
+class UPNPLIBQT_EXPORT UpnpSoapConnectionPool : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int maximumConnectionsPerHost
+            READ maximumConnectionsPerHost
+                WRITE setMaximumConnectionsPerHost
+                    NOTIFY maximumConnectionsPerHostChanged)
+
+    Q_PROPERTY(int idleTimeout
+            READ idleTimeout
+                WRITE setIdleTimeout
+                    NOTIFY idleTimeoutChanged)
+
+public:
+    explicit UpnpSoapConnectionPool(QObject *parent = nullptr);
+
+    ~UpnpSoapConnectionPool() override;
+
+    [[nodiscard]] int maximumConnectionsPerHost() const;
+
+    /**
+     * @brief idleTimeout is the duration in milliseconds after which unused connections to a host are closed
+     *
+     * 0 keeps the connections open until the pool is destroyed.
+     */
+    [[nodiscard]] int idleTimeout() const;
+
+    /**
+     * @brief call will send an action call or queue it if too many calls are running for the host of controlUrl
+     *
+     * @param completion is called with the result of the call; the call is dropped if it is canceled before being sent
+     * @param controlUrl is the control url of the service
+     * @param serviceType is the namespace of the action element
+     * @param actionName is the name of the action
+     * @param message contains the arguments of the action
+     * @param soapAction is the value of the SOAPACTION header
+     * @return an identifier of the call for abort
+     */
+    quint64 call(const UpnpActionCompletion &completion, const QUrl &controlUrl, const QString &serviceType,
+              const QString &actionName, const KDSoapMessage &message, const QString &soapAction);
+
+    /**
+     * @brief abort will drop a pending call or stop waiting for a running call
+     *
+     * The completion of the call is not called. KDSoap cannot stop one request, so the client of the host, and
+     * its connections, are destroyed when no other call is running for this host. Until then, the aborted request
+     * still counts in maximumConnectionsPerHost.
+     */
+    void abort(quint64 callId);
+
+    [[nodiscard]] int openedHostsCount() const;
+
+    [[nodiscard]] int runningCalls() const;
+
+    [[nodiscard]] int pendingCalls() const;
+
+    [[nodiscard]] quint64 totalCalls() const;
+
+    /**
+     * @brief reusedCalls is the number of calls sent on the already connected client of their host
+     */
+    [[nodiscard]] quint64 reusedCalls() const;
+
+    /**
+     * @brief createdInterfaces is the number of calls that needed a new client for their host
+     *
+     * It is not the number of TCP connections: a client can open several connections and reopen them.
+     */
+    [[nodiscard]] quint64 createdInterfaces() const;
+
+    /**
+     * @brief abortedCalls is the number of calls aborted before their answer was received
+     */
+    [[nodiscard]] quint64 abortedCalls() const;
+
+    /**
+     * @brief reuseRate is the ratio of reusedCalls to totalCalls
+     */
+    [[nodiscard]] double reuseRate() const;
+
+    /**
+     * @brief averageCreatedInterfaceCallLatency is the average duration in milliseconds of the calls that created the client of their host
+     *
+     * It is the duration of the whole call, from sending the request until the answer is received.
+     */
+    [[nodiscard]] double averageCreatedInterfaceCallLatency() const;
+
+    /**
+     * @brief averageReusedCallLatency is the average duration in milliseconds of the calls sent with an existing client
+     *
+     * The difference with averageCreatedInterfaceCallLatency approximates the cost of the connection setup.
+     */
+    [[nodiscard]] double averageReusedCallLatency() const;
+
+    void resetStatistics();
+
+Q_SIGNALS:
+
+    void maximumConnectionsPerHostChanged();
+
+    void idleTimeoutChanged();
+
+public Q_SLOTS:
+
+    void setMaximumConnectionsPerHost(int value);
+
+    void setIdleTimeout(int value);
+
+private Q_SLOTS:
+
+    void closeIdleConnections();
+
+private:
+    void startPendingCalls(const QString &hostKey);
+
+    void closeAbortedCalls(const QString &hostKey);
+
+    std::unique_ptr<UpnpSoapConnectionPoolPrivate> d;
+};
+
+#endif // UPNPSOAPCONNECTIONPOOL_H
@@ -523,6 +523,13 @@ void UpnpSsdpEngine::parseSsdpAnnounceDatagram(const QByteArray &datagram, const
         if (header.startsWith("DATE:")) {
             newDiscovery.setAnnounceDate(QString::fromLatin1(header.mid(5, header.length() - 6).trimmed()));
         }
+        if (header.startsWith("CONFIGID.UPNP.ORG:") || header.startsWith("ConfigId.upnp.org:")) {
+            bool isValid = false;
+            const auto configId = header.mid(18, header.length() - 19).trimmed().toInt(&isValid);
+            if (isValid) {
+                newDiscovery.setConfigId(configId);
+            }
+        }
         if (header.startsWith("Cache-Control:") || header.startsWith("CACHE-CONTROL:")) {
             const QList<QByteArray> &splittedLine = header.mid(14, header.length() - 15).split('=');
             if (splittedLine.size() == 2) {
@@ -6,6 +6,12 @@
 
 #include "upnpstatevariabledescription.h"
 
+#include <QDataStream>
+#include <QDate>
+#include <QDateTime>
+#include <QTime>
+#include <QUrl>
+
 UpnpStateVariableDescription::UpnpStateVariableDescription()
     : mUpnpName()
     , mPropertyName()
@@ -17,3 +23,138 @@ UpnpStateVariableDescription::UpnpStateVariableDescription()
     , mValueList()
 {
 }
+
+QVariant UpnpStateVariableDescription::typedValue(QStringView value) const
+{
+    auto isValid = false;
+
+    switch (mType) {
+    case UpnpStateVariableType::UnsignedInteger: {
+        const auto result = value.toULongLong(&isValid);
+        if (isValid) {
+            return result;
+        }
+        break;
+    }
+    case UpnpStateVariableType::SignedInteger: {
+        const auto result = value.toLongLong(&isValid);
+        if (isValid) {
+            return result;
+        }
+        break;
+    }
+    case UpnpStateVariableType::Real: {
+        const auto result = value.toDouble(&isValid);
+        if (isValid) {
+            return result;
+        }
+        break;
+    }
+    case UpnpStateVariableType::Boolean: {
+        const auto result = booleanValue(value, &isValid);
+        if (isValid) {
+            return result;
+        }
+        break;
+    }
+    case UpnpStateVariableType::Date: {
+        const auto result = QDate::fromString(value, Qt::ISODate);
+        if (result.isValid()) {
+            return result;
+        }
+        break;
+    }
+    case UpnpStateVariableType::DateTime: {
+        const auto result = QDateTime::fromString(value, Qt::ISODate);
+        if (result.isValid()) {
+            return result;
+        }
+        break;
+    }
+    case UpnpStateVariableType::Time: {
+        const auto result = QTime::fromString(value, Qt::ISODate);
+        if (result.isValid()) {
+            return result;
+        }
+        break;
+    }
+    case UpnpStateVariableType::Uri:
+        return QUrl(value.toString());
+    case UpnpStateVariableType::Base64:
+        return QByteArray::fromBase64(value.toLatin1());
+    case UpnpStateVariableType::Hex:
+        return QByteArray::fromHex(value.toLatin1());
+    case UpnpStateVariableType::String:
+        break;
+    }
+
+    return value.toString();
+}
+
+bool UpnpStateVariableDescription::booleanValue(QStringView value, bool *isValid)
+{
+    if (value == QLatin1String("1") || value.compare(QLatin1String("true"), Qt::CaseInsensitive) == 0 || value.compare(QLatin1String("yes"), Qt::CaseInsensitive) == 0) {
+        *isValid = true;
+        return true;
+    }
+
+    *isValid = value == QLatin1String("0") || value.compare(QLatin1String("false"), Qt::CaseInsensitive) == 0 || value.compare(QLatin1String("no"), Qt::CaseInsensitive) == 0;
+
+    return false;
+}
+
+UpnpStateVariableType UpnpStateVariableDescription::typeFromDataType(const QString &dataType)
+{
+    if (dataType == QStringLiteral("ui1") || dataType == QStringLiteral("ui2") || dataType == QStringLiteral("ui4") || dataType == QStringLiteral("ui8")) {
+        return UpnpStateVariableType::UnsignedInteger;
+    }
+    if (dataType == QStringLiteral("i1") || dataType == QStringLiteral("i2") || dataType == QStringLiteral("i4") || dataType == QStringLiteral("i8")
+        || dataType == QStringLiteral("int")) {
+        return UpnpStateVariableType::SignedInteger;
+    }
+    if (dataType == QStringLiteral("r4") || dataType == QStringLiteral("r8") || dataType == QStringLiteral("number") || dataType == QStringLiteral("float")
+        || dataType == QStringLiteral("fixed.14.4")) {
+        return UpnpStateVariableType::Real;
+    }
+    if (dataType == QStringLiteral("boolean")) {
+        return UpnpStateVariableType::Boolean;
+    }
+    if (dataType == QStringLiteral("date")) {
+        return UpnpStateVariableType::Date;
+    }
+    if (dataType == QStringLiteral("dateTime") || dataType == QStringLiteral("dateTime.tz")) {
+        return UpnpStateVariableType::DateTime;
+    }
+    if (dataType == QStringLiteral("time") || dataType == QStringLiteral("time.tz")) {
+        return UpnpStateVariableType::Time;
+    }
+    if (dataType == QStringLiteral("uri")) {
+        return UpnpStateVariableType::Uri;
+    }
+    if (dataType == QStringLiteral("bin.base64")) {
+        return UpnpStateVariableType::Base64;
+    }
+    if (dataType == QStringLiteral("bin.hex")) {
+        return UpnpStateVariableType::Hex;
+    }
+
+    return UpnpStateVariableType::String;
+}
+
+QDataStream &operator<<(QDataStream &stream, const UpnpStateVariableDescription &data)
+{
+    stream << data.mIsValid << data.mUpnpName << data.mEvented << data.mDataType << data.mDefaultValue
+           << data.mMinimumValue << data.mMaximumValue << data.mStep << data.mValueList;
+
+    return stream;
+}
+
+QDataStream &operator>>(QDataStream &stream, UpnpStateVariableDescription &data)
+{
+    stream >> data.mIsValid >> data.mUpnpName >> data.mEvented >> data.mDataType >> data.mDefaultValue
+        >> data.mMinimumValue >> data.mMaximumValue >> data.mStep >> data.mValueList;
+
+    data.mType = UpnpStateVariableDescription::typeFromDataType(data.mDataType);
+
+    return stream;
+}
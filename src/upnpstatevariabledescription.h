@@ -11,10 +11,31 @@
 
 #include <QByteArray>
 #include <QString>
+#include <QStringView>
 #include <QVariant>
 #include <QVector>
 
 class QObject;
+class QDataStream;
+
+/**
+ * @brief The UpnpStateVariableType enum is the conversion used for the values of a state variable
+ *
+ * It is computed once from the UPnP data type when the service description is parsed.
+ */
+enum class UpnpStateVariableType {
+    String,
+    UnsignedInteger,
+    SignedInteger,
+    Real,
+    Boolean,
+    Date,
+    DateTime,
+    Time,
+    Uri,
+    Base64,
+    Hex,
+};
 
 /**
  * @brief The UpnpStateVariableDescription class provides tyhe description of a state variable of an UPnP service.
@@ -26,6 +47,27 @@ class UPNPLIBQT_EXPORT UpnpStateVariableDescription
 public:
     UpnpStateVariableDescription();
 
+    /**
+     * @brief typedValue converts a value received as text (e.g. in an event) to the type given by mDataType
+     *
+     * Integers are converted to qlonglong or qulonglong, floating point numbers to double, booleans to bool, dates and
+     * times to QDate, QDateTime or QTime, uri to QUrl and binary data to QByteArray. Other types and values that
+     * cannot be converted are returned as QString. Only the string results copy the text of value.
+     */
+    [[nodiscard]] QVariant typedValue(QStringView value) const;
+
+    /**
+     * @brief typeFromDataType returns the conversion of values for an UPnP data type like ui4 or boolean
+     */
+    [[nodiscard]] static UpnpStateVariableType typeFromDataType(const QString &dataType);
+
+    /**
+     * @brief booleanValue converts the text of an UPnP boolean ("1", "true", "yes", "0", "false" or "no")
+     *
+     * @param isValid is set to false when value is not a boolean
+     */
+    [[nodiscard]] static bool booleanValue(QStringView value, bool *isValid);
+
     bool mIsValid{false};
 
     QString mUpnpName;
@@ -40,6 +82,11 @@ public:
 
     QString mDataType;
 
+    /**
+     * @brief mType is the conversion of values given by mDataType, it must be updated with mDataType
+     */
+    UpnpStateVariableType mType{UpnpStateVariableType::String};
+
     QVariant mDefaultValue;
 
     QVariant mMinimumValue;
@@ -51,4 +98,13 @@ public:
     QVector<QString> mValueList;
 };
 
+/**
+ * @brief operator << will serialize the UPnP part of data
+ *
+ * mObject, mPropertyName and mPropertyIndex only make sense in the process that published the service and are not serialized.
+ */
+UPNPLIBQT_EXPORT QDataStream &operator<<(QDataStream &stream, const UpnpStateVariableDescription &data);
+
+UPNPLIBQT_EXPORT QDataStream &operator>>(QDataStream &stream, UpnpStateVariableDescription &data);
+
 #endif // UPNPSTATEVARIABLEDESCRIPTION_H
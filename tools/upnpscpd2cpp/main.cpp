@@ -0,0 +1,110 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "proxygenerator.h"
+#include "scpddocument.h"
+#include "skeletongenerator.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <cstdio>
+
+namespace
+{
+
+bool writeFile(const QString &fileName, const QString &content)
+{
+    QSaveFile outputFile(fileName);
+    if (!outputFile.open(QIODevice::WriteOnly)) {
+        fprintf(stderr, "upnpscpd2cpp: cannot write %s\n", qPrintable(fileName));
+        return false;
+    }
+
+    outputFile.write(content.toUtf8());
+
+    return outputFile.commit();
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("upnpscpd2cpp"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Generates C++ classes from UPnP service descriptions (SCPD)"));
+    parser.addHelpOption();
+
+    const QCommandLineOption proxyOption(QStringLiteral("proxy"), QStringLiteral("Generate a typed client proxy deriving from UpnpControlAbstractService."));
+    const QCommandLineOption skeletonOption(QStringLiteral("skeleton"),
+                                            QStringLiteral("Generate an abstract server side service deriving from UpnpAbstractService."));
+    const QCommandLineOption classOption(QStringLiteral("class"), QStringLiteral("Name of the generated class."), QStringLiteral("name"));
+    const QCommandLineOption serviceTypeOption(QStringLiteral("service-type"), QStringLiteral("UPnP service type of the service."), QStringLiteral("type"));
+    const QCommandLineOption outputOption(QStringList{QStringLiteral("o"), QStringLiteral("output")},
+                                          QStringLiteral("Base name of the generated files; .h and .cpp are appended."),
+                                          QStringLiteral("basename"));
+
+    parser.addOption(proxyOption);
+    parser.addOption(skeletonOption);
+    parser.addOption(classOption);
+    parser.addOption(serviceTypeOption);
+    parser.addOption(outputOption);
+    parser.addPositionalArgument(QStringLiteral("scpd"), QStringLiteral("The SCPD XML file."));
+
+    parser.process(app);
+
+    const auto &positionalArguments = parser.positionalArguments();
+    if (positionalArguments.size() != 1 || !parser.isSet(classOption) || !parser.isSet(outputOption)
+        || parser.isSet(proxyOption) == parser.isSet(skeletonOption)) {
+        parser.showHelp(1);
+    }
+
+    QFile scpdFile(positionalArguments.first());
+    if (!scpdFile.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "upnpscpd2cpp: cannot read %s\n", qPrintable(scpdFile.fileName()));
+        return 1;
+    }
+
+    ScpdDocument document;
+    QString errorMessage;
+    if (!document.parse(scpdFile.readAll(), errorMessage)) {
+        fprintf(stderr, "upnpscpd2cpp: %s: %s\n", qPrintable(scpdFile.fileName()), qPrintable(errorMessage));
+        return 1;
+    }
+
+    const auto &outputBaseName = parser.value(outputOption);
+    const auto &headerFileName = QFileInfo(outputBaseName + QStringLiteral(".h")).fileName();
+
+    QString headerContent;
+    QString sourceContent;
+
+    if (parser.isSet(proxyOption)) {
+        const ProxyGenerator generator(document, parser.value(classOption), parser.value(serviceTypeOption));
+
+        headerContent = generator.header(headerFileName);
+        sourceContent = generator.source(headerFileName);
+    } else {
+        const SkeletonGenerator generator(document, parser.value(classOption), parser.value(serviceTypeOption));
+
+        headerContent = generator.header(headerFileName);
+        sourceContent = generator.source(headerFileName);
+    }
+
+    if (!writeFile(outputBaseName + QStringLiteral(".h"), headerContent)) {
+        return 1;
+    }
+
+    if (!writeFile(outputBaseName + QStringLiteral(".cpp"), sourceContent)) {
+        return 1;
+    }
+
+    return 0;
+}
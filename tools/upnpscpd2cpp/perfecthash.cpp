@@ -0,0 +1,84 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "perfecthash.h"
+
+PerfectHash::PerfectHash(const QList<QString> &names)
+{
+    while (mTableSize < static_cast<quint32>(names.size()) * 2) {
+        mTableSize *= 2;
+    }
+
+    static const quint32 maximumSeed = 1 << 16;
+
+    while (true) {
+        for (mSeed = 0; mSeed < maximumSeed; ++mSeed) {
+            if (tryBuild(names)) {
+                return;
+            }
+        }
+
+        mTableSize *= 2;
+    }
+}
+
+quint32 PerfectHash::seed() const
+{
+    return mSeed;
+}
+
+quint32 PerfectHash::tableSize() const
+{
+    return mTableSize;
+}
+
+const QList<int> &PerfectHash::slotIndexes() const
+{
+    return mSlotIndexes;
+}
+
+quint32 PerfectHash::hash(const QString &name, quint32 seed)
+{
+    auto result = seed ^ 2166136261u;
+
+    for (const auto oneCharacter : name) {
+        result ^= oneCharacter.unicode();
+        result *= 16777619u;
+    }
+
+    return result;
+}
+
+QString PerfectHash::hashFunctionSource(const QString &functionName)
+{
+    return QStringLiteral("quint32 %1(QStringView name, quint32 seed)\n"
+                          "{\n"
+                          "    auto result = seed ^ 2166136261u;\n"
+                          "\n"
+                          "    for (const auto oneCharacter : name) {\n"
+                          "        result ^= oneCharacter.unicode();\n"
+                          "        result *= 16777619u;\n"
+                          "    }\n"
+                          "\n"
+                          "    return result;\n"
+                          "}\n")
+        .arg(functionName);
+}
+
+bool PerfectHash::tryBuild(const QList<QString> &names)
+{
+    mSlotIndexes.fill(-1, mTableSize);
+
+    for (int i = 0; i < names.size(); ++i) {
+        auto &slot = mSlotIndexes[hash(names[i], mSeed) & (mTableSize - 1)];
+        if (slot != -1) {
+            return false;
+        }
+        slot = i;
+    }
+
+    return true;
+}
@@ -0,0 +1,50 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef PERFECTHASH_H
+#define PERFECTHASH_H
+
+#include <QList>
+#include <QString>
+
+/**
+ * @brief The PerfectHash class finds a seed for which a hash of a fixed set of names has no collision
+ *
+ * The hash is a seeded FNV-1a on the UTF-16 code units reduced to a power of two table size. The generated code
+ * contains the same function (see hashFunctionSource) so that the name of an action gives directly its slot.
+ */
+class PerfectHash
+{
+public:
+    explicit PerfectHash(const QList<QString> &names);
+
+    [[nodiscard]] quint32 seed() const;
+
+    [[nodiscard]] quint32 tableSize() const;
+
+    /**
+     * @brief slotIndexes gives for each slot of the table the index of the name stored in it or -1
+     */
+    [[nodiscard]] const QList<int> &slotIndexes() const;
+
+    [[nodiscard]] static quint32 hash(const QString &name, quint32 seed);
+
+    /**
+     * @brief hashFunctionSource is the C++ code of a function named functionName computing hash
+     */
+    [[nodiscard]] static QString hashFunctionSource(const QString &functionName);
+
+private:
+    bool tryBuild(const QList<QString> &names);
+
+    quint32 mSeed = 0;
+
+    quint32 mTableSize = 1;
+
+    QList<int> mSlotIndexes;
+};
+
+#endif // PERFECTHASH_H
@@ -0,0 +1,256 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "proxygenerator.h"
+
+#include "scpddocument.h"
+#include "upnpdatatype.h"
+
+#include <QSet>
+#include <QTextStream>
+
+namespace
+{
+
+QString resultMemberName(const QString &argumentName)
+{
+    const auto &identifier = cppIdentifier(argumentName);
+
+    if (identifier == QStringLiteral("Success") || identifier == QStringLiteral("Error")) {
+        return QStringLiteral("m") + identifier + QStringLiteral("Value");
+    }
+
+    return QStringLiteral("m") + identifier;
+}
+
+QString resultTypeName(const ScpdAction &action)
+{
+    return cppIdentifier(action.mName) + QStringLiteral("Result");
+}
+
+QString parameterList(const ScpdAction &action)
+{
+    QStringList parameters;
+
+    for (const auto &oneArgument : action.mInputArguments) {
+        const UpnpDataType dataType(oneArgument.mDataType);
+        auto parameterType = dataType.parameterType();
+        if (!parameterType.endsWith(QLatin1Char('&'))) {
+            parameterType += QLatin1Char(' ');
+        }
+        parameters.push_back(parameterType + lowerCamelCase(oneArgument.mName));
+    }
+
+    return parameters.join(QStringLiteral(", "));
+}
+
+QString defaultInitializer(const UpnpDataType &dataType)
+{
+    if (dataType.cppType() == QStringLiteral("bool")) {
+        return QStringLiteral(" = false");
+    }
+    if (dataType.includeName().isEmpty()) {
+        return QStringLiteral(" = 0");
+    }
+
+    return {};
+}
+
+}
+
+ProxyGenerator::ProxyGenerator(const ScpdDocument &document, const QString &className, const QString &serviceType)
+    : mDocument(document)
+    , mClassName(className)
+    , mServiceType(serviceType)
+{
+}
+
+QString ProxyGenerator::header(const QString &headerFileName) const
+{
+    QString result;
+    QTextStream output(&result);
+
+    const auto &includeGuard = headerFileName.toUpper().replace(QLatin1Char('.'), QLatin1Char('_')).replace(QLatin1Char('-'), QLatin1Char('_'));
+
+    output << "// This file is generated by upnpscpd2cpp. Do not edit.\n\n";
+    output << "#ifndef " << includeGuard << "\n";
+    output << "#define " << includeGuard << "\n\n";
+    output << "#include \"upnpcontrolabstractservice.h\"\n\n";
+
+    QSet<QString> includes;
+    for (const auto &oneAction : mDocument.mActions) {
+        for (const auto &oneArgument : oneAction.mInputArguments + oneAction.mOutputArguments) {
+            const UpnpDataType dataType(oneArgument.mDataType);
+            if (!dataType.includeName().isEmpty()) {
+                includes.insert(dataType.includeName());
+            }
+        }
+    }
+    includes.insert(QStringLiteral("QString"));
+
+    auto sortedIncludes = QStringList(includes.begin(), includes.end());
+    sortedIncludes.sort();
+    for (const auto &oneInclude : sortedIncludes) {
+        output << "#include <" << oneInclude << ">\n";
+    }
+    output << "\n#include <array>\n\n";
+
+    output << "class " << mClassName << " : public UpnpControlAbstractService\n";
+    output << "{\n";
+    output << "public:\n";
+
+    for (const auto &oneAction : mDocument.mActions) {
+        output << "    struct " << resultTypeName(oneAction) << " {\n";
+        output << "        bool mSuccess = false;\n\n";
+        output << "        QString mError;\n";
+        for (const auto &oneArgument : oneAction.mOutputArguments) {
+            const UpnpDataType dataType(oneArgument.mDataType);
+            output << "\n        " << dataType.cppType() << " " << resultMemberName(oneArgument.mName) << defaultInitializer(dataType) << ";\n";
+        }
+        output << "    };\n\n";
+    }
+
+    output << "    explicit " << mClassName << "(QObject *parent = nullptr);\n\n";
+
+    if (!mServiceType.isEmpty()) {
+        output << "    [[nodiscard]] static QString upnpServiceType();\n\n";
+    }
+
+    for (const auto &oneAction : mDocument.mActions) {
+        output << "    [[nodiscard]] UpnpControlAbstractServiceReply *" << lowerCamelCase(oneAction.mName) << "(" << parameterList(oneAction) << ");\n\n";
+        output << "    [[nodiscard]] static " << resultTypeName(oneAction) << " " << lowerCamelCase(oneAction.mName)
+               << "Result(const UpnpControlAbstractServiceReply *reply);\n\n";
+    }
+
+    output << "private:\n";
+    output << "    enum ActionId {\n";
+    for (const auto &oneAction : mDocument.mActions) {
+        output << "        " << cppIdentifier(oneAction.mName) << "Action,\n";
+    }
+    output << "        ActionsCount,\n";
+    output << "    };\n\n";
+    output << "    [[nodiscard]] UpnpControlAbstractServiceReply *invokeAction(ActionId action, const QList<QString> &inputValues);\n\n";
+    output << "    void resolveActionIndexes();\n\n";
+    output << "    std::array<int, ActionsCount> mActionIndexes;\n\n";
+    output << "    bool mActionIndexesResolved = false;\n";
+    output << "};\n\n";
+    output << "#endif // " << includeGuard << "\n";
+
+    return result;
+}
+
+QString ProxyGenerator::source(const QString &headerFileName) const
+{
+    QString result;
+    QTextStream output(&result);
+
+    output << "// This file is generated by upnpscpd2cpp. Do not edit.\n\n";
+    output << "#include \"" << headerFileName << "\"\n\n";
+    output << "#include <QVariant>\n\n";
+
+    output << "namespace\n{\n\n";
+    output << "struct GeneratedActionSignature {\n";
+    output << "    QString mName;\n\n";
+    output << "    QList<QString> mInputArguments;\n";
+    output << "};\n\n";
+    output << "const std::array<GeneratedActionSignature, " << mDocument.mActions.size() << "> &generatedActions()\n";
+    output << "{\n";
+    output << "    static const std::array<GeneratedActionSignature, " << mDocument.mActions.size() << "> actions = {{\n";
+    for (const auto &oneAction : mDocument.mActions) {
+        output << "        {QStringLiteral(\"" << oneAction.mName << "\"), {";
+        QStringList argumentNames;
+        for (const auto &oneArgument : oneAction.mInputArguments) {
+            argumentNames.push_back(QStringLiteral("QStringLiteral(\"") + oneArgument.mName + QStringLiteral("\")"));
+        }
+        output << argumentNames.join(QStringLiteral(", ")) << "}},\n";
+    }
+    output << "    }};\n\n";
+    output << "    return actions;\n";
+    output << "}\n\n";
+    output << "}\n\n";
+
+    output << mClassName << "::" << mClassName << "(QObject *parent)\n";
+    output << "    : UpnpControlAbstractService(parent)\n";
+    output << "{\n";
+    output << "    mActionIndexes.fill(-1);\n\n";
+    output << "    connect(this, &UpnpControlAbstractService::serviceDescriptionLoaded, this, [this]() {\n";
+    output << "        mActionIndexesResolved = false;\n";
+    output << "    });\n";
+    output << "    connect(this, &UpnpAbstractService::descriptionChanged, this, [this]() {\n";
+    output << "        mActionIndexesResolved = false;\n";
+    output << "    });\n";
+    output << "}\n\n";
+
+    if (!mServiceType.isEmpty()) {
+        output << "QString " << mClassName << "::upnpServiceType()\n";
+        output << "{\n";
+        output << "    return QStringLiteral(\"" << mServiceType << "\");\n";
+        output << "}\n\n";
+    }
+
+    for (const auto &oneAction : mDocument.mActions) {
+        const auto &methodName = lowerCamelCase(oneAction.mName);
+
+        output << "UpnpControlAbstractServiceReply *" << mClassName << "::" << methodName << "(" << parameterList(oneAction) << ")\n";
+        output << "{\n";
+        if (oneAction.mInputArguments.isEmpty()) {
+            output << "    return invokeAction(" << cppIdentifier(oneAction.mName) << "Action, {});\n";
+        } else {
+            output << "    return invokeAction(" << cppIdentifier(oneAction.mName) << "Action, {\n";
+            for (const auto &oneArgument : oneAction.mInputArguments) {
+                const UpnpDataType dataType(oneArgument.mDataType);
+                output << "        " << dataType.toSoap(lowerCamelCase(oneArgument.mName)) << ",\n";
+            }
+            output << "    });\n";
+        }
+        output << "}\n\n";
+
+        output << mClassName << "::" << resultTypeName(oneAction) << " " << mClassName << "::" << methodName
+               << "Result(const UpnpControlAbstractServiceReply *reply)\n";
+        output << "{\n";
+        output << "    " << resultTypeName(oneAction) << " result;\n\n";
+        output << "    result.mSuccess = reply->success();\n";
+        output << "    result.mError = reply->error();\n";
+        if (!oneAction.mOutputArguments.isEmpty()) {
+            output << "\n    const auto &values = reply->result();\n";
+            for (const auto &oneArgument : oneAction.mOutputArguments) {
+                const UpnpDataType dataType(oneArgument.mDataType);
+                const auto &valueName = lowerCamelCase(oneArgument.mName) + QStringLiteral("Value");
+                output << "\n    const auto " << valueName << " = values.value(QStringLiteral(\"" << oneArgument.mName << "\")).toString();\n";
+                output << "    result." << resultMemberName(oneArgument.mName) << " = " << dataType.fromSoap(valueName) << ";\n";
+            }
+        }
+        output << "\n    return result;\n";
+        output << "}\n\n";
+    }
+
+    output << "UpnpControlAbstractServiceReply *" << mClassName << "::invokeAction(ActionId action, const QList<QString> &inputValues)\n";
+    output << "{\n";
+    output << "    const auto &signature = generatedActions()[action];\n\n";
+    output << "    if (isServiceDescriptionLoaded()) {\n";
+    output << "        if (!mActionIndexesResolved) {\n";
+    output << "            resolveActionIndexes();\n";
+    output << "        }\n\n";
+    output << "        if (mActionIndexes[action] != -1) {\n";
+    output << "            return callSerializedAction(mActionIndexes[action], inputValues);\n";
+    output << "        }\n";
+    output << "    }\n\n";
+    output << "    // the actions of the service are not known yet, the call waits for the service description\n";
+    output << "    return callSerializedAction(signature.mName, signature.mInputArguments, inputValues);\n";
+    output << "}\n\n";
+
+    output << "void " << mClassName << "::resolveActionIndexes()\n";
+    output << "{\n";
+    output << "    const auto &actions = generatedActions();\n\n";
+    output << "    for (std::size_t i = 0; i < actions.size(); ++i) {\n";
+    output << "        const auto index = actionIndex(actions[i].mName);\n";
+    output << "        mActionIndexes[i] = (index != -1 && actionInputArguments(index) == actions[i].mInputArguments) ? index : -1;\n";
+    output << "    }\n\n";
+    output << "    mActionIndexesResolved = true;\n";
+    output << "}\n";
+
+    return result;
+}
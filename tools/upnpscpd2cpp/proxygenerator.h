@@ -0,0 +1,37 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef PROXYGENERATOR_H
+#define PROXYGENERATOR_H
+
+#include <QString>
+
+class ScpdDocument;
+
+/**
+ * @brief The ProxyGenerator class writes a typed client proxy deriving from UpnpControlAbstractService
+ *
+ * Each action of the SCPD becomes a method with one typed parameter per input argument, in the order of the SCPD,
+ * and a result structure with one typed member per output argument.
+ */
+class ProxyGenerator
+{
+public:
+    ProxyGenerator(const ScpdDocument &document, const QString &className, const QString &serviceType);
+
+    [[nodiscard]] QString header(const QString &headerFileName) const;
+
+    [[nodiscard]] QString source(const QString &headerFileName) const;
+
+private:
+    const ScpdDocument &mDocument;
+
+    QString mClassName;
+
+    QString mServiceType;
+};
+
+#endif // PROXYGENERATOR_H
@@ -0,0 +1,80 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "scpddocument.h"
+
+#include <QDomDocument>
+
+bool ScpdDocument::parse(const QByteArray &content, QString &errorMessage)
+{
+    QDomDocument scpdDocument;
+
+    QString parseError;
+    int errorLine = 0;
+    if (!scpdDocument.setContent(content, &parseError, &errorLine)) {
+        errorMessage = QStringLiteral("line %1: %2").arg(errorLine).arg(parseError);
+        return false;
+    }
+
+    const QDomElement &scpdRoot = scpdDocument.documentElement();
+    if (scpdRoot.tagName() != QStringLiteral("scpd")) {
+        errorMessage = QStringLiteral("the root element is not scpd");
+        return false;
+    }
+
+    const QDomElement &serviceStateTableRoot = scpdRoot.firstChildElement(QStringLiteral("serviceStateTable"));
+    QDomElement stateVariableNode = serviceStateTableRoot.firstChildElement(QStringLiteral("stateVariable"));
+    while (!stateVariableNode.isNull()) {
+        ScpdStateVariable newStateVariable;
+        newStateVariable.mName = stateVariableNode.firstChildElement(QStringLiteral("name")).text().trimmed();
+        newStateVariable.mDataType = stateVariableNode.firstChildElement(QStringLiteral("dataType")).text().trimmed();
+        newStateVariable.mEvented = stateVariableNode.attribute(QStringLiteral("sendEvents"), QStringLiteral("yes")) == QStringLiteral("yes");
+
+        mStateVariables[newStateVariable.mName] = newStateVariable;
+
+        stateVariableNode = stateVariableNode.nextSiblingElement(QStringLiteral("stateVariable"));
+    }
+
+    const QDomElement &actionListRoot = scpdRoot.firstChildElement(QStringLiteral("actionList"));
+    QDomElement actionNode = actionListRoot.firstChildElement(QStringLiteral("action"));
+    while (!actionNode.isNull()) {
+        ScpdAction newAction;
+        newAction.mName = actionNode.firstChildElement(QStringLiteral("name")).text().trimmed();
+
+        const QDomElement &argumentListNode = actionNode.firstChildElement(QStringLiteral("argumentList"));
+        QDomElement argumentNode = argumentListNode.firstChildElement(QStringLiteral("argument"));
+        while (!argumentNode.isNull()) {
+            ScpdArgument newArgument;
+            newArgument.mName = argumentNode.firstChildElement(QStringLiteral("name")).text().trimmed();
+            newArgument.mIsInput = argumentNode.firstChildElement(QStringLiteral("direction")).text().trimmed() == QStringLiteral("in");
+            newArgument.mRelatedStateVariable = argumentNode.firstChildElement(QStringLiteral("relatedStateVariable")).text().trimmed();
+            newArgument.mDataType = mStateVariables.value(newArgument.mRelatedStateVariable, {QString{}, QStringLiteral("string"), false}).mDataType;
+
+            if (newArgument.mIsInput) {
+                newAction.mInputArguments.push_back(newArgument);
+            } else {
+                newAction.mOutputArguments.push_back(newArgument);
+            }
+
+            argumentNode = argumentNode.nextSiblingElement(QStringLiteral("argument"));
+        }
+
+        if (!newAction.mName.isEmpty()) {
+            for (const auto &oneAction : std::as_const(mActions)) {
+                if (oneAction.mName == newAction.mName) {
+                    errorMessage = QStringLiteral("the action %1 is declared twice").arg(newAction.mName);
+                    return false;
+                }
+            }
+
+            mActions.push_back(newAction);
+        }
+
+        actionNode = actionNode.nextSiblingElement(QStringLiteral("action"));
+    }
+
+    return true;
+}
@@ -0,0 +1,70 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef SCPDDOCUMENT_H
+#define SCPDDOCUMENT_H
+
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+#include <QString>
+
+class ScpdStateVariable
+{
+public:
+    QString mName;
+
+    QString mDataType;
+
+    bool mEvented = true;
+};
+
+class ScpdArgument
+{
+public:
+    QString mName;
+
+    bool mIsInput = true;
+
+    QString mRelatedStateVariable;
+
+    /**
+     * @brief mDataType is the data type of the related state variable or string if it is unknown
+     */
+    QString mDataType;
+};
+
+class ScpdAction
+{
+public:
+    QString mName;
+
+    QList<ScpdArgument> mInputArguments;
+
+    QList<ScpdArgument> mOutputArguments;
+};
+
+/**
+ * @brief The ScpdDocument class is the content of a service description (SCPD) document used by the generators
+ */
+class ScpdDocument
+{
+public:
+    /**
+     * @brief parse will read an SCPD document
+     *
+     * @param content is the XML document
+     * @param errorMessage receives a description of the error if the document cannot be read
+     * @return true if the document was read
+     */
+    bool parse(const QByteArray &content, QString &errorMessage);
+
+    QList<ScpdAction> mActions;
+
+    QMap<QString, ScpdStateVariable> mStateVariables;
+};
+
+#endif // SCPDDOCUMENT_H
@@ -0,0 +1,287 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "skeletongenerator.h"
+
+#include "perfecthash.h"
+#include "scpddocument.h"
+#include "upnpdatatype.h"
+
+#include <QSet>
+#include <QTextStream>
+
+namespace
+{
+
+QString inputParameterName(const ScpdArgument &argument)
+{
+    return lowerCamelCase(argument.mName);
+}
+
+QString outputParameterName(const ScpdAction &action, const ScpdArgument &argument)
+{
+    auto result = lowerCamelCase(argument.mName);
+
+    for (const auto &oneArgument : action.mInputArguments) {
+        if (inputParameterName(oneArgument) == result) {
+            result += QStringLiteral("Out");
+            break;
+        }
+    }
+
+    return result;
+}
+
+QString handlerParameterList(const ScpdAction &action)
+{
+    QStringList parameters;
+
+    for (const auto &oneArgument : action.mInputArguments) {
+        const UpnpDataType dataType(oneArgument.mDataType);
+        auto parameterType = dataType.parameterType();
+        if (!parameterType.endsWith(QLatin1Char('&'))) {
+            parameterType += QLatin1Char(' ');
+        }
+        parameters.push_back(parameterType + inputParameterName(oneArgument));
+    }
+
+    for (const auto &oneArgument : action.mOutputArguments) {
+        const UpnpDataType dataType(oneArgument.mDataType);
+        parameters.push_back(dataType.cppType() + QStringLiteral(" &") + outputParameterName(action, oneArgument));
+    }
+
+    return parameters.join(QStringLiteral(", "));
+}
+
+QString dispatcherName(const ScpdAction &action)
+{
+    return QStringLiteral("dispatch") + cppIdentifier(action.mName);
+}
+
+QString defaultInitializer(const UpnpDataType &dataType)
+{
+    if (dataType.cppType() == QStringLiteral("bool")) {
+        return QStringLiteral(" = false");
+    }
+    if (dataType.includeName().isEmpty()) {
+        return QStringLiteral(" = 0");
+    }
+
+    return {};
+}
+
+QString utf16Literal(const QString &value)
+{
+    return QStringLiteral("u\"") + value + QStringLiteral("\"");
+}
+
+}
+
+SkeletonGenerator::SkeletonGenerator(const ScpdDocument &document, const QString &className, const QString &serviceType)
+    : mDocument(document)
+    , mClassName(className)
+    , mServiceType(serviceType)
+{
+}
+
+QString SkeletonGenerator::header(const QString &headerFileName) const
+{
+    QString result;
+    QTextStream output(&result);
+
+    const auto &includeGuard = headerFileName.toUpper().replace(QLatin1Char('.'), QLatin1Char('_')).replace(QLatin1Char('-'), QLatin1Char('_'));
+
+    output << "// This file is generated by upnpscpd2cpp. Do not edit.\n\n";
+    output << "#ifndef " << includeGuard << "\n";
+    output << "#define " << includeGuard << "\n\n";
+    output << "#include \"upnpabstractservice.h\"\n\n";
+
+    QSet<QString> includes;
+    for (const auto &oneAction : mDocument.mActions) {
+        for (const auto &oneArgument : oneAction.mInputArguments + oneAction.mOutputArguments) {
+            const UpnpDataType dataType(oneArgument.mDataType);
+            if (!dataType.includeName().isEmpty()) {
+                includes.insert(dataType.includeName());
+            }
+        }
+    }
+    includes.insert(QStringLiteral("QList"));
+    includes.insert(QStringLiteral("QPair"));
+    includes.insert(QStringLiteral("QString"));
+    includes.insert(QStringLiteral("QStringView"));
+
+    auto sortedIncludes = QStringList(includes.begin(), includes.end());
+    sortedIncludes.sort();
+    for (const auto &oneInclude : sortedIncludes) {
+        output << "#include <" << oneInclude << ">\n";
+    }
+    output << "\n";
+
+    output << "class " << mClassName << " : public UpnpAbstractService\n";
+    output << "{\n";
+    output << "public:\n";
+    output << "    explicit " << mClassName << "(QObject *parent = nullptr);\n\n";
+    output << "    [[nodiscard]] bool dispatchAction(const QString &actionName,\n";
+    output << "                                      const QList<QPair<QString, QString>> &inputArguments,\n";
+    output << "                                      QList<QPair<QString, QString>> &outputArguments) override;\n\n";
+
+    output << "protected:\n";
+    for (const auto &oneAction : mDocument.mActions) {
+        output << "    virtual bool " << lowerCamelCase(oneAction.mName) << "(" << handlerParameterList(oneAction) << ") = 0;\n\n";
+    }
+
+    output << "private:\n";
+    output << "    using ActionDispatcher = bool (" << mClassName
+           << "::*)(const QList<QPair<QString, QString>> &inputArguments, QList<QPair<QString, QString>> &outputArguments);\n\n";
+    output << "    struct DispatchEntry {\n";
+    output << "        QStringView mName;\n\n";
+    output << "        ActionDispatcher mDispatcher;\n";
+    output << "    };\n\n";
+    for (const auto &oneAction : mDocument.mActions) {
+        output << "    bool " << dispatcherName(oneAction)
+               << "(const QList<QPair<QString, QString>> &inputArguments, QList<QPair<QString, QString>> &outputArguments);\n\n";
+    }
+    output << "    void addGeneratedDescription();\n";
+    output << "};\n\n";
+    output << "#endif // " << includeGuard << "\n";
+
+    return result;
+}
+
+QString SkeletonGenerator::source(const QString &headerFileName) const
+{
+    QString result;
+    QTextStream output(&result);
+
+    QList<QString> actionNames;
+    for (const auto &oneAction : mDocument.mActions) {
+        actionNames.push_back(oneAction.mName);
+    }
+    const PerfectHash actionHash(actionNames);
+
+    output << "// This file is generated by upnpscpd2cpp. Do not edit.\n\n";
+    output << "#include \"" << headerFileName << "\"\n\n";
+    output << "#include \"upnpactiondescription.h\"\n";
+    output << "#include \"upnpservicedescription.h\"\n";
+    output << "#include \"upnpstatevariabledescription.h\"\n\n";
+    output << "#include <array>\n\n";
+
+    output << "namespace\n{\n\n";
+    output << PerfectHash::hashFunctionSource(QStringLiteral("actionNameHash")) << "\n";
+    output << "}\n\n";
+
+    output << mClassName << "::" << mClassName << "(QObject *parent)\n";
+    output << "    : UpnpAbstractService(parent)\n";
+    output << "{\n";
+    output << "    addGeneratedDescription();\n";
+    output << "}\n\n";
+
+    output << "bool " << mClassName << "::dispatchAction(const QString &actionName,\n";
+    output << "    const QList<QPair<QString, QString>> &inputArguments,\n";
+    output << "    QList<QPair<QString, QString>> &outputArguments)\n";
+    output << "{\n";
+    output << "    static constexpr quint32 hashSeed = " << actionHash.seed() << "u;\n\n";
+    output << "    static constexpr std::array<DispatchEntry, " << actionHash.tableSize() << "> dispatchTable = {{\n";
+    for (const auto oneSlot : actionHash.slotIndexes()) {
+        if (oneSlot == -1) {
+            output << "        {{}, nullptr},\n";
+        } else {
+            const auto &oneAction = mDocument.mActions[oneSlot];
+            output << "        {" << utf16Literal(oneAction.mName) << ", &" << mClassName << "::" << dispatcherName(oneAction) << "},\n";
+        }
+    }
+    output << "    }};\n\n";
+    output << "    const auto &entry = dispatchTable[actionNameHash(actionName, hashSeed) & " << (actionHash.tableSize() - 1) << "u];\n";
+    output << "    if (!entry.mDispatcher || entry.mName != actionName) {\n";
+    output << "        return false;\n";
+    output << "    }\n\n";
+    output << "    return (this->*entry.mDispatcher)(inputArguments, outputArguments);\n";
+    output << "}\n\n";
+
+    for (const auto &oneAction : mDocument.mActions) {
+        output << "bool " << mClassName << "::" << dispatcherName(oneAction)
+               << "(const QList<QPair<QString, QString>> &inputArguments, QList<QPair<QString, QString>> &outputArguments)\n";
+        output << "{\n";
+
+        output << "    if (inputArguments.size() != " << oneAction.mInputArguments.size();
+        for (int i = 0; i < oneAction.mInputArguments.size(); ++i) {
+            output << "\n        || inputArguments[" << i << "].first != QStringView(" << utf16Literal(oneAction.mInputArguments[i].mName) << ")";
+        }
+        output << ") {\n";
+        output << "        return false;\n";
+        output << "    }\n\n";
+
+        for (const auto &oneArgument : oneAction.mOutputArguments) {
+            const UpnpDataType dataType(oneArgument.mDataType);
+            output << "    " << dataType.cppType() << " " << outputParameterName(oneAction, oneArgument) << defaultInitializer(dataType) << ";\n";
+        }
+        if (!oneAction.mOutputArguments.isEmpty()) {
+            output << "\n";
+        }
+
+        QStringList callArguments;
+        for (int i = 0; i < oneAction.mInputArguments.size(); ++i) {
+            const UpnpDataType dataType(oneAction.mInputArguments[i].mDataType);
+            callArguments.push_back(dataType.fromSoap(QStringLiteral("inputArguments[%1].second").arg(i)));
+        }
+        for (const auto &oneArgument : oneAction.mOutputArguments) {
+            callArguments.push_back(outputParameterName(oneAction, oneArgument));
+        }
+
+        output << "    if (!" << lowerCamelCase(oneAction.mName) << "(" << callArguments.join(QStringLiteral(", ")) << ")) {\n";
+        output << "        return false;\n";
+        output << "    }\n\n";
+
+        if (oneAction.mOutputArguments.isEmpty()) {
+            output << "    Q_UNUSED(outputArguments)\n\n";
+        } else {
+            output << "    outputArguments.reserve(" << oneAction.mOutputArguments.size() << ");\n";
+            for (const auto &oneArgument : oneAction.mOutputArguments) {
+                const UpnpDataType dataType(oneArgument.mDataType);
+                output << "    outputArguments.push_back({QStringLiteral(\"" << oneArgument.mName << "\"), "
+                       << dataType.toSoap(outputParameterName(oneAction, oneArgument)) << "});\n";
+            }
+            output << "\n";
+        }
+
+        output << "    return true;\n";
+        output << "}\n\n";
+    }
+
+    output << "void " << mClassName << "::addGeneratedDescription()\n";
+    output << "{\n";
+    if (!mServiceType.isEmpty()) {
+        output << "    description().setServiceType(QStringLiteral(\"" << mServiceType << "\"));\n\n";
+    }
+    for (const auto &oneStateVariable : mDocument.mStateVariables) {
+        output << "    {\n";
+        output << "        UpnpStateVariableDescription newStateVariable;\n";
+        output << "        newStateVariable.mIsValid = true;\n";
+        output << "        newStateVariable.mUpnpName = QStringLiteral(\"" << oneStateVariable.mName << "\");\n";
+        output << "        newStateVariable.mDataType = QStringLiteral(\"" << oneStateVariable.mDataType << "\");\n";
+        output << "        newStateVariable.mType = UpnpStateVariableDescription::typeFromDataType(newStateVariable.mDataType);\n";
+        output << "        newStateVariable.mEvented = " << (oneStateVariable.mEvented ? "true" : "false") << ";\n";
+        output << "        addStateVariable(newStateVariable);\n";
+        output << "    }\n\n";
+    }
+    for (const auto &oneAction : mDocument.mActions) {
+        output << "    {\n";
+        output << "        UpnpActionDescription newAction;\n";
+        output << "        newAction.mIsValid = true;\n";
+        output << "        newAction.mName = QStringLiteral(\"" << oneAction.mName << "\");\n";
+        output << "        newAction.mNumberInArgument = " << oneAction.mInputArguments.size() << ";\n";
+        output << "        newAction.mNumberOutArgument = " << oneAction.mOutputArguments.size() << ";\n";
+        for (const auto &oneArgument : oneAction.mInputArguments + oneAction.mOutputArguments) {
+            output << "        newAction.mArguments.push_back({true, QStringLiteral(\"" << oneArgument.mName << "\"), UpnpArgumentDirection::"
+                   << (oneArgument.mIsInput ? "In" : "Out") << ", false, QStringLiteral(\"" << oneArgument.mRelatedStateVariable << "\")});\n";
+        }
+        output << "        addAction(newAction);\n";
+        output << "    }\n\n";
+    }
+    output << "}\n";
+
+    return result;
+}
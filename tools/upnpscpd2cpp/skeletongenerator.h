@@ -0,0 +1,37 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef SKELETONGENERATOR_H
+#define SKELETONGENERATOR_H
+
+#include <QString>
+
+class ScpdDocument;
+
+/**
+ * @brief The SkeletonGenerator class writes an abstract server side service deriving from UpnpAbstractService
+ *
+ * Each action of the SCPD becomes a pure virtual method with typed input parameters and typed output references.
+ * The action names are dispatched through a perfect hash table computed when the code is generated.
+ */
+class SkeletonGenerator
+{
+public:
+    SkeletonGenerator(const ScpdDocument &document, const QString &className, const QString &serviceType);
+
+    [[nodiscard]] QString header(const QString &headerFileName) const;
+
+    [[nodiscard]] QString source(const QString &headerFileName) const;
+
+private:
+    const ScpdDocument &mDocument;
+
+    QString mClassName;
+
+    QString mServiceType;
+};
+
+#endif // SKELETONGENERATOR_H
@@ -0,0 +1,228 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#include "upnpdatatype.h"
+
+#include <QSet>
+
+UpnpDataType::UpnpDataType(const QString &upnpDataType)
+    : mUpnpType(upnpDataType.isEmpty() ? QStringLiteral("string") : upnpDataType)
+{
+    if (mUpnpType == QStringLiteral("ui1")) {
+        mCppType = QStringLiteral("quint8");
+    } else if (mUpnpType == QStringLiteral("ui2")) {
+        mCppType = QStringLiteral("quint16");
+    } else if (mUpnpType == QStringLiteral("ui4")) {
+        mCppType = QStringLiteral("quint32");
+    } else if (mUpnpType == QStringLiteral("ui8")) {
+        mCppType = QStringLiteral("quint64");
+    } else if (mUpnpType == QStringLiteral("i1")) {
+        mCppType = QStringLiteral("qint8");
+    } else if (mUpnpType == QStringLiteral("i2")) {
+        mCppType = QStringLiteral("qint16");
+    } else if (mUpnpType == QStringLiteral("i4") || mUpnpType == QStringLiteral("int")) {
+        mCppType = QStringLiteral("qint32");
+    } else if (mUpnpType == QStringLiteral("i8")) {
+        mCppType = QStringLiteral("qint64");
+    } else if (mUpnpType == QStringLiteral("r4")) {
+        mCppType = QStringLiteral("float");
+    } else if (mUpnpType == QStringLiteral("r8") || mUpnpType == QStringLiteral("number") || mUpnpType == QStringLiteral("float")
+               || mUpnpType == QStringLiteral("fixed.14.4")) {
+        mCppType = QStringLiteral("double");
+    } else if (mUpnpType == QStringLiteral("boolean")) {
+        mCppType = QStringLiteral("bool");
+    } else if (mUpnpType == QStringLiteral("char")) {
+        mCppType = QStringLiteral("QChar");
+        mIncludeName = QStringLiteral("QChar");
+    } else if (mUpnpType == QStringLiteral("date")) {
+        mCppType = QStringLiteral("QDate");
+        mIncludeName = QStringLiteral("QDate");
+    } else if (mUpnpType == QStringLiteral("dateTime") || mUpnpType == QStringLiteral("dateTime.tz")) {
+        mCppType = QStringLiteral("QDateTime");
+        mIncludeName = QStringLiteral("QDateTime");
+    } else if (mUpnpType == QStringLiteral("time") || mUpnpType == QStringLiteral("time.tz")) {
+        mCppType = QStringLiteral("QTime");
+        mIncludeName = QStringLiteral("QTime");
+    } else if (mUpnpType == QStringLiteral("bin.base64") || mUpnpType == QStringLiteral("bin.hex")) {
+        mCppType = QStringLiteral("QByteArray");
+        mIncludeName = QStringLiteral("QByteArray");
+    } else if (mUpnpType == QStringLiteral("uri")) {
+        mCppType = QStringLiteral("QUrl");
+        mIncludeName = QStringLiteral("QUrl");
+    } else {
+        mCppType = QStringLiteral("QString");
+        mIncludeName = QStringLiteral("QString");
+    }
+
+    mIsPassedByValue = mIncludeName.isEmpty() || mCppType == QStringLiteral("QChar");
+}
+
+const QString &UpnpDataType::cppType() const
+{
+    return mCppType;
+}
+
+QString UpnpDataType::parameterType() const
+{
+    if (mIsPassedByValue) {
+        return mCppType;
+    }
+
+    return QStringLiteral("const ") + mCppType + QStringLiteral(" &");
+}
+
+const QString &UpnpDataType::includeName() const
+{
+    return mIncludeName;
+}
+
+QString UpnpDataType::toSoap(const QString &valueExpression) const
+{
+    if (mCppType == QStringLiteral("bool")) {
+        return QStringLiteral("(%1 ? QStringLiteral(\"1\") : QStringLiteral(\"0\"))").arg(valueExpression);
+    }
+    if (mCppType == QStringLiteral("float")) {
+        return QStringLiteral("QString::number(%1, 'g', 9)").arg(valueExpression);
+    }
+    if (mCppType == QStringLiteral("double")) {
+        return QStringLiteral("QString::number(%1, 'g', 17)").arg(valueExpression);
+    }
+    if (mIncludeName.isEmpty()) {
+        return QStringLiteral("QString::number(%1)").arg(valueExpression);
+    }
+    if (mCppType == QStringLiteral("QChar")) {
+        return QStringLiteral("QString(%1)").arg(valueExpression);
+    }
+    if (mCppType == QStringLiteral("QDate") || mCppType == QStringLiteral("QDateTime") || mCppType == QStringLiteral("QTime")) {
+        return QStringLiteral("%1.toString(Qt::ISODate)").arg(valueExpression);
+    }
+    if (mUpnpType == QStringLiteral("bin.base64")) {
+        return QStringLiteral("QString::fromLatin1(%1.toBase64())").arg(valueExpression);
+    }
+    if (mUpnpType == QStringLiteral("bin.hex")) {
+        return QStringLiteral("QString::fromLatin1(%1.toHex())").arg(valueExpression);
+    }
+    if (mCppType == QStringLiteral("QUrl")) {
+        return QStringLiteral("%1.toString()").arg(valueExpression);
+    }
+
+    return valueExpression;
+}
+
+QString UpnpDataType::fromSoap(const QString &stringExpression) const
+{
+    if (mCppType == QStringLiteral("bool")) {
+        return QStringLiteral("(%1 == QStringLiteral(\"1\") || %1.compare(QStringLiteral(\"true\"), Qt::CaseInsensitive) == 0 || %1.compare(QStringLiteral(\"yes\"), Qt::CaseInsensitive) == 0)").arg(stringExpression);
+    }
+    if (mCppType == QStringLiteral("quint8")) {
+        return QStringLiteral("static_cast<quint8>(%1.toUShort())").arg(stringExpression);
+    }
+    if (mCppType == QStringLiteral("quint16")) {
+        return QStringLiteral("%1.toUShort()").arg(stringExpression);
+    }
+    if (mCppType == QStringLiteral("quint32")) {
+        return QStringLiteral("%1.toUInt()").arg(stringExpression);
+    }
+    if (mCppType == QStringLiteral("quint64")) {
+        return QStringLiteral("%1.toULongLong()").arg(stringExpression);
+    }
+    if (mCppType == QStringLiteral("qint8")) {
+        return QStringLiteral("static_cast<qint8>(%1.toShort())").arg(stringExpression);
+    }
+    if (mCppType == QStringLiteral("qint16")) {
+        return QStringLiteral("%1.toShort()").arg(stringExpression);
+    }
+    if (mCppType == QStringLiteral("qint32")) {
+        return QStringLiteral("%1.toInt()").arg(stringExpression);
+    }
+    if (mCppType == QStringLiteral("qint64")) {
+        return QStringLiteral("%1.toLongLong()").arg(stringExpression);
+    }
+    if (mCppType == QStringLiteral("float")) {
+        return QStringLiteral("%1.toFloat()").arg(stringExpression);
+    }
+    if (mCppType == QStringLiteral("double")) {
+        return QStringLiteral("%1.toDouble()").arg(stringExpression);
+    }
+    if (mCppType == QStringLiteral("QChar")) {
+        return QStringLiteral("(%1.isEmpty() ? QChar() : %1.at(0))").arg(stringExpression);
+    }
+    if (mCppType == QStringLiteral("QDate") || mCppType == QStringLiteral("QDateTime") || mCppType == QStringLiteral("QTime")) {
+        return QStringLiteral("%1::fromString(%2, Qt::ISODate)").arg(mCppType, stringExpression);
+    }
+    if (mUpnpType == QStringLiteral("bin.base64")) {
+        return QStringLiteral("QByteArray::fromBase64(%1.toLatin1())").arg(stringExpression);
+    }
+    if (mUpnpType == QStringLiteral("bin.hex")) {
+        return QStringLiteral("QByteArray::fromHex(%1.toLatin1())").arg(stringExpression);
+    }
+    if (mCppType == QStringLiteral("QUrl")) {
+        return QStringLiteral("QUrl(%1)").arg(stringExpression);
+    }
+
+    return stringExpression;
+}
+
+bool UpnpDataType::isPassedByValue() const
+{
+    return mIsPassedByValue;
+}
+
+QString cppIdentifier(const QString &name)
+{
+    static const QSet<QString> reservedWords = {
+        QStringLiteral("auto"), QStringLiteral("bool"), QStringLiteral("break"), QStringLiteral("case"), QStringLiteral("char"),
+        QStringLiteral("class"), QStringLiteral("const"), QStringLiteral("default"), QStringLiteral("delete"), QStringLiteral("do"),
+        QStringLiteral("double"), QStringLiteral("else"), QStringLiteral("enum"), QStringLiteral("float"), QStringLiteral("for"),
+        QStringLiteral("if"), QStringLiteral("int"), QStringLiteral("long"), QStringLiteral("new"), QStringLiteral("private"),
+        QStringLiteral("protected"), QStringLiteral("public"), QStringLiteral("return"), QStringLiteral("short"), QStringLiteral("signals"),
+        QStringLiteral("slots"), QStringLiteral("static"), QStringLiteral("struct"), QStringLiteral("switch"), QStringLiteral("this"),
+        QStringLiteral("template"), QStringLiteral("union"), QStringLiteral("unsigned"), QStringLiteral("virtual"), QStringLiteral("void"),
+        QStringLiteral("while"),
+    };
+
+    QString result;
+    result.reserve(name.size() + 1);
+
+    for (const auto oneCharacter : name) {
+        if ((oneCharacter >= QLatin1Char('a') && oneCharacter <= QLatin1Char('z')) || (oneCharacter >= QLatin1Char('A') && oneCharacter <= QLatin1Char('Z'))
+            || (oneCharacter >= QLatin1Char('0') && oneCharacter <= QLatin1Char('9')) || oneCharacter == QLatin1Char('_')) {
+            result.push_back(oneCharacter);
+        } else {
+            result.push_back(QLatin1Char('_'));
+        }
+    }
+
+    if (result.isEmpty() || result.front().isDigit()) {
+        result.prepend(QLatin1Char('_'));
+    }
+
+    if (reservedWords.contains(result)) {
+        result.push_back(QLatin1Char('_'));
+    }
+
+    return result;
+}
+
+QString lowerCamelCase(const QString &name)
+{
+    auto result = cppIdentifier(name);
+
+    int upperCaseCount = 0;
+    while (upperCaseCount < result.size() && result.at(upperCaseCount).isUpper()) {
+        ++upperCaseCount;
+    }
+
+    if (upperCaseCount > 1 && upperCaseCount < result.size()) {
+        --upperCaseCount;
+    }
+
+    for (int i = 0; i < upperCaseCount; ++i) {
+        result[i] = result.at(i).toLower();
+    }
+
+    return cppIdentifier(result);
+}
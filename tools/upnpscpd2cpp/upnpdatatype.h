@@ -0,0 +1,70 @@
+/*
+   SPDX-FileCopyrightText: 2026 (c) Matthieu Gallien <matthieu_gallien@yahoo.fr>
+
+   SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+
+#ifndef UPNPDATATYPE_H
+#define UPNPDATATYPE_H
+
+#include <QString>
+
+/**
+ * @brief The UpnpDataType class gives the C++ type and the conversions generated for one UPnP data type
+ */
+class UpnpDataType
+{
+public:
+    explicit UpnpDataType(const QString &upnpDataType);
+
+    /**
+     * @brief cppType is the C++ type used for values of this data type
+     */
+    [[nodiscard]] const QString &cppType() const;
+
+    /**
+     * @brief parameterType is the type used to pass values of this data type as argument
+     */
+    [[nodiscard]] QString parameterType() const;
+
+    /**
+     * @brief includeName is the header needed by cppType or an empty string
+     */
+    [[nodiscard]] const QString &includeName() const;
+
+    /**
+     * @brief toSoap returns an expression converting the C++ value to the QString sent in SOAP messages
+     */
+    [[nodiscard]] QString toSoap(const QString &valueExpression) const;
+
+    /**
+     * @brief fromSoap returns an expression converting a QString received in SOAP messages to the C++ value
+     */
+    [[nodiscard]] QString fromSoap(const QString &stringExpression) const;
+
+    /**
+     * @brief isPassedByValue is true for scalar types
+     */
+    [[nodiscard]] bool isPassedByValue() const;
+
+private:
+    QString mUpnpType;
+
+    QString mCppType;
+
+    QString mIncludeName;
+
+    bool mIsPassedByValue = false;
+};
+
+/**
+ * @brief cppIdentifier returns name with every character that cannot be used in a C++ identifier replaced
+ */
+[[nodiscard]] QString cppIdentifier(const QString &name);
+
+/**
+ * @brief lowerCamelCase returns the identifier of name with its first letter in lower case
+ */
+[[nodiscard]] QString lowerCamelCase(const QString &name);
+
+#endif // UPNPDATATYPE_H